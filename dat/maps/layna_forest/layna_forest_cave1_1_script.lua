@@ -512,9 +512,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_NW_zone = vt_map.CameraZone(114, 118, 95, 97);
     Map:AddZone(to_forest_NW_zone);
+    EventManager:SetMapTransitionZone("to forest NW", to_forest_NW_zone);
 
     to_cave_1_2_zone = vt_map.CameraZone(126, 128, 3, 13);
     Map:AddZone(to_cave_1_2_zone);
+    EventManager:SetMapTransitionZone("to cave 1-2", to_cave_1_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -489,12 +489,15 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_cave_1_1_zone = vt_map.CameraZone(0, 1, 11, 16);
     Map:AddZone(to_cave_1_1_zone);
+    EventManager:SetMapTransitionZone("to cave 1-1", to_cave_1_1_zone);
 
     to_cave_exit_zone = vt_map.CameraZone(108, 116, 95, 96);
     Map:AddZone(to_cave_exit_zone);
+    EventManager:SetMapTransitionZone("to south east exit", to_cave_exit_zone);
 
     to_wolf_cave_zone = vt_map.CameraZone(122, 124, 12, 14);
     Map:AddZone(to_wolf_cave_zone);
+    EventManager:SetMapTransitionZone("to wolf cave", to_wolf_cave_zone);
 
     seeing_the_exit_zone = vt_map.CameraZone(99, 122, 80, 96);
     Map:AddZone(seeing_the_exit_zone);
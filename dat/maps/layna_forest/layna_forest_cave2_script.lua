@@ -284,9 +284,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_SE_zone = vt_map.CameraZone(56, 60, 95, 96);
     Map:AddZone(to_forest_SE_zone);
+    EventManager:SetMapTransitionZone("to forest SE", to_forest_SE_zone);
 
     to_forest_crystal_zone = vt_map.CameraZone(60, 74, 0, 1);
     Map:AddZone(to_forest_crystal_zone);
+    EventManager:SetMapTransitionZone("to forest crystal", to_forest_crystal_zone);
 
     -- cave zones
     to_1_1_zone = vt_map.CameraZone(8, 10, 39, 40);
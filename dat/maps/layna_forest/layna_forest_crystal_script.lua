@@ -835,6 +835,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_cave2_zone = vt_map.CameraZone(28, 33, 23, 25);
     Map:AddZone(to_forest_cave2_zone);
+    EventManager:SetMapTransitionZone("to forest cave 2", to_forest_cave2_zone);
 
     wolf_battle_zone = vt_map.CameraZone(38, 46, 63, 66);
     Map:AddZone(wolf_battle_zone);
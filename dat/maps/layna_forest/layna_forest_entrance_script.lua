@@ -529,9 +529,13 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     forest_entrance_exit_zone = vt_map.CameraZone(0, 1, 26, 34);
     Map:AddZone(forest_entrance_exit_zone);
+    EventManager:SetMapTransitionZone("exit forest at night", forest_entrance_exit_zone);
+    -- Prefetch the village when getting close to it.
+    EventManager:SetMapTransitionZone("exit forest", forest_entrance_exit_zone);
 
     to_forest_nw_zone = vt_map.CameraZone(62, 64, 29, 35);
     Map:AddZone(to_forest_nw_zone);
+    EventManager:SetMapTransitionZone("to forest NW", to_forest_nw_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
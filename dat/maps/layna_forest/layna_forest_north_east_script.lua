@@ -717,9 +717,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_NW_zone = vt_map.CameraZone(0, 1, 86, 90);
     Map:AddZone(to_forest_NW_zone);
+    EventManager:SetMapTransitionZone("to forest NW", to_forest_NW_zone);
 
     to_forest_SE_zone = vt_map.CameraZone(69, 75, 95, 96);
     Map:AddZone(to_forest_SE_zone);
+    EventManager:SetMapTransitionZone("to forest SE", to_forest_SE_zone);
 
     -- Fade out music zone - used to set a dramatic area
     music_fade_out_zone = vt_map.CameraZone(48, 50, 8, 17);
@@ -1181,18 +1181,22 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_entrance_zone = vt_map.CameraZone(0, 1, 80, 90);
     Map:AddZone(to_forest_entrance_zone);
+    EventManager:SetMapTransitionZone("to forest entrance", to_forest_entrance_zone);
 
     dialogue_near_forest_entrance_zone = vt_map.CameraZone(5, 7, 80, 90);
     Map:AddZone(dialogue_near_forest_entrance_zone);
 
     to_forest_NE_zone = vt_map.CameraZone(126, 128, 40, 45);
     Map:AddZone(to_forest_NE_zone);
+    EventManager:SetMapTransitionZone("to forest NE", to_forest_NE_zone);
 
     to_forest_SW_zone = vt_map.CameraZone(111, 119, 95, 97);
     Map:AddZone(to_forest_SW_zone);
+    EventManager:SetMapTransitionZone("to forest SW", to_forest_SW_zone);
 
     to_cave_entrance_zone = vt_map.CameraZone(74, 78, 36, 38);
     Map:AddZone(to_cave_entrance_zone);
+    EventManager:SetMapTransitionZone("to cave entrance", to_cave_entrance_zone);
 
     orlinn_scene_zone = vt_map.CameraZone(81, 83, 18, 28);
     Map:AddZone(orlinn_scene_zone);
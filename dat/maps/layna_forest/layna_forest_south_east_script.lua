@@ -783,18 +783,23 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_NE_zone = vt_map.CameraZone(36, 41, 0, 2);
     Map:AddZone(to_forest_NE_zone);
+    EventManager:SetMapTransitionZone("to forest NE", to_forest_NE_zone);
 
     to_forest_SW_zone = vt_map.CameraZone(0, 2, 52, 56);
     Map:AddZone(to_forest_SW_zone);
+    EventManager:SetMapTransitionZone("to forest SW", to_forest_SW_zone);
 
     to_cave1_2_zone = vt_map.CameraZone(12, 16, 39, 40);
     Map:AddZone(to_cave1_2_zone);
+    EventManager:SetMapTransitionZone("to cave 1_2", to_cave1_2_zone);
 
     to_cave2_1_zone = vt_map.CameraZone(64, 68, 69, 70);
     Map:AddZone(to_cave2_1_zone);
+    EventManager:SetMapTransitionZone("to cave 2", to_cave2_1_zone);
 
     to_wolf_cave_zone = vt_map.CameraZone(30, 34, 17, 18);
     Map:AddZone(to_wolf_cave_zone);
+    EventManager:SetMapTransitionZone("to wolf cave", to_wolf_cave_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -721,9 +721,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_SE_zone = vt_map.CameraZone(126, 128, 82, 87);
     Map:AddZone(to_forest_SE_zone);
+    EventManager:SetMapTransitionZone("to forest SE", to_forest_SE_zone);
 
     to_forest_NW_zone = vt_map.CameraZone(52, 59, 0, 2);
     Map:AddZone(to_forest_NW_zone);
+    EventManager:SetMapTransitionZone("to forest NW", to_forest_NW_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -414,9 +414,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_cave_1_2_zone = vt_map.CameraZone(0, 1, 24, 28);
     Map:AddZone(to_cave_1_2_zone);
+    EventManager:SetMapTransitionZone("to cave 1-2", to_cave_1_2_zone);
 
     to_cave_exit_zone = vt_map.CameraZone(24, 29, 47, 48);
     Map:AddZone(to_cave_exit_zone);
+    EventManager:SetMapTransitionZone("to south east exit", to_cave_exit_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -245,6 +245,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     room_exit_zone = vt_map.CameraZone(38, 39, 16, 19);
     Map:AddZone(room_exit_zone);
+    EventManager:SetMapTransitionZone("exit floor", room_exit_zone);
 
     save_point_zone = vt_map.CameraZone(32, 36, 31, 35);
     Map:AddZone(save_point_zone);
@@ -408,6 +408,7 @@ function _CreateZones()
 
     to_bronanns_room_zone = vt_map.CameraZone(44, 47, 8, 9);
     Map:AddZone(to_bronanns_room_zone);
+    EventManager:SetMapTransitionZone("to Bronann's 1st floor", to_bronanns_room_zone);
 
     quest2_start_scene = false;
 end
@@ -451,6 +451,7 @@ function _CreateZones()
 
     to_riverbank_zone = vt_map.CameraZone(19, 35, 78, 79);
     Map:AddZone(to_riverbank_zone);
+    EventManager:SetMapTransitionZone("to Riverbank", to_riverbank_zone);
 
     to_village_entrance_zone = vt_map.CameraZone(60, 113, 78, 79);
     Map:AddZone(to_village_entrance_zone);
@@ -865,27 +865,36 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     bronanns_home_entrance_zone = vt_map.CameraZone(10, 14, 60, 61);
     Map:AddZone(bronanns_home_entrance_zone);
+    EventManager:SetMapTransitionZone("to Bronann's home", bronanns_home_entrance_zone);
 
     to_riverbank_zone = vt_map.CameraZone(19, 35, 78, 79);
     Map:AddZone(to_riverbank_zone);
+    EventManager:SetMapTransitionZone("to Riverbank", to_riverbank_zone);
 
     to_village_entrance_zone = vt_map.CameraZone(60, 113, 78, 79);
     Map:AddZone(to_village_entrance_zone);
+    EventManager:SetMapTransitionZone("to Village south entrance", to_village_entrance_zone);
 
     to_kalya_house_path_zone = vt_map.CameraZone(0, 1, 8, 15);
     Map:AddZone(to_kalya_house_path_zone);
+    EventManager:SetMapTransitionZone("to Kalya house path", to_kalya_house_path_zone);
 
     shop_entrance_zone = vt_map.CameraZone(92, 96, 70, 71);
     Map:AddZone(shop_entrance_zone);
+    EventManager:SetMapTransitionZone("to Flora's Shop", shop_entrance_zone);
 
     secret_path_zone = vt_map.CameraZone(0, 1, 55, 61);
     Map:AddZone(secret_path_zone);
+    EventManager:SetMapTransitionZone("to secret cliff", secret_path_zone);
 
     to_layna_forest_zone = vt_map.CameraZone(117, 119, 30, 43);
     Map:AddZone(to_layna_forest_zone);
+    -- Prefetch the forest when getting close to it.
+    EventManager:SetMapTransitionZone("to layna forest entrance", to_layna_forest_zone);
 
     sophia_house_entrance_zone = vt_map.CameraZone(21, 23, 21, 22);
     Map:AddZone(sophia_house_entrance_zone);
+    EventManager:SetMapTransitionZone("to sophia house", sophia_house_entrance_zone);
 end
 
 function _CheckZones()
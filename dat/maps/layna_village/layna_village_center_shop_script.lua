@@ -138,6 +138,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     shop_exit_zone = vt_map.CameraZone(30, 34, 28, 29);
     Map:AddZone(shop_exit_zone);
+    EventManager:SetMapTransitionZone("to village", shop_exit_zone);
 end
 
 function _CheckZones()
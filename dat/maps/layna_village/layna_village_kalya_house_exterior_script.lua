@@ -224,9 +224,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     kalya_house_path_zone = vt_map.CameraZone(28, 58, 46, 47);
     Map:AddZone(kalya_house_path_zone);
+    EventManager:SetMapTransitionZone("to Kalya house path", kalya_house_path_zone);
 
     kalya_house_path_small_passage_zone = vt_map.CameraZone(0, 1, 0, 33);
     Map:AddZone(kalya_house_path_small_passage_zone);
+    EventManager:SetMapTransitionZone("to kalya house path small passage", kalya_house_path_small_passage_zone);
 
     kalya_house_entrance_zone = vt_map.CameraZone(42, 46, 16, 17);
     Map:AddZone(kalya_house_entrance_zone);
@@ -403,15 +403,19 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     village_center_zone = vt_map.CameraZone(62, 63, 42, 47);
     Map:AddZone(village_center_zone);
+    EventManager:SetMapTransitionZone("to Village center", village_center_zone);
 
     kalya_house_exterior_zone = vt_map.CameraZone(26, 56, 0, 2);
     Map:AddZone(kalya_house_exterior_zone);
+    EventManager:SetMapTransitionZone("to Kalya house exterior", kalya_house_exterior_zone);
 
     grandma_house_entrance_zone = vt_map.CameraZone(11, 13, 7, 8);
     Map:AddZone(grandma_house_entrance_zone);
+    EventManager:SetMapTransitionZone("to grandma house", grandma_house_entrance_zone);
 
     kalya_house_small_passage_zone = vt_map.CameraZone(3, 8, 0, 1);
     Map:AddZone(kalya_house_small_passage_zone);
+    EventManager:SetMapTransitionZone("to Kalya house small passage", kalya_house_small_passage_zone);
 end
 
 function _CheckZones()
@@ -469,6 +469,7 @@ function _CreateZones()
 
     to_mt_elbrus_zone = vt_map.CameraZone(30, 36, 12, 14);
     Map:AddZone(to_mt_elbrus_zone);
+    EventManager:SetMapTransitionZone("to Mt Elbrus", to_mt_elbrus_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -835,6 +835,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     village_center_zone = vt_map.CameraZone(89, 105, 0, 2);
     Map:AddZone(village_center_zone);
+    EventManager:SetMapTransitionZone("to Village center", village_center_zone);
 
     to_village_entrance_zone = vt_map.CameraZone(118, 119, 10, 27);
     Map:AddZone(to_village_entrance_zone);
@@ -517,15 +517,19 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     village_center_zone = vt_map.CameraZone(89, 105, 0, 2);
     Map:AddZone(village_center_zone);
+    EventManager:SetMapTransitionZone("to Village center", village_center_zone);
 
     to_village_entrance_zone = vt_map.CameraZone(118, 119, 10, 27);
     Map:AddZone(to_village_entrance_zone);
+    EventManager:SetMapTransitionZone("to Village south entrance", to_village_entrance_zone);
 
     to_riverbank_house_entrance_zone = vt_map.CameraZone(96, 100, 46, 47);
     Map:AddZone(to_riverbank_house_entrance_zone);
+    EventManager:SetMapTransitionZone("to Riverbank house", to_riverbank_house_entrance_zone);
 
     to_secret_path_entrance_zone = vt_map.CameraZone(60, 72, 0, 2);
     Map:AddZone(to_secret_path_entrance_zone);
+    EventManager:SetMapTransitionZone("to secret path entrance", to_secret_path_entrance_zone);
 
     orlinn_hide_n_seek2_zone = vt_map.CameraZone(75, 80, 0, 7);
     Map:AddZone(orlinn_hide_n_seek2_zone);
@@ -115,6 +115,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     room_exit_zone = vt_map.CameraZone(26, 30, 33, 34);
     Map:AddZone(room_exit_zone);
+    EventManager:SetMapTransitionZone("exit floor", room_exit_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
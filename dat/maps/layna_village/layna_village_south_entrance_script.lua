@@ -220,15 +220,19 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     village_center_zone = vt_map.CameraZone(8, 62, 0, 2);
     Map:AddZone(village_center_zone);
+    EventManager:SetMapTransitionZone("to Village center", village_center_zone);
 
     to_village_riverbank_zone = vt_map.CameraZone(0, 1, 26, 43);
     Map:AddZone(to_village_riverbank_zone);
+    EventManager:SetMapTransitionZone("to Village riverbank", to_village_riverbank_zone);
 
     to_left_house_zone = vt_map.CameraZone(18, 22, 32, 33);
     Map:AddZone(to_left_house_zone);
+    EventManager:SetMapTransitionZone("to left house", to_left_house_zone);
 
     to_right_house_zone = vt_map.CameraZone(46, 50, 32, 33);
     Map:AddZone(to_right_house_zone);
+    EventManager:SetMapTransitionZone("to right house", to_right_house_zone);
 end
 
 function _CheckZones()
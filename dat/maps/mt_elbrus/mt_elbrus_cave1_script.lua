@@ -307,15 +307,19 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     exit1_zone = vt_map.CameraZone(84, 94, 78, 80);
     Map:AddZone(exit1_zone);
+    EventManager:SetMapTransitionZone("to exit 1", exit1_zone);
 
     exit2_zone = vt_map.CameraZone(4, 15, 78, 80);
     Map:AddZone(exit2_zone);
+    EventManager:SetMapTransitionZone("to exit 2", exit2_zone);
 
     exit3_zone = vt_map.CameraZone(94, 96, 21, 22);
     Map:AddZone(exit3_zone);
+    EventManager:SetMapTransitionZone("to exit 3", exit3_zone);
 
     exit4_zone = vt_map.CameraZone(90, 92, 7, 8);
     Map:AddZone(exit4_zone);
+    EventManager:SetMapTransitionZone("to exit 4", exit4_zone);
 
     left_jump_zone = vt_map.CameraZone(4, 8, 63, 64);
     Map:AddZone(left_jump_zone);
@@ -225,8 +225,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     exit2_1_zone = vt_map.CameraZone(42, 50, 46, 48);
     Map:AddZone(exit2_1_zone);
+    EventManager:SetMapTransitionZone("to exit 2-1", exit2_1_zone);
     exit2_2_zone = vt_map.CameraZone(42, 48, 15, 17);
     Map:AddZone(exit2_2_zone);
+    EventManager:SetMapTransitionZone("to exit 2-2", exit2_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -311,8 +311,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     exit3_1_zone = vt_map.CameraZone(46, 58, 17, 19);
     Map:AddZone(exit3_1_zone);
+    EventManager:SetMapTransitionZone("to exit 3-1", exit3_1_zone);
     exit3_2_zone = vt_map.CameraZone(0, 8, 21, 23);
     Map:AddZone(exit3_2_zone);
+    EventManager:SetMapTransitionZone("to exit 3-2", exit3_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
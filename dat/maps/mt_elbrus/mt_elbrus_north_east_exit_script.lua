@@ -342,8 +342,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_basement_zone = vt_map.CameraZone(29, 31, 12, 14);
     Map:AddZone(to_basement_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine basement", to_basement_zone);
     to_overworld_zone = vt_map.CameraZone(0, 2, 34, 44);
     Map:AddZone(to_overworld_zone);
+    EventManager:SetMapTransitionZone("to overworld", to_overworld_zone);
 
 end
 
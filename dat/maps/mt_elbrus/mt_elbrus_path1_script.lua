@@ -701,15 +701,20 @@ function _CreateZones()
 
     to_cave1_zone = vt_map.CameraZone(62, 66, 43, 45);
     Map:AddZone(to_cave1_zone);
+    EventManager:SetMapTransitionZone("to cave 1", to_cave1_zone);
     to_cave2_zone = vt_map.CameraZone(30, 34, 49, 50);
     Map:AddZone(to_cave2_zone);
+    EventManager:SetMapTransitionZone("to cave 2", to_cave2_zone);
     to_cave3_zone = vt_map.CameraZone(116, 120, 29, 30);
     Map:AddZone(to_cave3_zone);
+    EventManager:SetMapTransitionZone("to cave 3", to_cave3_zone);
     to_cave4_zone = vt_map.CameraZone(100, 104, 19, 20);
     Map:AddZone(to_cave4_zone);
+    EventManager:SetMapTransitionZone("to cave 4", to_cave4_zone);
 
     to_path2_zone = vt_map.CameraZone(0, 2, 16, 26);
     Map:AddZone(to_path2_zone);
+    EventManager:SetMapTransitionZone("to mountain path 2", to_path2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -430,19 +430,26 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_cave2_1_zone = vt_map.CameraZone(26, 30, 53, 55);
     Map:AddZone(to_cave2_1_zone);
+    EventManager:SetMapTransitionZone("to cave 2-1", to_cave2_1_zone);
     to_cave2_2_zone = vt_map.CameraZone(18, 22, 37, 39);
     Map:AddZone(to_cave2_2_zone);
+    EventManager:SetMapTransitionZone("to cave 2-2", to_cave2_2_zone);
     to_cave3_1_zone = vt_map.CameraZone(46, 50, 13, 15);
     Map:AddZone(to_cave3_1_zone);
+    EventManager:SetMapTransitionZone("to cave 3-1", to_cave3_1_zone);
     to_cave3_2_zone = vt_map.CameraZone(22, 26, 7, 9);
     Map:AddZone(to_cave3_2_zone);
+    EventManager:SetMapTransitionZone("to cave 3-2", to_cave3_2_zone);
 
     to_path1_zone = vt_map.CameraZone(78, 80, 13, 30);
     Map:AddZone(to_path1_zone);
+    EventManager:SetMapTransitionZone("to mountain path 1", to_path1_zone);
     to_path3_zone = vt_map.CameraZone(29, 48, 0, 2);
     Map:AddZone(to_path3_zone);
+    EventManager:SetMapTransitionZone("to mountain path 3", to_path3_zone);
     to_path3_bis_zone = vt_map.CameraZone(0, 9, 0, 2);
     Map:AddZone(to_path3_bis_zone);
+    EventManager:SetMapTransitionZone("to mountain path 3bis", to_path3_bis_zone);
 
 end
 
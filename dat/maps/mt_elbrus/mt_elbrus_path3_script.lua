@@ -852,10 +852,13 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_path4_zone = vt_map.CameraZone(40, 55, 0, 2);
     Map:AddZone(to_path4_zone);
+    EventManager:SetMapTransitionZone("to mountain path 4", to_path4_zone);
     to_path2_zone = vt_map.CameraZone(53, 74, 94, 96);
     Map:AddZone(to_path2_zone);
+    EventManager:SetMapTransitionZone("to mountain path 2", to_path2_zone);
     to_path2_bis_zone = vt_map.CameraZone(1, 23, 94, 96);
     Map:AddZone(to_path2_bis_zone);
+    EventManager:SetMapTransitionZone("to mountain path 2bis", to_path2_bis_zone);
 
     -- event zones
     cemetery_entrance_dialogue_zone = vt_map.CameraZone(61, 74, 71, 73);
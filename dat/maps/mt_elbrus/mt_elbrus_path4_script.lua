@@ -579,6 +579,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_zone = vt_map.CameraZone(39, 41, 3, 5);
     Map:AddZone(to_shrine_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine entrance", to_shrine_zone);
     to_path3_zone = vt_map.CameraZone(48, 64, 78, 80);
     Map:AddZone(to_path3_zone);
 
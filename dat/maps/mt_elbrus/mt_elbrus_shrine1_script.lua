@@ -727,9 +727,12 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_zone = vt_map.CameraZone(40, 44, 2, 4);
     Map:AddZone(to_shrine_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine", to_shrine_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine-waterfalls", to_shrine_zone);
 
     to_mountain_bridge_zone = vt_map.CameraZone(26, 32, 46, 48);
     Map:AddZone(to_mountain_bridge_zone);
+    EventManager:SetMapTransitionZone("to mountain bridge", to_mountain_bridge_zone);
 
     shrine_door_opening_zone = vt_map.CameraZone(40, 44, 8, 10);
     Map:AddZone(shrine_door_opening_zone);
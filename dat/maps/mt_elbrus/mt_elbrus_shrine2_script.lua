@@ -546,18 +546,23 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_entrance_zone = vt_map.CameraZone(26, 40, 78, 80);
     Map:AddZone(to_shrine_entrance_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine entrance", to_shrine_entrance_zone);
 
     to_shrine_trap_room_zone = vt_map.CameraZone(62, 64, 56, 62);
     Map:AddZone(to_shrine_trap_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine trap room", to_shrine_trap_room_zone);
 
     to_shrine_enigma_room_zone = vt_map.CameraZone(0, 2, 56, 62);
     Map:AddZone(to_shrine_enigma_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine enigma room", to_shrine_enigma_room_zone);
 
     to_shrine_first_floor_zone = vt_map.CameraZone(12, 16, 0, 2);
     Map:AddZone(to_shrine_first_floor_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine first floor", to_shrine_first_floor_zone);
 
     to_shrine_stairs_room_zone = vt_map.CameraZone(46, 54, 0, 2);
     Map:AddZone(to_shrine_stairs_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine stairs", to_shrine_stairs_room_zone);
 
     shrine_skeleton_trap_zone = vt_map.CameraZone(4, 24, 10, 12);
     Map:AddZone(shrine_skeleton_trap_zone);
@@ -487,9 +487,12 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_main_room_zone = vt_map.CameraZone(0, 2, 34, 38);
     Map:AddZone(to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room", to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room-waterfalls", to_shrine_main_room_zone);
 
     to_shrine_treasure_room_zone = vt_map.CameraZone(18, 20, 9, 10);
     Map:AddZone(to_shrine_treasure_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine treasure room", to_shrine_treasure_room_zone);
 
     trap_zone = vt_map.CameraZone(10, 34, 10, 44);
     Map:AddZone(trap_zone);
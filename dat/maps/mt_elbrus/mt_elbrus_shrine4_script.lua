@@ -425,6 +425,8 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_main_room_zone = vt_map.CameraZone(62, 64, 32, 36);
     Map:AddZone(to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room", to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room-waterfalls", to_shrine_main_room_zone);
 
     mini_boss_zone = vt_map.CameraZone(40, 42, 6, 11);
     Map:AddZone(mini_boss_zone);
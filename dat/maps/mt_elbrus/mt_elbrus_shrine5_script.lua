@@ -670,18 +670,24 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_main_room_zone = vt_map.CameraZone(6, 10, 9, 11);
     Map:AddZone(to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room", to_shrine_main_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine main room-waterfalls", to_shrine_main_room_zone);
 
     to_shrine_2nd_floor_room_zone = vt_map.CameraZone(18, 22, 9, 10);
     Map:AddZone(to_shrine_2nd_floor_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor", to_shrine_2nd_floor_room_zone);
 
     to_shrine_SW_left_door_room_zone = vt_map.CameraZone(14, 18, 38, 40);
     Map:AddZone(to_shrine_SW_left_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SW room - left door", to_shrine_SW_left_door_room_zone);
 
     to_shrine_SW_right_door_room_zone = vt_map.CameraZone(26, 30, 38, 40);
     Map:AddZone(to_shrine_SW_right_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SW room - right door", to_shrine_SW_right_door_room_zone);
 
     to_shrine_NE_room_zone = vt_map.CameraZone(46, 48, 8, 12);
     Map:AddZone(to_shrine_NE_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor NE room", to_shrine_NE_room_zone);
 
     monster_trap_zone = vt_map.CameraZone(11, 21, 29, 38);
     Map:AddZone(monster_trap_zone);
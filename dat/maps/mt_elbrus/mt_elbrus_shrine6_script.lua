@@ -309,12 +309,16 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_NW_left_door_room_zone = vt_map.CameraZone(14, 18, 7, 9);
     Map:AddZone(to_shrine_NW_left_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor NW room - left door", to_shrine_NW_left_door_room_zone);
     to_shrine_NW_right_door_room_zone = vt_map.CameraZone(26, 30, 7, 9);
     Map:AddZone(to_shrine_NW_right_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor NW room - right door", to_shrine_NW_right_door_room_zone);
     to_shrine_SE_top_door_room_zone = vt_map.CameraZone(45, 47, 22, 26);
     Map:AddZone(to_shrine_SE_top_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SE room - top door", to_shrine_SE_top_door_room_zone);
     to_shrine_SE_bottom_door_room_zone = vt_map.CameraZone(45, 47, 32, 36);
     Map:AddZone(to_shrine_SE_bottom_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SE room - bottom door", to_shrine_SE_bottom_door_room_zone);
 
 end
 
@@ -331,10 +331,13 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_SW_top_door_room_zone = vt_map.CameraZone(1, 3, 22, 26);
     Map:AddZone(to_shrine_SW_top_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SW room - top door", to_shrine_SW_top_door_room_zone);
     to_shrine_SW_bottom_door_room_zone = vt_map.CameraZone(1, 3, 32, 36);
     Map:AddZone(to_shrine_SW_bottom_door_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SW room - bottom door", to_shrine_SW_bottom_door_room_zone);
     to_shrine_NE_room_zone = vt_map.CameraZone(24, 32, 0, 2);
     Map:AddZone(to_shrine_NE_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor NE room", to_shrine_NE_room_zone);
 
 end
 
@@ -262,8 +262,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_NW_room_zone = vt_map.CameraZone(0, 2, 8, 12);
     Map:AddZone(to_shrine_NW_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor NW room", to_shrine_NW_room_zone);
     to_shrine_SE_room_zone = vt_map.CameraZone(24, 32, 38, 40);
     Map:AddZone(to_shrine_SE_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor SE room", to_shrine_SE_room_zone);
 
 end
 
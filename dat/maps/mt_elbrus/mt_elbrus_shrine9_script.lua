@@ -261,9 +261,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_entrance_zone = vt_map.CameraZone(20, 24, 46, 48);
     Map:AddZone(to_shrine_entrance_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine entrance", to_shrine_entrance_zone);
 
     to_shrine_trap_zone = vt_map.CameraZone(50, 52, 46, 48);
     Map:AddZone(to_shrine_trap_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine trap room", to_shrine_trap_zone);
 
     falling_event_zone = vt_map.CameraZone(19, 25, 26, 28);
     Map:AddZone(falling_event_zone);
@@ -344,9 +344,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_1st_floor_room_zone = vt_map.CameraZone(22, 26, 9, 11);
     Map:AddZone(to_shrine_1st_floor_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor", to_shrine_1st_floor_room_zone);
 
     to_shrine_SE_room_zone = vt_map.CameraZone(24, 32, 38, 42);
     Map:AddZone(to_shrine_SE_room_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor South", to_shrine_SE_room_zone);
 
     spike_trap_zone = vt_map.CameraZone(24, 26, 22, 24);
     Map:AddZone(spike_trap_zone);
@@ -286,10 +286,13 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_ne_zone = vt_map.CameraZone(84, 88, 3, 5);
     Map:AddZone(to_shrine_ne_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor NE", to_shrine_ne_zone);
     to_shrine_nw_zone = vt_map.CameraZone(6, 10, 3, 5);
     Map:AddZone(to_shrine_nw_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor north west", to_shrine_nw_zone);
     to_grotto_zone = vt_map.CameraZone(33, 35, 22, 24);
     Map:AddZone(to_grotto_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor north east", to_grotto_zone);
 
     windy1_zone = vt_map.CameraZone(32, 36, 65, 71);
     Map:AddZone(windy1_zone);
@@ -298,6 +301,7 @@ function _CreateZones()
     falling_zone = vt_map.CameraZone(32, 36, 71, 74);
     falling_zone:AddSection(43, 47, 48, 52);
     Map:AddZone(falling_zone);
+    EventManager:SetMapTransitionZone("To mountain shrine entrance", falling_zone);
 
     windy3_zone = vt_map.CameraZone(85, 89, 10, 29);
     Map:AddZone(windy3_zone);
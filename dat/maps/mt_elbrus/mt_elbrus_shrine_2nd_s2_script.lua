@@ -474,10 +474,13 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_se_zone = vt_map.CameraZone(48, 52, 49, 51);
     Map:AddZone(to_shrine_se_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor South right", to_shrine_se_zone);
     to_shrine_sw_zone = vt_map.CameraZone(14, 18, 70, 72);
     Map:AddZone(to_shrine_sw_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor South left", to_shrine_sw_zone);
     to_stairs_zone = vt_map.CameraZone(11, 13, 5, 7);
     Map:AddZone(to_stairs_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine stairs", to_stairs_zone);
 
     trap_zone = vt_map.CameraZone(6, 32, 25, 39);
     trap_zone:AddSection(27, 32, 20, 25);
@@ -547,6 +547,7 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_stairs_zone = vt_map.CameraZone(30, 34, 46, 48);
     Map:AddZone(to_shrine_stairs_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine stairs", to_shrine_stairs_zone);
     start_boss_zone = vt_map.CameraZone(30, 34, 38, 40);
     Map:AddZone(start_boss_zone);
     boss_zone = vt_map.CameraZone(28, 36, 20, 28);
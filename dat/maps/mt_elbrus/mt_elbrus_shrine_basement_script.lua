@@ -386,6 +386,7 @@ function _CreateZones()
 
     to_mountain_exit_zone = vt_map.CameraZone(0, 2, 15, 34);
     Map:AddZone(to_mountain_exit_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine exit", to_mountain_exit_zone);
 end
 
 -- Booleans preventing from starting the even more than once.
@@ -568,15 +568,19 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_1st_floor_zone = vt_map.CameraZone(9, 12, 36, 39);
     Map:AddZone(to_shrine_1st_floor_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 1st floor", to_shrine_1st_floor_zone);
 
     to_shrine_2nd_floor_zone = vt_map.CameraZone(59, 61, 36, 39);
     Map:AddZone(to_shrine_2nd_floor_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor", to_shrine_2nd_floor_zone);
 
     to_shrine_2nd_floor_grotto_zone = vt_map.CameraZone(9, 12, 14, 17);
     Map:AddZone(to_shrine_2nd_floor_grotto_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 2nd floor grotto", to_shrine_2nd_floor_grotto_zone);
 
     to_shrine_3rd_floor_zone = vt_map.CameraZone(34, 40, 5, 7);
     Map:AddZone(to_shrine_3rd_floor_zone);
+    EventManager:SetMapTransitionZone("to mountain shrine 3rd floor", to_shrine_3rd_floor_zone);
 
     before_3rd_floor_zone = vt_map.CameraZone(28, 46, 7, 10);
     Map:AddZone(before_3rd_floor_zone);
@@ -57,7 +57,8 @@ void BindCommonCode()
             luabind::def("RandomFloat", (float( *)(void)) &vt_utils::RandomFloat),
             luabind::def("RandomBoundedInteger", &vt_utils::RandomBoundedInteger),
             luabind::def("MakeUnicodeString", &vt_utils::MakeUnicodeString),
-            luabind::def("MakeStandardString", &vt_utils::MakeStandardString)
+            luabind::def("MakeStandardString", &vt_utils::MakeStandardString),
+            luabind::def("InternString", &vt_utils::InternString)
         ];
     }
 
@@ -134,8 +135,10 @@ void BindCommonCode()
                     .def("DoesEventExist", &GameGlobal::DoesEventExist)
                     .def("AddNewEventGroup", &GameGlobal::AddNewEventGroup)
                     .def("GetEventGroup", &GameGlobal::GetEventGroup)
-                    .def("GetEventValue", &GameGlobal::GetEventValue)
-                    .def("SetEventValue", &GameGlobal::SetEventValue)
+                    .def("GetEventValue", (int32(GameGlobal:: *)(const std::string &, const std::string &) const) &GameGlobal::GetEventValue)
+                    .def("GetEventValue", (int32(GameGlobal:: *)(vt_utils::StringId, vt_utils::StringId) const) &GameGlobal::GetEventValue)
+                    .def("SetEventValue", (void(GameGlobal:: *)(const std::string &, const std::string &, int32)) &GameGlobal::SetEventValue)
+                    .def("SetEventValue", (void(GameGlobal:: *)(vt_utils::StringId, vt_utils::StringId, int32)) &GameGlobal::SetEventValue)
                     .def("GetNumberEventGroups", &GameGlobal::GetNumberEventGroups)
                     .def("GetNumberEvents", &GameGlobal::GetNumberEvents)
                     .def("SetMapDataFilename", (void(GameGlobal:: *)(const std::string &)) &GameGlobal::SetMapDataFilename)
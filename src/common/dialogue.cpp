@@ -284,7 +284,7 @@ void DialogueWindow::Draw()
     }
 
     VideoManager->MoveRelative(0.0f, 5.0f);
-    _blink_time += SystemManager->GetUpdateTime();
+    _blink_time += SystemManager->GetFrameTime();
     if(_blink_time > 500) {
         _blink_time -= 500;
         _blink_state = _blink_state ? false : true;
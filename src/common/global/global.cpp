@@ -46,7 +46,12 @@ void GlobalEventGroup::AddNewEvent(const std::string &event_name, int32 event_va
                                        << _group_name << std::endl;
         return;
     }
-    _events.insert(std::make_pair(event_name, event_value));
+    std::map<std::string, int32>::iterator event_iter = _events.insert(std::make_pair(event_name, event_value)).first;
+
+    // Keep the handles sorted, for binary searches.
+    std::pair<StringId, int32 *> event_value_entry(InternString(event_name), &event_iter->second);
+    _event_values.insert(std::lower_bound(_event_values.begin(), _event_values.end(), event_value_entry),
+                         event_value_entry);
 }
 
 int32 GlobalEventGroup::GetEvent(const std::string &event_name)
@@ -70,6 +75,36 @@ void GlobalEventGroup::SetEvent(const std::string &event_name, int32 event_value
     event_iter->second = event_value;
 }
 
+int32 GlobalEventGroup::GetEvent(StringId event_id) const
+{
+    int32 *value = _FindEventValue(event_id);
+    return value ? *value : 0;
+}
+
+void GlobalEventGroup::SetEvent(StringId event_id, int32 event_value)
+{
+    int32 *value = _FindEventValue(event_id);
+    if(value == NULL) {
+        const std::string &event_name = GetInternedString(event_id);
+        if(event_name.empty()) {
+            PRINT_WARNING << "Invalid event name handle: " << event_id << ", in group: " << _group_name << std::endl;
+            return;
+        }
+        AddNewEvent(event_name, event_value);
+        return;
+    }
+    *value = event_value;
+}
+
+int32 *GlobalEventGroup::_FindEventValue(StringId event_id) const
+{
+    std::vector<std::pair<StringId, int32 *> >::const_iterator it =
+        std::lower_bound(_event_values.begin(), _event_values.end(), std::make_pair(event_id, static_cast<int32 *>(NULL)));
+    if(it == _event_values.end() || it->first != event_id)
+        return NULL;
+    return it->second;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // GameGlobal class - Initialization and Destruction
 ////////////////////////////////////////////////////////////////////////////////
@@ -251,6 +286,7 @@ void GameGlobal::ClearAllData()
         delete(it->second);
     }
     _event_groups.clear();
+    _event_groups_by_id.clear();
 
     //clear the quest log
     for(std::map<std::string, QuestLogEntry *>::iterator itr = _quest_log_entries.begin(); itr != _quest_log_entries.end(); ++itr)
@@ -735,8 +771,7 @@ void GameGlobal::AddNewEventGroup(const std::string &group_name)
         return;
     }
 
-    GlobalEventGroup *geg = new GlobalEventGroup(group_name);
-    _event_groups.insert(std::make_pair(group_name, geg));
+    _CreateEventGroup(group_name);
 }
 
 
@@ -771,8 +806,7 @@ void GameGlobal::SetEventValue(const std::string &group_name, const std::string
     GlobalEventGroup *geg = 0;
     std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
     if(group_iter == _event_groups.end()) {
-        geg = new GlobalEventGroup(group_name);
-        _event_groups.insert(std::make_pair(group_name, geg));
+        geg = _CreateEventGroup(group_name);
     } else {
         geg = group_iter->second;
     }
@@ -780,6 +814,43 @@ void GameGlobal::SetEventValue(const std::string &group_name, const std::string
     geg->SetEvent(event_name, event_value);
 }
 
+int32 GameGlobal::GetEventValue(StringId group_id, StringId event_id) const
+{
+    if(group_id >= _event_groups_by_id.size() || _event_groups_by_id[group_id] == NULL)
+        return 0;
+
+    return _event_groups_by_id[group_id]->GetEvent(event_id);
+}
+
+void GameGlobal::SetEventValue(StringId group_id, StringId event_id, int32 event_value)
+{
+    GlobalEventGroup *geg = NULL;
+    if(group_id < _event_groups_by_id.size())
+        geg = _event_groups_by_id[group_id];
+    if(geg == NULL) {
+        const std::string &group_name = GetInternedString(group_id);
+        if(group_name.empty()) {
+            PRINT_WARNING << "Invalid event group name handle: " << group_id << std::endl;
+            return;
+        }
+        geg = _CreateEventGroup(group_name);
+    }
+
+    geg->SetEvent(event_id, event_value);
+}
+
+GlobalEventGroup *GameGlobal::_CreateEventGroup(const std::string &group_name)
+{
+    GlobalEventGroup *geg = new GlobalEventGroup(group_name);
+    _event_groups.insert(std::make_pair(group_name, geg));
+
+    StringId group_id = InternString(group_name);
+    if(group_id >= _event_groups_by_id.size())
+        _event_groups_by_id.resize(group_id + 1, NULL);
+    _event_groups_by_id[group_id] = geg;
+    return geg;
+}
+
 uint32 GameGlobal::GetNumberEvents(const std::string &group_name) const
 {
     std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
@@ -114,6 +114,19 @@ public:
     **/
     void SetEvent(const std::string &event_name, int32 event_value);
 
+    /** \brief Retrieves the value of a specific event in the group from its name handle
+    *** \param event_id The handle of the event name, given by vt_utils::InternString()
+    *** \return The value of the event, or 0 if there is no such event
+    **/
+    int32 GetEvent(vt_utils::StringId event_id) const;
+
+    /** \brief Sets the value for an event from its name handle
+    *** \param event_id The handle of the event name, given by vt_utils::InternString()
+    *** \param event_value The value to set for the event.
+    *** \note If the event isn't found, it will be created.
+    **/
+    void SetEvent(vt_utils::StringId event_id, int32 event_value);
+
     //! \brief Returns the number of events currently stored within the group
     uint32 GetNumberEvents() const {
         return _events.size();
@@ -139,6 +152,14 @@ private:
     *** of this specific event.
     **/
     std::map<std::string, int32> _events;
+
+    /** \brief The events values sorted by event name handle, for lookups without string comparisons
+    *** The values point into the _events map nodes, which never move.
+    **/
+    std::vector<std::pair<vt_utils::StringId, int32 *> > _event_values;
+
+    //! \brief Returns the value of an event from its name handle, or NULL if not found.
+    int32 *_FindEventValue(vt_utils::StringId event_id) const;
 }; // class GlobalEventGroup
 
 /** ****************************************************************************
@@ -513,6 +534,21 @@ public:
     **/
     void SetEventValue(const std::string &group_name, const std::string &event_name, int32 event_value);
 
+    /** \brief Returns the value of an event from the group and event names handles
+    *** \param group_id The handle of the event group name, given by vt_utils::InternString()
+    *** \param event_id The handle of the event name, given by vt_utils::InternString()
+    *** \return The value of the requested event, or 0 if the event was not found
+    *** \note This avoids the strings lookups, which is useful for scripts checking events on every update.
+    **/
+    int32 GetEventValue(vt_utils::StringId group_id, vt_utils::StringId event_id) const;
+
+    /** \brief Set the value of an event from the group and event names handles
+    *** \param group_id The handle of the event group name, given by vt_utils::InternString()
+    *** \param event_id The handle of the event name, given by vt_utils::InternString()
+    *** \note Events and event groups will be created when necessary.
+    **/
+    void SetEventValue(vt_utils::StringId group_id, vt_utils::StringId event_id, int32 event_value);
+
     //! \brief Returns the number of event groups stored in the class
     uint32 GetNumberEventGroups() const {
         return _event_groups.size();
@@ -1126,6 +1162,9 @@ private:
     **/
     std::map<std::string, GlobalEventGroup *> _event_groups;
 
+    //! \brief The event groups indexed by the handle of their name, or NULL
+    std::vector<GlobalEventGroup *> _event_groups_by_id;
+
     /** \brief The container which stores the quest log entries in the game. the quest log key
     *** acts as the key for this quest
     *** \note due to a limitation with OptionBoxes, we can only currently only support 255
@@ -1200,6 +1239,9 @@ private:
     **/
     void _SaveEvents(vt_script::WriteScriptDescriptor &file, GlobalEventGroup *event_group);
 
+    //! \brief Creates a new event group and adds it in the event group containers.
+    GlobalEventGroup *_CreateEventGroup(const std::string &group_name);
+
     /** \brief adds a new quest log entry into the quest log entries table. also updates the quest log number
     *** \param quest_id for the quest
     *** \param the quest entry's log number
@@ -1387,6 +1387,24 @@ void GlobalCharacter::_CalculateDefenseRatings()
 // GlobalEnemy class
 ////////////////////////////////////////////////////////////////////////////////
 
+void GlobalEnemy::GetBattleAnimationFiles(uint32 id, std::vector<std::string> &animation_files)
+{
+    ReadScriptDescriptor& enemy_data = GlobalManager->GetEnemiesScript();
+    if(id == 0 || !enemy_data.OpenTable(id))
+        return;
+
+    if(enemy_data.OpenTable("battle_animations")) {
+        std::vector<uint32> animations_id;
+        enemy_data.ReadTableKeys(animations_id);
+        for(uint32 i = 0; i < animations_id.size(); ++i) {
+            if(animations_id[i] < GLOBAL_ENEMY_HURT_TOTAL)
+                animation_files.push_back(enemy_data.ReadString(animations_id[i]));
+        }
+        enemy_data.CloseTable(); // battle_animations
+    }
+    enemy_data.CloseTable(); // enemies[id]
+}
+
 GlobalEnemy::GlobalEnemy(uint32 id) :
     GlobalActor(),
     _no_stat_randomization(false),
@@ -1290,6 +1290,13 @@ public:
     virtual ~GlobalEnemy()
     {}
 
+    /** \brief Gives the battle animation scripts of an enemy, without loading them
+    *** \param id The enemy id
+    *** \param animation_files Filled with the animation script filenames.
+    *** This is used to decode the animation images ahead, before constructing the enemy.
+    **/
+    static void GetBattleAnimationFiles(uint32 id, std::vector<std::string> &animation_files);
+
     /** \brief Enables the enemy to be able to use a specific skill
     *** \param skill_id The integer ID of the skill to add to the enemy
     *** \returns whether the skill was added successfully.
@@ -22,6 +22,7 @@
 #include "engine/script/script_read.h"
 #include "engine/mode_manager.h"
 #include "engine/system.h"
+#include "engine/profiler.h"
 
 #include "modes/mode_help_window.h"
 
@@ -218,10 +219,8 @@ bool InputEngine::RestoreDefaultJoyButtons()
 }
 
 // Handles all of the event processing for the game.
-void InputEngine::EventHandler()
+void InputEngine::ClearPressAndReleaseEvents()
 {
-    SDL_Event event; // Holds the game event
-
     // Reset all of the press and release flags so that they don't get detected twice.
     _registered_key_press   = false;
     _registered_key_release = false;
@@ -254,6 +253,11 @@ void InputEngine::EventHandler()
     _help_release         = false;
 
     // NOTE: We don't reinit the D-Pad/hat values on purpose here.
+}
+
+void InputEngine::EventHandler()
+{
+    SDL_Event event; // Holds the game event
 
     // Loops until there are no remaining events to process
     while(SDL_PollEvent(&event)) {
@@ -352,6 +356,10 @@ void InputEngine::_KeyEventHandler(SDL_KeyboardEvent &key_event)
                 // Display and cycle through the texture sheets
                 TextureManager->DEBUG_NextTexSheet();
                 return;
+            } else if(key_event.keysym.sym == SDLK_p) {
+                // Toggle the display of the subsystems frame times
+                vt_system::ToggleProfiler();
+                return;
             }
 #endif
 
@@ -338,10 +338,18 @@ public:
     *** to quit the game). Any keyboard or joystick events that occur are passed to the KeyEventHandler()
     *** and JoystickEventHandler() functions.
     ***
+    *** The press and release events are kept until ClearPressAndReleaseEvents() is called, so that
+    *** none are lost when the game isn't updated on a frame.
+    ***
     *** \note EventHandler() should only be called in the main game loop. Do \b not call it anywhere else.
     **/
     void EventHandler();
 
+    /** \brief Resets the press and release events once the game was updated with them
+    *** \note This should only be called in the main game loop, after the first update step of a frame.
+    **/
+    void ClearPressAndReleaseEvents();
+
     /** \name   Input state member access functions
     *** \return True if the input event key/button is being held down
     **/
@@ -19,6 +19,7 @@
 #include "mode_manager.h"
 
 #include "system.h"
+#include "profiler.h"
 
 #include "engine/video/video.h"
 #include "engine/audio/audio.h"
@@ -180,6 +181,9 @@ bool ModeEngine::SingletonInitialize()
 // Free the top mode on the stack and pop it off
 void ModeEngine::Pop(bool fade_out, bool fade_in)
 {
+    if(IsTracing())
+        AddTraceEvent("ModeEngine::Pop", TRACE_INSTANT);
+
     _fade_in = fade_in;
 
     _pop_count++;
@@ -207,6 +211,9 @@ void ModeEngine::PopAll()
 // Push a new game mode onto the stack
 void ModeEngine::Push(GameMode *gm, bool fade_out, bool fade_in)
 {
+    if(IsTracing())
+        AddTraceEvent("ModeEngine::Push", TRACE_INSTANT);
+
     _push_stack.push_back(gm);
 
     _state_change = true;
@@ -280,6 +287,8 @@ void ModeEngine::Update()
 
     // If a Push() or Pop() function was called, we need to adjust the state of the game stack.
     if(_fade_out_finished && _state_change) {
+        TraceScope trace("Game mode change");
+
         // Pop however many game modes we need to from the top of the stack
         while(_pop_count != 0) {
             if(_game_stack.empty()) {
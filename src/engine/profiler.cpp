@@ -0,0 +1,451 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    profiler.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the frame profiler
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "engine/profiler.h"
+
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+
+namespace vt_system
+{
+
+namespace private_system
+{
+
+bool profiler_enabled = false;
+bool tracing_enabled = false;
+
+} // namespace private_system
+
+// Makes the ring buffers writes visible to the other threads before the write index is.
+#ifdef _MSC_VER
+#define TRACE_MEMORY_BARRIER() MemoryBarrier()
+#else
+#define TRACE_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+// Increments a counter shared by several threads.
+#ifdef _MSC_VER
+#define TRACE_ATOMIC_INCREMENT(value) InterlockedIncrement(reinterpret_cast<volatile LONG *>(&(value)))
+#else
+#define TRACE_ATOMIC_INCREMENT(value) __sync_fetch_and_add(&(value), 1)
+#endif
+
+//! \brief The time spent in each section during the current frame, in microseconds.
+static uint32 frame_times[PROFILE_TOTAL];
+
+//! \brief A circular array of the last frame times of each section, in microseconds.
+static uint32 frame_samples[PROFILE_TOTAL][PROFILER_SAMPLES];
+
+//! \brief The index of the next sample to write, and the number of samples written.
+static uint32 current_sample = 0;
+static uint32 number_samples = 0;
+
+static const char *section_names[PROFILE_TOTAL] = {
+    "ScriptSupervisor::Update",
+    "ObjectSupervisor::Update",
+    "SortObjects",
+    "EventSupervisor::Update",
+    "TileSupervisor::DrawLayers",
+    "Particles update",
+    "Particles draw",
+    "Text rendering",
+    "SDL_GL_SwapBuffers"
+};
+
+//! \brief A recorded trace event.
+struct TraceEvent {
+    const char *name;
+
+    //! \brief The time since the tracing began, in microseconds.
+    double time;
+
+    TRACE_PHASE phase;
+};
+
+//! \brief The trace buffer states. A released buffer becomes free once its last events are written.
+enum TRACE_BUFFER_STATE {
+    TRACE_BUFFER_USED = 0,
+    TRACE_BUFFER_RELEASED = 1,
+    TRACE_BUFFER_FREE = 2
+};
+
+/** \brief The trace events of a thread
+*** The thread is the only one to write the events and the write index, and the
+*** main thread the only one to read them and write the read index, so that
+*** neither needs to lock the buffer.
+***
+*** Once its thread has released it and the main thread has written its last
+*** events, the buffer can be given to another thread, under the buffers lock.
+**/
+struct TraceBuffer {
+    Uint32 thread_id;
+
+    //! \brief A TRACE_BUFFER_STATE value.
+    volatile uint32 state;
+
+    TraceEvent events[TRACE_BUFFER_SIZE];
+
+    //! \brief The number of events written and read, the event index being that number modulo the buffer size.
+    volatile uint32 write_count;
+    volatile uint32 read_count;
+
+    //! \brief The number of events which couldn't be recorded as the buffer was full.
+    volatile uint32 dropped_count;
+
+    //! \brief The number of dropped events already reported in the trace file. Only used by the main thread.
+    uint32 reported_dropped_count;
+};
+
+/** \brief The threads buffers
+*** The buffers are only added, or given to another thread, under the lock.
+*** The main thread also holds it while writing the events, so that a buffer
+*** can't be given away while its last events are being written.
+**/
+static TraceBuffer *trace_buffers[TRACE_MAX_THREADS];
+static volatile uint32 trace_buffer_count = 0;
+#if (THREAD_TYPE == SDL_THREADS)
+static SDL_mutex *trace_buffers_lock = NULL;
+#endif
+
+//! \brief The trace file, and whether an event was already written in it.
+static FILE *trace_file = NULL;
+static bool trace_file_empty = true;
+
+//! \brief The number of events dropped as no buffer was left for their thread, and how many were reported.
+static volatile uint32 unbuffered_dropped_count = 0;
+static uint32 reported_unbuffered_dropped_count = 0;
+
+//! \brief The number of dropped events reported in the trace file since the tracing began.
+static uint32 trace_dropped_total = 0;
+
+//! \brief The time at which the tracing began.
+#ifdef _WIN32
+static LARGE_INTEGER trace_start_time;
+#else
+static struct timeval trace_start_time;
+#endif
+
+//! \brief Returns the time since the tracing began, in microseconds.
+static double getTraceTime()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if(frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart - trace_start_time.QuadPart) * 1000000.0
+           / static_cast<double>(frequency.QuadPart);
+#else
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return static_cast<double>(time.tv_sec - trace_start_time.tv_sec) * 1000000.0
+           + static_cast<double>(time.tv_usec - trace_start_time.tv_usec);
+#endif
+}
+
+//! \brief Returns the buffer used by the calling thread, or NULL if it has none.
+static TraceBuffer *findTraceBuffer()
+{
+    Uint32 thread_id = SDL_ThreadID();
+    uint32 buffer_count = trace_buffer_count;
+    for(uint32 i = 0; i < buffer_count; ++i) {
+        // The thread id of a buffer given to another thread is set before its state.
+        if(trace_buffers[i]->state != TRACE_BUFFER_USED)
+            continue;
+        TRACE_MEMORY_BARRIER();
+        if(trace_buffers[i]->thread_id == thread_id)
+            return trace_buffers[i];
+    }
+    return NULL;
+}
+
+//! \brief Returns the buffer of the calling thread, taking one if needed, or NULL if there are too many threads.
+static TraceBuffer *getTraceBuffer()
+{
+    TraceBuffer *buffer = findTraceBuffer();
+    if(buffer)
+        return buffer;
+
+    // Only the calling thread can take a buffer for itself, so it can't have got one meanwhile.
+#if (THREAD_TYPE == SDL_THREADS)
+    SDL_mutexP(trace_buffers_lock);
+#endif
+    for(uint32 i = 0; i < trace_buffer_count; ++i) {
+        if(trace_buffers[i]->state == TRACE_BUFFER_FREE) {
+            buffer = trace_buffers[i];
+            break;
+        }
+    }
+
+    if(!buffer && trace_buffer_count < TRACE_MAX_THREADS) {
+        buffer = new TraceBuffer();
+        buffer->state = TRACE_BUFFER_FREE;
+        trace_buffers[trace_buffer_count] = buffer;
+        TRACE_MEMORY_BARRIER();
+        ++trace_buffer_count;
+    }
+
+    if(buffer) {
+        buffer->thread_id = SDL_ThreadID();
+        buffer->write_count = 0;
+        buffer->read_count = 0;
+        buffer->dropped_count = 0;
+        buffer->reported_dropped_count = 0;
+        TRACE_MEMORY_BARRIER();
+        buffer->state = TRACE_BUFFER_USED;
+    }
+#if (THREAD_TYPE == SDL_THREADS)
+    SDL_mutexV(trace_buffers_lock);
+#endif
+    return buffer;
+}
+
+//! \brief Writes an instant event telling how many events were dropped, on a thread timeline or globally when tid is NULL.
+static void writeDroppedEvents(const Uint32 *tid, uint32 dropped)
+{
+    if(tid) {
+        fprintf(trace_file, "%s{\"name\":\"Dropped trace events\",\"ph\":\"i\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"s\":\"t\",\"args\":{\"count\":%u}}",
+                trace_file_empty ? "\n" : ",\n", getTraceTime(), static_cast<unsigned int>(*tid),
+                static_cast<unsigned int>(dropped));
+    }
+    else {
+        fprintf(trace_file, "%s{\"name\":\"Dropped trace events without buffer\",\"ph\":\"i\",\"ts\":%.3f,\"pid\":1,\"tid\":0,\"s\":\"g\",\"args\":{\"count\":%u}}",
+                trace_file_empty ? "\n" : ",\n", getTraceTime(), static_cast<unsigned int>(dropped));
+    }
+    trace_file_empty = false;
+    trace_dropped_total += dropped;
+}
+
+//! \brief Writes the events recorded by the threads since the last call into the trace file.
+static void writeTraceEvents()
+{
+#if (THREAD_TYPE == SDL_THREADS)
+    SDL_mutexP(trace_buffers_lock);
+#endif
+    for(uint32 i = 0; i < trace_buffer_count; ++i) {
+        TraceBuffer *buffer = trace_buffers[i];
+        if(buffer->state == TRACE_BUFFER_FREE)
+            continue;
+
+        // The thread doesn't record any event anymore once it has released its buffer.
+        bool released = (buffer->state == TRACE_BUFFER_RELEASED);
+        TRACE_MEMORY_BARRIER();
+        uint32 write_count = buffer->write_count;
+        TRACE_MEMORY_BARRIER();
+
+        for(uint32 j = buffer->read_count; j != write_count; ++j) {
+            const TraceEvent &event = buffer->events[j % TRACE_BUFFER_SIZE];
+            fprintf(trace_file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u%s}",
+                    trace_file_empty ? "\n" : ",\n", event.name, static_cast<char>(event.phase), event.time,
+                    static_cast<unsigned int>(buffer->thread_id), event.phase == TRACE_INSTANT ? ",\"s\":\"t\"" : "");
+            trace_file_empty = false;
+        }
+
+        TRACE_MEMORY_BARRIER();
+        buffer->read_count = write_count;
+
+        uint32 dropped_count = buffer->dropped_count;
+        if(dropped_count != buffer->reported_dropped_count) {
+            writeDroppedEvents(&buffer->thread_id, dropped_count - buffer->reported_dropped_count);
+            buffer->reported_dropped_count = dropped_count;
+        }
+
+        if(released)
+            buffer->state = TRACE_BUFFER_FREE;
+    }
+#if (THREAD_TYPE == SDL_THREADS)
+    SDL_mutexV(trace_buffers_lock);
+#endif
+
+    uint32 dropped_count = unbuffered_dropped_count;
+    if(dropped_count != reported_unbuffered_dropped_count) {
+        writeDroppedEvents(NULL, dropped_count - reported_unbuffered_dropped_count);
+        reported_unbuffered_dropped_count = dropped_count;
+    }
+}
+
+void ToggleProfiler()
+{
+    private_system::profiler_enabled = !private_system::profiler_enabled;
+    if(!private_system::profiler_enabled)
+        return;
+
+    memset(frame_times, 0, sizeof(frame_times));
+    current_sample = 0;
+    number_samples = 0;
+}
+
+uint32 GetProfilerTime()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if(frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // Split the computation so that the counter multiplication can't overflow.
+    return static_cast<uint32>((counter.QuadPart / frequency.QuadPart) * 1000000
+                               + (counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart);
+#else
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    // The value wraps around, which doesn't matter when computing durations.
+    return static_cast<uint32>(time.tv_sec) * 1000000 + static_cast<uint32>(time.tv_usec);
+#endif
+}
+
+void AddProfilerTime(PROFILER_SECTION section, uint32 time)
+{
+    frame_times[section] += time;
+}
+
+void EndProfilerFrame()
+{
+    if(private_system::tracing_enabled)
+        writeTraceEvents();
+
+    if(!private_system::profiler_enabled)
+        return;
+
+    for(uint32 i = 0; i < PROFILE_TOTAL; ++i) {
+        frame_samples[i][current_sample] = frame_times[i];
+        frame_times[i] = 0;
+    }
+
+    current_sample = (current_sample + 1) % PROFILER_SAMPLES;
+    if(number_samples < PROFILER_SAMPLES)
+        ++number_samples;
+}
+
+void GetProfilerStats(PROFILER_SECTION section, float &min_time, float &avg_time, float &max_time)
+{
+    min_time = avg_time = max_time = 0.0f;
+    if(number_samples == 0)
+        return;
+
+    uint32 min_sample = 0xFFFFFFFF;
+    uint32 max_sample = 0;
+    float sum = 0.0f;
+    for(uint32 i = 0; i < number_samples; ++i) {
+        uint32 sample = frame_samples[section][i];
+        min_sample = std::min(min_sample, sample);
+        max_sample = std::max(max_sample, sample);
+        sum += static_cast<float>(sample);
+    }
+
+    min_time = static_cast<float>(min_sample) / 1000.0f;
+    avg_time = sum / static_cast<float>(number_samples) / 1000.0f;
+    max_time = static_cast<float>(max_sample) / 1000.0f;
+}
+
+const char *GetProfilerSectionName(PROFILER_SECTION section)
+{
+    return section_names[section];
+}
+
+bool StartTracing(const std::string &filename)
+{
+    if(private_system::tracing_enabled)
+        StopTracing();
+
+    trace_file = fopen(filename.c_str(), "w");
+    if(!trace_file) {
+        PRINT_ERROR << "Couldn't open the trace file: " << filename << std::endl;
+        return false;
+    }
+
+#if (THREAD_TYPE == SDL_THREADS)
+    if(!trace_buffers_lock)
+        trace_buffers_lock = SDL_CreateMutex();
+#endif
+
+#ifdef _WIN32
+    QueryPerformanceCounter(&trace_start_time);
+#else
+    gettimeofday(&trace_start_time, NULL);
+#endif
+
+    fprintf(trace_file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    trace_file_empty = true;
+    trace_dropped_total = 0;
+
+    // Name the main thread, which is the one starting the tracing.
+    fprintf(trace_file, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"main\"}}",
+            static_cast<unsigned int>(SDL_ThreadID()));
+    trace_file_empty = false;
+
+    private_system::tracing_enabled = true;
+    return true;
+}
+
+void StopTracing()
+{
+    if(!private_system::tracing_enabled)
+        return;
+
+    // The other threads may still be running, so their buffers are kept.
+    private_system::tracing_enabled = false;
+    writeTraceEvents();
+
+    if(trace_dropped_total > 0)
+        PRINT_WARNING << trace_dropped_total << " trace events were dropped, see the "
+                      << "'Dropped trace events' markers in the trace" << std::endl;
+
+    fprintf(trace_file, "\n]}\n");
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+void AddTraceEvent(const char *name, TRACE_PHASE phase)
+{
+    TraceBuffer *buffer = getTraceBuffer();
+    if(!buffer) {
+        TRACE_ATOMIC_INCREMENT(unbuffered_dropped_count);
+        return;
+    }
+
+    uint32 write_count = buffer->write_count;
+    if(write_count - buffer->read_count >= TRACE_BUFFER_SIZE) {
+        ++buffer->dropped_count;
+        return;
+    }
+
+    TraceEvent &event = buffer->events[write_count % TRACE_BUFFER_SIZE];
+    event.name = name;
+    event.time = getTraceTime();
+    event.phase = phase;
+
+    TRACE_MEMORY_BARRIER();
+    buffer->write_count = write_count + 1;
+}
+
+void ReleaseTraceBuffer()
+{
+    TraceBuffer *buffer = findTraceBuffer();
+    if(!buffer)
+        return;
+
+    // The main thread writes the last events before giving the buffer away.
+    TRACE_MEMORY_BARRIER();
+    buffer->state = TRACE_BUFFER_RELEASED;
+}
+
+} // namespace vt_system
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    profiler.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the frame profiler
+***
+*** The profiler measures the time spent every frame in the main subsystems,
+*** using scoped markers put at the start of the functions to measure. It keeps
+*** the frame times of the last frames, so that the video engine can display
+*** their minimum, average and maximum in the profiler overlay.
+***
+*** The markers only check a flag while the profiler is disabled.
+***
+*** The profiler can also record a timeline of begin and end events, written
+*** as a Trace Event JSON file which can be opened in chrome://tracing or
+*** Perfetto. Each thread records its events into its own ring buffer without
+*** locking, and the main thread moves them into the file once per frame.
+*** ***************************************************************************/
+
+#ifndef __PROFILER_HEADER__
+#define __PROFILER_HEADER__
+
+namespace vt_system
+{
+
+//! \brief The subsystems measured by the profiler.
+enum PROFILER_SECTION {
+    PROFILE_SCRIPT_UPDATE = 0,
+    PROFILE_OBJECT_UPDATE = 1,
+    PROFILE_SORT_OBJECTS = 2,
+    PROFILE_EVENT_UPDATE = 3,
+    PROFILE_TILE_DRAW = 4,
+    PROFILE_PARTICLE_UPDATE = 5,
+    PROFILE_PARTICLE_DRAW = 6,
+    PROFILE_TEXT_RENDER = 7,
+    PROFILE_SWAP_BUFFERS = 8,
+    PROFILE_TOTAL = 9
+};
+
+//! \brief The number of frames whose times are kept to compute the profiler statistics.
+const uint32 PROFILER_SAMPLES = 120;
+
+//! \brief The trace event types, using the Trace Event format phase letters.
+enum TRACE_PHASE {
+    TRACE_BEGIN = 'B',
+    TRACE_END = 'E',
+    TRACE_INSTANT = 'i'
+};
+
+//! \brief The maximum number of threads able to record trace events at the same time.
+const uint32 TRACE_MAX_THREADS = 16;
+
+//! \brief The number of events each thread can record between two writes to the trace file.
+const uint32 TRACE_BUFFER_SIZE = 16384;
+
+namespace private_system
+{
+
+//! \brief Whether the profiler markers measure the time spent in their section.
+extern bool profiler_enabled;
+
+//! \brief Whether the trace events are recorded.
+extern bool tracing_enabled;
+
+} // namespace private_system
+
+//! \brief Tells whether the profiler is measuring the frame times.
+inline bool IsProfilerEnabled()
+{
+    return private_system::profiler_enabled;
+}
+
+//! \brief Enables or disables the profiler. The previous frame times are forgotten when enabled.
+void ToggleProfiler();
+
+//! \brief Returns a time in microseconds, only meant to measure durations.
+uint32 GetProfilerTime();
+
+/** \brief Adds time spent in a section during the current frame
+*** \param section The section the time was spent in.
+*** \param time The time spent, in microseconds.
+**/
+void AddProfilerTime(PROFILER_SECTION section, uint32 time);
+
+/** \brief Stores the times of the current frame in the samples, and starts a new frame
+*** The trace events recorded by all the threads are also written to the trace file.
+*** \note This must be called by the main thread.
+**/
+void EndProfilerFrame();
+
+/** \brief Gives the statistics of a section over the last frames
+*** \param min_time, avg_time, max_time Set to the minimum, average and maximum time
+*** spent in the section per frame, in milliseconds.
+**/
+void GetProfilerStats(PROFILER_SECTION section, float &min_time, float &avg_time, float &max_time);
+
+//! \brief Returns the name of a section, as displayed in the profiler overlay.
+const char *GetProfilerSectionName(PROFILER_SECTION section);
+
+//! \brief Tells whether the trace events are recorded.
+inline bool IsTracing()
+{
+    return private_system::tracing_enabled;
+}
+
+/** \brief Starts recording the trace events
+*** \param filename The Trace Event JSON file to write the events into.
+*** \return False if the file couldn't be opened.
+*** \note This must be called by the main thread, before any other thread is started.
+**/
+bool StartTracing(const std::string &filename);
+
+//! \brief Writes the remaining trace events and closes the trace file.
+void StopTracing();
+
+/** \brief Records a trace event for the calling thread
+*** \param name The event name, which must stay valid until the end of the tracing, e.g. a string literal.
+*** \param phase Whether the event begins or ends a duration, or is an instant event.
+*** \note Events are dropped when the thread ring buffer is full, or when no buffer is left
+*** for the thread. The dropped events are counted in the trace file.
+**/
+void AddTraceEvent(const char *name, TRACE_PHASE phase);
+
+/** \brief Releases the trace buffer of the calling thread, so that another thread can use it
+*** \note This must be called by the threads having recorded trace events, right before they exit.
+*** The events still in the buffer are written to the trace file before it is given away.
+**/
+void ReleaseTraceBuffer();
+
+/** ****************************************************************************
+*** \brief Records a duration in the trace timeline until it goes out of scope
+***
+*** It can be used by any thread. The name must be a string literal.
+*** ***************************************************************************/
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name):
+        _name(IsTracing() ? name : NULL)
+    {
+        if(_name)
+            AddTraceEvent(_name, TRACE_BEGIN);
+    }
+
+    ~TraceScope() {
+        if(_name)
+            AddTraceEvent(_name, TRACE_END);
+    }
+
+private:
+    //! \brief The event name, or NULL if the tracing was disabled when the scope began.
+    const char *_name;
+}; // class TraceScope
+
+/** ****************************************************************************
+*** \brief Measures the time spent in a section until it goes out of scope
+***
+*** The section is also recorded in the trace timeline when tracing.
+***
+*** \note The markers are only meant to be used by the main thread.
+*** ***************************************************************************/
+class ProfilerMarker
+{
+public:
+    explicit ProfilerMarker(PROFILER_SECTION section):
+        _section(section),
+        _enabled(IsProfilerEnabled()),
+        _start_time(_enabled ? GetProfilerTime() : 0),
+        _trace(IsTracing() ? GetProfilerSectionName(section) : NULL)
+    {}
+
+    ~ProfilerMarker() {
+        if(_enabled)
+            AddProfilerTime(_section, GetProfilerTime() - _start_time);
+    }
+
+private:
+    PROFILER_SECTION _section;
+
+    //! \brief Whether the profiler was enabled when the marker was created.
+    bool _enabled;
+
+    uint32 _start_time;
+
+    TraceScope _trace;
+}; // class ProfilerMarker
+
+} // namespace vt_system
+
+#endif // __PROFILER_HEADER__
@@ -17,6 +17,7 @@
 #include "engine/script_supervisor.h"
 
 #include "engine/mode_manager.h"
+#include "engine/profiler.h"
 
 using namespace vt_video;
 using namespace vt_script;
@@ -92,6 +93,8 @@ void ScriptSupervisor::Restart()
 
 void ScriptSupervisor::Update()
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_SCRIPT_UPDATE);
+
     // Updates custom scripts
     for(uint32 i = 0; i < _update_functions.size(); ++i)
         ReadScriptDescriptor::RunScriptObject(_update_functions[i]);
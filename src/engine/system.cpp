@@ -288,6 +288,14 @@ void SystemTimer::_UpdateTimer(uint32 time)
 SystemEngine::SystemEngine():
     _last_update(0),
     _update_time(1), // Set to 1 to avoid hanging the system.
+    _pending_update_time(0),
+    _update_step_count(0),
+    _frame_start(0),
+    _frame_time(0),
+    _frame_count(0),
+    _late_frame_count(0),
+    _dropped_update_time(0),
+    _sleep_overshoot(0.0f),
     _hours_played(0),
     _minutes_played(0),
     _seconds_played(0),
@@ -399,6 +407,8 @@ void SystemEngine::InitializeTimers()
 {
     _last_update = SDL_GetTicks();
     _update_time = 1; // Set to non-zero, otherwise bad things may happen...
+    _pending_update_time = 0;
+    _frame_start = _last_update;
     _hours_played = 0;
     _minutes_played = 0;
     _seconds_played = 0;
@@ -444,12 +454,54 @@ void SystemEngine::RemoveAutoTimer(SystemTimer *timer)
 
 
 
-void SystemEngine::UpdateTimers()
+void SystemEngine::BeginFrame()
 {
+    uint32 current_time = SDL_GetTicks();
+    _frame_time = current_time - _frame_start;
+    _frame_start = current_time;
+    ++_frame_count;
+
+    _pending_update_time += current_time - _last_update;
+    _last_update = current_time;
+
+    if(_pending_update_time > SYSTEM_MAX_FRAME_UPDATE_TIME) {
+        _dropped_update_time += _pending_update_time - SYSTEM_MAX_FRAME_UPDATE_TIME;
+        _pending_update_time = SYSTEM_MAX_FRAME_UPDATE_TIME;
+    }
+}
+
+void SystemEngine::WaitForNextFrame(bool vsync)
+{
+    uint32 work_time = SDL_GetTicks() - _frame_start;
+    if(work_time >= SYSTEM_TARGET_FRAME_TIME) {
+        ++_late_frame_count;
+        return;
+    }
+
+    // The buffers swap already waits for the next display refresh.
+    if(vsync)
+        return;
+
+    // SDL_Delay() tends to sleep longer than requested, so ask for less than the time left.
+    int32 sleep_time = static_cast<int32>(SYSTEM_TARGET_FRAME_TIME - work_time) - static_cast<int32>(_sleep_overshoot + 0.5f);
+    if(sleep_time <= 0)
+        return;
+
+    uint32 sleep_start = SDL_GetTicks();
+    SDL_Delay(static_cast<uint32>(sleep_time));
+    int32 overshoot = static_cast<int32>(SDL_GetTicks() - sleep_start) - sleep_time;
+    _sleep_overshoot = 0.875f * _sleep_overshoot + 0.125f * static_cast<float>(std::max(overshoot, 0));
+}
+
+bool SystemEngine::UpdateTimers()
+{
+    if(_pending_update_time < SYSTEM_UPDATE_STEP)
+        return false;
+
     // Update the update game timer
-    uint32 tmp = _last_update;
-    _last_update = SDL_GetTicks();
-    _update_time = _last_update - tmp;
+    _pending_update_time -= SYSTEM_UPDATE_STEP;
+    _update_time = SYSTEM_UPDATE_STEP;
+    ++_update_step_count;
 
     // Update the game play timer
     _milliseconds_played += _update_time;
@@ -469,6 +521,8 @@ void SystemEngine::UpdateTimers()
     // Update all SystemTimer objects
     for(std::set<SystemTimer *>::iterator i = _auto_system_timers.begin(); i != _auto_system_timers.end(); ++i)
         (*i)->_AutoUpdate();
+
+    return true;
 }
 
 // Avoid a useless dependency on the mode manager for the editor build
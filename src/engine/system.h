@@ -63,6 +63,21 @@ const int32 SYSTEM_TIMER_NO_LOOPS = 0;
 **/
 const int32 SYSTEM_TIMER_INFINITE_LOOP = -1;
 
+/** \brief The fixed amount of milliseconds the game is updated by on each update step
+*** Updating the game by a constant time keeps the movements and collisions
+*** independent from the frame rate.
+**/
+const uint32 SYSTEM_UPDATE_STEP = 10;
+
+/** \brief The maximum amount of milliseconds the game can catch up with in one frame
+*** Any time beyond this is dropped, so that a long hitch (a map loading for instance)
+*** doesn't make the game run many update steps in a row.
+**/
+const uint32 SYSTEM_MAX_FRAME_UPDATE_TIME = 100;
+
+//! \brief The number of milliseconds a frame should last, sleeping if drawn and updated sooner.
+const uint32 SYSTEM_TARGET_FRAME_TIME = 16;
+
 //! \brief All of the possible states which a SystemTimer classs object may be in
 enum SYSTEM_TIMER_STATE {
     SYSTEM_TIMER_INVALID  = -1,
@@ -364,6 +379,7 @@ public:
     void InitializeUpdateTimer() {
         _last_update = SDL_GetTicks();
         _update_time = 1;
+        _pending_update_time = 0;
     }
 
     /** \brief Adds a timer to the set system timers for auto updating
@@ -382,12 +398,30 @@ public:
     **/
     void RemoveAutoTimer(SystemTimer *timer);
 
-    /** \brief Updates the game timer variables.
-    *** This function should only be called <b>once</b> for each cycle through the main game loop. Since
-    *** it is called inside the loop in main.cpp, you should have no reason to call this function anywhere
-    *** else.
+    /** \brief Starts a new frame of the main game loop
+    *** The time elapsed since the last frame is added to the time the game has to be updated by,
+    *** which is then consumed by UpdateTimers() in fixed update steps.
+    *** This function should only be called <b>once</b> at the beginning of each cycle through the main game loop.
+    **/
+    void BeginFrame();
+
+    /** \brief Updates the game timer variables by one update step.
+    *** \return False if less than an update step is left to update the game by in the current frame.
+    ***
+    *** This function is called in the loop in main.cpp, which updates the game once per update step,
+    *** so you should have no reason to call this function anywhere else.
+    **/
+    bool UpdateTimers();
+
+    /** \brief Sleeps until the current frame has lasted the target frame time
+    *** \param vsync Whether the buffers swap waits for the vertical synchronization, which then paces
+    *** the frames instead of sleeping.
+    ***
+    *** The sleep time is shortened by the average time the previous sleeps lasted longer than requested.
+    *** This function should only be called <b>once</b> for each cycle through the main game loop, once
+    *** the frame is drawn and before swapping the buffers, so that the swap isn't counted as frame work.
     **/
-    void UpdateTimers();
+    void WaitForNextFrame(bool vsync);
 
     /** \brief Checks all system timers for whether they should be paused or resumed
     *** This function is typically called whenever the ModeEngine class has changed the active game mode.
@@ -408,6 +442,42 @@ public:
         return _update_time;
     }
 
+    /** \brief Frame pacing statistics
+    *** The frame time is the real time between the beginning of the last two frames, and a late frame
+    *** is a frame which took longer than the target frame time to be drawn and updated.
+    *** The dropped update time is the time the game wasn't updated by, when a frame took too long.
+    **/
+    //@{
+    uint32 GetFrameTime() const {
+        return _frame_time;
+    }
+
+    uint32 GetFrameCount() const {
+        return _frame_count;
+    }
+
+    uint32 GetLateFrameCount() const {
+        return _late_frame_count;
+    }
+
+    uint32 GetDroppedUpdateTime() const {
+        return _dropped_update_time;
+    }
+    //@}
+
+    //! \brief Returns the number of update steps run since the game started.
+    uint32 GetUpdateStepCount() const {
+        return _update_step_count;
+    }
+
+    /** \brief Returns how far the time elapsed is between the last update step and the next one, from 0.0f to 1.0f
+    *** The drawing can use it to interpolate between the last two update steps, which keeps the movements
+    *** smooth when the frame rate isn't a multiple of the update steps rate.
+    **/
+    float GetUpdateInterpolation() const {
+        return std::min(static_cast<float>(_pending_update_time) / static_cast<float>(SYSTEM_UPDATE_STEP), 1.0f);
+    }
+
     /** \brief Sets the play time of a game instance
     *** \param h The amount of hours to set.
     *** \param m The amount of minutes to set.
@@ -498,6 +568,24 @@ private:
     //! \brief The number of milliseconds that have transpired on the last timer update.
     uint32 _update_time;
 
+    //! \brief The number of milliseconds the game still has to be updated by in the current frame.
+    uint32 _pending_update_time;
+
+    //! \brief The number of update steps run since the game started.
+    uint32 _update_step_count;
+
+    //! \brief The time at which the current frame began, in milliseconds.
+    uint32 _frame_start;
+
+    //! \brief The frame pacing statistics.
+    uint32 _frame_time;
+    uint32 _frame_count;
+    uint32 _late_frame_count;
+    uint32 _dropped_update_time;
+
+    //! \brief The average time the sleeps lasted longer than requested, in milliseconds.
+    float _sleep_overshoot;
+
     /** \name Play time members
     *** \brief Timers that retain the total amount of time that the user has been playing
     *** When the player starts a new game or loads an existing game, these timers are reset.
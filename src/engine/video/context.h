@@ -39,7 +39,7 @@ namespace private_video
 *** system. The context must be pushed and then popped by any method of the VideoEngine
 *** class which modifies this context.
 ***
-*** \note Transformations are actually handled separately by the OpenGL
+*** \note Transformations are actually handled separately by the video engine
 *** transformation stack
 *** ***************************************************************************/
 class Context
@@ -526,104 +526,66 @@ void ImageDescriptor::_DrawOrientation() const
 
 void ImageDescriptor::_DrawTexture(const Color *draw_color) const
 {
-    // Array of the four vertexes defined on the 2D plane for glDrawArrays()
-    // This is no longer const, because when tiling the background for the menu's
-    // sometimes you need to draw part of a texture
-    float vert_coords[] = {
-        _u1, _v1,
-        _u2, _v1,
-        _u2, _v2,
-        _u1, _v2,
-    };
+    // The four vertexes defined on the 2D plane, transformed by the current modelview
+    // transformation so that the quad can be drawn along with the next images ones.
+    // Some parts of the texture only are drawn when tiling the menus backgrounds.
+    const Transform2D &transform = VideoManager->_transform;
+    float vert_coords[8];
+    transform.Apply(_u1, _v1, vert_coords[0], vert_coords[1]);
+    transform.Apply(_u2, _v1, vert_coords[2], vert_coords[3]);
+    transform.Apply(_u2, _v2, vert_coords[4], vert_coords[5]);
+    transform.Apply(_u1, _v2, vert_coords[6], vert_coords[7]);
 
     // If no color array was passed, use the image's own vertex colors
     if(!draw_color)
         draw_color = _color;
 
-    // Set blending parameters
-    if(VideoManager->_current_context.blend) {
-        VideoManager->EnableBlending();
-        if(VideoManager->_current_context.blend == 1)
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
-        else
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
-    } else if(_blend) {
-        VideoManager->EnableBlending();
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
-    } else {
-        VideoManager->DisableBlending();
-    }
-
-    VideoManager->EnableVertexArray();
-    glVertexPointer(2, GL_FLOAT, 0, vert_coords);
-
-    // If we have a valid image texture poiner, setup texture coordinates and the texture coordinate array for glDrawArrays()
-    if(_texture) {
-        // Set the texture coordinates
-        float s0, s1, t0, t1;
+    // Set blending parameters, the context blending taking precedence over the image one
+    int32 blend = VideoManager->_current_context.blend;
+    if(!blend && _blend)
+        blend = 1; // Normal blending
 
-        s0 = _texture->u1 + (_u1 * (_texture->u2 - _texture->u1));
-        s1 = _texture->u1 + (_u2 * (_texture->u2 - _texture->u1));
-        t0 = _texture->v1 + (_v1 * (_texture->v2 - _texture->v1));
-        t1 = _texture->v1 + (_v2 * (_texture->v2 - _texture->v1));
+    SpriteBatcher &sprite_batcher = VideoManager->_sprite_batcher;
 
-        // Swap x texture coordinates if x flipping is enabled
-        if(VideoManager->_current_context.x_flip) {
-            float temp = s0;
-            s0 = s1;
-            s1 = temp;
-        }
+    // Without image texture, we're drawing pure color on the vertices
+    if(!_texture) {
+        sprite_batcher.SetState(NULL, false, blend);
+        sprite_batcher.AddQuad(vert_coords, NULL, draw_color, _unichrome_vertices);
+        return;
+    }
 
-        // Swap y texture coordinates if y flipping is enabled
-        if(VideoManager->_current_context.y_flip) {
-            float temp = t0;
-            t0 = t1;
-            t1 = temp;
-        }
+    // Set the texture coordinates
+    float s0, s1, t0, t1;
 
-        // Place the texture coordinates in a 4x2 array mirroring the structure of the vertex array for use in glDrawArrays().
-        float tex_coords[] = {
-            s0, t1,
-            s1, t1,
-            s1, t0,
-            s0, t0,
-        };
-
-        // Enable texturing and bind texture
-        VideoManager->EnableTexture2D();
-        TextureManager->_BindTexture(_texture->texture_sheet->tex_id);
-        _texture->texture_sheet->Smooth(_smooth);
-
-        // Enable and setup the texture coordinate array
-        VideoManager->EnableTextureCoordArray();
-        glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
-
-        if(_unichrome_vertices) {
-            glColor4fv((GLfloat *)draw_color[0].GetColors());
-            VideoManager->DisableColorArray();
-        } else {
-            VideoManager->EnableColorArray();
-            glColorPointer(4, GL_FLOAT, 0, (GLfloat *)draw_color);
-        }
-    } // if (_texture)
-    else {
-        // Otherwise there is no image texture, so we're drawing pure color on the vertices
+    s0 = _texture->u1 + (_u1 * (_texture->u2 - _texture->u1));
+    s1 = _texture->u1 + (_u2 * (_texture->u2 - _texture->u1));
+    t0 = _texture->v1 + (_v1 * (_texture->v2 - _texture->v1));
+    t1 = _texture->v1 + (_v2 * (_texture->v2 - _texture->v1));
 
-        // Use a single call to glColor for unichrome images, or a setup a gl color array for multiple colors
-        if(_unichrome_vertices) {
-            glColor4fv((GLfloat *)draw_color[0].GetColors());
-            VideoManager->DisableColorArray();
-        } else {
-            VideoManager->EnableColorArray();
-            glColorPointer(4, GL_FLOAT, 0, (GLfloat *)draw_color);
-        }
+    // Swap x texture coordinates if x flipping is enabled
+    if(VideoManager->_current_context.x_flip) {
+        float temp = s0;
+        s0 = s1;
+        s1 = temp;
+    }
 
-        // Disable texturing as we're using pure colour
-        VideoManager->DisableTexture2D();
+    // Swap y texture coordinates if y flipping is enabled
+    if(VideoManager->_current_context.y_flip) {
+        float temp = t0;
+        t0 = t1;
+        t1 = temp;
     }
 
-    // Use a vertex array to draw all of the vertices
-    glDrawArrays(GL_QUADS, 0, 4);
+    // Place the texture coordinates in a 4x2 array mirroring the structure of the vertex array.
+    float tex_coords[] = {
+        s0, t1,
+        s1, t1,
+        s1, t0,
+        s0, t0,
+    };
+
+    sprite_batcher.SetState(_texture->texture_sheet, _smooth, blend);
+    sprite_batcher.AddQuad(vert_coords, tex_coords, draw_color, _unichrome_vertices);
 } // void ImageDescriptor::_DrawTexture(const Color* color_array) const
 
 bool ImageDescriptor::_LoadMultiImage(std::vector<StillImage>& images, const std::string &filename,
@@ -1074,6 +1036,7 @@ void AnimatedImage::Clear()
     ImageDescriptor::Clear();
     _frame_index = 0;
     _frame_counter = 0;
+    _skipped_time = 0;
     // clear all animation frame images
     for(std::vector<AnimationFrame>::iterator it = _frames.begin(); it != _frames.end(); ++it)
         (*it).image.Clear();
@@ -1084,6 +1047,21 @@ void AnimatedImage::Clear()
     _animation_time = 0;
 }
 
+std::string AnimatedImage::GetAnimationScriptImage(const std::string &filename)
+{
+    vt_script::ReadScriptDescriptor image_script;
+    if(!image_script.OpenFile(filename))
+        return std::string();
+
+    std::string image_filename;
+    if(image_script.OpenTable("animation")) {
+        image_filename = image_script.ReadString("image_filename");
+        image_script.CloseTable();
+    }
+    image_script.CloseFile();
+    return image_filename;
+}
+
 bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
 {
     vt_script::ReadScriptDescriptor image_script;
@@ -1337,6 +1315,26 @@ void AnimatedImage::DisableGrayScale()
 
 void AnimatedImage::Update(uint32 elapsed_time)
 {
+    // Get the amount of milliseconds that have pass since the last display
+    _skipped_time += (elapsed_time == 0) ? vt_system::SystemManager->GetUpdateTime() : elapsed_time;
+    UpdateSkippedTime();
+}
+
+void AnimatedImage::SkipUpdate(uint32 elapsed_time)
+{
+    if(_number_loops >= 0) {
+        Update(elapsed_time);
+        return;
+    }
+
+    _skipped_time += (elapsed_time == 0) ? vt_system::SystemManager->GetUpdateTime() : elapsed_time;
+}
+
+void AnimatedImage::UpdateSkippedTime()
+{
+    uint32 ms_change = _skipped_time;
+    _skipped_time = 0;
+
     if(_frames.size() <= 1)
         return;
 
@@ -1350,8 +1348,10 @@ void AnimatedImage::Update(uint32 elapsed_time)
         return;
     }
 
-    // Get the amount of milliseconds that have pass since the last display
-    uint32 ms_change = (elapsed_time == 0) ? vt_system::SystemManager->GetUpdateTime() : elapsed_time;
+    // Remove the whole loops of infinitely looping animations, as they don't change the frame shown.
+    // One loop is kept so that a terminator frame is still reached.
+    if(_number_loops < 0 && _animation_time > 0 && ms_change > _animation_time)
+        ms_change = _animation_time + ms_change % _animation_time;
     _frame_counter += ms_change;
 
     // If the frame time has expired, update the frame index and counter.
@@ -1380,7 +1380,7 @@ void AnimatedImage::Update(uint32 elapsed_time)
         // Add the time left already spent on the new frame.
         _frame_counter = ms_change;
     }
-} // void AnimatedImage::Update()
+} // void AnimatedImage::UpdateSkippedTime()
 
 bool AnimatedImage::AddFrame(const std::string &frame, uint32 frame_time)
 {
@@ -1472,6 +1472,7 @@ void AnimatedImage::RandomizeAnimationFrame() {
     uint32 index = vt_utils::RandomBoundedInteger(0, nb_frames - 1);
     _frame_index = index;
     _frame_counter = 0;
+    _skipped_time = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -1542,7 +1543,7 @@ void CompositeImage::Draw(const Color &draw_color) const
         if(coord_sys.GetVerticalDirection() < 0.0f)
             y_scale = -y_scale;
 
-        glScalef(x_scale, y_scale, 1.0f);
+        VideoManager->Scale(x_scale, y_scale);
 
         if(draw_color == Color::white)
             _elements[i].image._DrawTexture(_color);
@@ -92,6 +92,7 @@ class StillImage;
 class ImageDescriptor
 {
     friend class VideoEngine;
+    friend class ImageBatch;
 
 public:
     ImageDescriptor();
@@ -310,6 +311,9 @@ protected:
     *** completed prior to the calling of this function. The draw_color argument is usually nothing
     *** more than a pointer to the _color member of this very class, but in certain cases like during
     *** a screen fade these colors may differ.
+    ***
+    *** The image quad is queued in the video engine sprite batcher, to be drawn along with the
+    *** next images using the same texture sheet and blending.
     **/
     void _DrawTexture(const Color *draw_color) const;
 
@@ -341,6 +345,7 @@ class StillImage : public ImageDescriptor
     friend class CompositeImage;
     friend class TextureController;
     friend class vt_mode_manager::ParticleSystem;
+    friend class ImageBatch;
 
 public:
     //! \brief Supply the constructor with "true" if you want this to represent a grayscale image
@@ -600,6 +605,13 @@ public:
      */
     bool LoadFromAnimationScript(const std::string &filename);
 
+    /** \brief Reads the image filename used by an animation script, without loading anything
+    *** \param filename The name of the animation lua script
+    *** \return The image filename, or an empty string if it couldn't be read.
+    *** This is used to decode the images of several animations at once before loading them.
+    **/
+    static std::string GetAnimationScriptImage(const std::string &filename);
+
     /** \brief Draws the current frame image which is modulated by a color
     *** \param draw_color The color to modulate the image by
     **/
@@ -630,6 +642,7 @@ public:
         _frame_counter = 0;
         _loop_counter = 0;
         _loops_finished = false;
+        _skipped_time = 0;
     }
 
     /** \brief Called every frame to update the animation's current frame
@@ -645,6 +658,21 @@ public:
         Update(0);
     }
 
+    /** \brief Called instead of Update() when the animation isn't visible
+    *** The elapsed time is only recorded, and the animation catches up with it
+    *** at once on the next call to Update() or UpdateSkippedTime().
+    *** \param elapsed_time The time to skip, or the actual elapsed time if equal to 0.
+    *** \note The animations with a finite number of loops are updated right away,
+    *** so that IsLoopsFinished() can be relied upon.
+    **/
+    void SkipUpdate(uint32 elapsed_time = 0);
+
+    /** \brief Applies the time recorded by SkipUpdate() to the animation
+    *** The whole animation loops are skipped, so that this costs at most two
+    *** loops of frame changes, however long the animation wasn't updated.
+    **/
+    void UpdateSkippedTime();
+
     /** \brief Adds an animation frame using the filename of the image to add.
     *** \param frame The filename of the frame image to add.
     *** \param frame_time The number of milliseconds that this animation should last for
@@ -768,6 +796,7 @@ public:
         if(index > _frames.size()) return;
         _frame_index = index;
         _frame_counter = 0;
+        _skipped_time = 0;
     }
 
     /** \brief Sets a random frame index to the animation.
@@ -782,6 +811,7 @@ public:
     **/
     void SetTimeProgress(uint32 time) {
         _frame_counter = time;
+        _skipped_time = 0;
     }
 
     /** \brief Set the number of loops for the animation.
@@ -818,6 +848,9 @@ private:
     //! \brief Counts how long each frame has been shown for.
     uint32 _frame_counter;
 
+    //! \brief The time recorded by SkipUpdate(), not applied to the frame index and counter yet.
+    uint32 _skipped_time;
+
     /** \brief The number of times to loop the animation frames.
     *** A negative value indicates to loop forever, which is the default.
     **/
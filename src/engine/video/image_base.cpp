@@ -62,6 +62,10 @@ bool ImageMemory::LoadImage(const std::string &filename)
         pixels = NULL;
     }
 
+    // Use the image data if it was already decoded ahead.
+    if(TextureManager->_TakeDecodedImage(filename, *this))
+        return true;
+
     SDL_Surface *temp_surf = NULL;
     SDL_Surface *alpha_surf = NULL;
 
@@ -146,6 +150,66 @@ bool ImageMemory::LoadImage(const std::string &filename)
     return true;
 }
 
+
+
+bool ImageMemory::DecodeImage(const std::string &filename)
+{
+    if(pixels != NULL) {
+        free(pixels);
+        pixels = NULL;
+    }
+
+    SDL_Surface *temp_surf = IMG_Load(filename.c_str());
+    if(temp_surf == NULL) {
+        PRINT_ERROR << "Couldn't load image file: " << filename << std::endl;
+        return false;
+    }
+
+    // Blit the image into a surface whose pixels are stored in RGBA byte order,
+    // instead of using the display format, which is only valid in the main thread.
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    SDL_Surface *rgba_surf = SDL_CreateRGBSurface(SDL_SWSURFACE, temp_surf->w, temp_surf->h, 32,
+                                                  0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
+#else
+    SDL_Surface *rgba_surf = SDL_CreateRGBSurface(SDL_SWSURFACE, temp_surf->w, temp_surf->h, 32,
+                                                  0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
+#endif
+    if(rgba_surf == NULL) {
+        PRINT_ERROR << "Couldn't convert image file: " << filename << std::endl;
+        SDL_FreeSurface(temp_surf);
+        return false;
+    }
+
+    // Copy the alpha channel as is rather than blending it.
+    SDL_SetAlpha(temp_surf, 0, SDL_ALPHA_OPAQUE);
+    SDL_BlitSurface(temp_surf, NULL, rgba_surf, NULL);
+    SDL_FreeSurface(temp_surf);
+
+    width = rgba_surf->w;
+    height = rgba_surf->h;
+    pixels = malloc(width * height * 4);
+    rgb_format = false;
+
+    SDL_LockSurface(rgba_surf);
+    for(uint32 y = 0; y < height; ++y) {
+        uint8 *dst_pixel = ((uint8 *)pixels) + y * width * 4;
+        memcpy(dst_pixel, (uint8 *)rgba_surf->pixels + y * rgba_surf->pitch, width * 4);
+
+        // GL_LINEAR white artifact removal, as done in LoadImage().
+        for(uint32 x = 0; x < width; ++x, dst_pixel += 4) {
+            if(dst_pixel[3] == 0) {
+                dst_pixel[0] = 0;
+                dst_pixel[1] = 0;
+                dst_pixel[2] = 0;
+            }
+        }
+    }
+    SDL_UnlockSurface(rgba_surf);
+
+    SDL_FreeSurface(rgba_surf);
+    return true;
+}
+
 bool ImageMemory::SaveImage(const std::string &filename)
 {
     if(pixels == NULL) {
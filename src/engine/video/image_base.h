@@ -88,6 +88,15 @@ public:
     **/
     bool LoadImage(const std::string &filename);
 
+    /** \brief Decodes raw image data from a file without relying on the video display format
+    *** \param filename The name of the image file to decode.
+    *** \return True if the image was decoded successfully, false if it was not
+    ***
+    *** Unlike LoadImage(), this function doesn't use the video engine and may be called
+    *** from another thread, as the image decoder worker threads do.
+    **/
+    bool DecodeImage(const std::string &filename);
+
     /** \brief Saves raw image data to a file
     *** \param filename The full filename of the image to save in PNG format.
     *** \return True if the image was saved successfully, false if it was not
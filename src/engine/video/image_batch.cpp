@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2004-2011 by The Allacrost Project
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_batch.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the ImageBatch class.
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "image_batch.h"
+
+#include "video.h"
+
+using namespace vt_utils;
+
+namespace vt_video
+{
+
+bool ImageBatch::_AddImage(const StillImage &image, float x, float y, const Color *color)
+{
+    private_video::BaseTexture *texture = image._texture;
+    if(!texture || !texture->texture_sheet)
+        return false;
+
+    if(color && IsFloatEqual((*color)[3], 0.0f))
+        return false;
+
+    // Find the batch of the image texture sheet, or start a new one.
+    bool colored = (color != NULL);
+    SheetBatch *batch = NULL;
+    for(uint32 i = 0; i < _sheet_batches.size(); ++i) {
+        if(_sheet_batches[i].texture_sheet == texture->texture_sheet && _sheet_batches[i].smooth == image._smooth
+                && _sheet_batches[i].colored == colored && _sheet_batches[i].blend == image._blend) {
+            batch = &_sheet_batches[i];
+            break;
+        }
+    }
+    if(!batch) {
+        _sheet_batches.push_back(SheetBatch());
+        batch = &_sheet_batches.back();
+        batch->texture_sheet = texture->texture_sheet;
+        batch->smooth = image._smooth;
+        batch->colored = colored;
+        batch->blend = image._blend;
+    }
+
+    // Same texture coordinates computation as in ImageDescriptor::_DrawTexture()
+    float s0 = texture->u1 + (image._u1 * (texture->u2 - texture->u1));
+    float s1 = texture->u1 + (image._u2 * (texture->u2 - texture->u1));
+    float t0 = texture->v1 + (image._v1 * (texture->v2 - texture->v1));
+    float t1 = texture->v1 + (image._v2 * (texture->v2 - texture->v1));
+
+    x += image._x_offset;
+    y += image._y_offset;
+
+    float left = x + image._u1 * image._width;
+    float right = x + image._u2 * image._width;
+    float top = y + (1.0f - image._v2) * image._height;
+    float bottom = y + (1.0f - image._v1) * image._height;
+
+    // Top left, top right, bottom right, bottom left.
+    float vertices[] = { left, top, right, top, right, bottom, left, bottom };
+    float tex_coords[] = { s0, t0, s1, t0, s1, t1, s0, t1 };
+    batch->vertices.insert(batch->vertices.end(), vertices, vertices + 8);
+    batch->tex_coords.insert(batch->tex_coords.end(), tex_coords, tex_coords + 8);
+
+    if(colored) {
+        const float *rgba = color->GetColors();
+        for(uint32 i = 0; i < 4; ++i)
+            batch->colors.insert(batch->colors.end(), rgba, rgba + 4);
+    }
+    return true;
+}
+
+void ImageBatch::Draw(const Color &draw_color) const
+{
+    if(_sheet_batches.empty())
+        return;
+
+    bool transparent = IsFloatEqual(draw_color[3], 0.0f);
+
+    private_video::Context &current_context = VideoManager->_current_context;
+
+    // The batch is drawn directly, after the queued sprites.
+    VideoManager->FlushSprites();
+
+    VideoManager->PushMatrix();
+
+    // Apply the screen shaking, as done in ImageDescriptor::_DrawOrientation()
+    if(VideoManager->IsScreenShaking()) {
+        const CoordSys &coordinate_system = current_context.coordinate_system;
+        float x_shake = VideoManager->_x_shake * (coordinate_system.GetRight() - coordinate_system.GetLeft()) / VIDEO_STANDARD_RES_WIDTH;
+        float y_shake = VideoManager->_y_shake * (coordinate_system.GetTop() - coordinate_system.GetBottom()) / VIDEO_STANDARD_RES_HEIGHT;
+        VideoManager->MoveRelative(x_shake * coordinate_system.GetHorizontalDirection(),
+                                   y_shake * coordinate_system.GetVerticalDirection());
+    }
+    VideoManager->LoadGLTransform();
+
+    VideoManager->EnableTexture2D();
+    VideoManager->EnableVertexArray();
+    VideoManager->EnableTextureCoordArray();
+
+    for(uint32 i = 0; i < _sheet_batches.size(); ++i) {
+        const SheetBatch &batch = _sheet_batches[i];
+        if(transparent && !batch.colored)
+            continue;
+
+        // Set blending parameters, the context blending taking precedence over the images one
+        int32 blend = current_context.blend;
+        if(!blend && batch.blend)
+            blend = 1;
+
+        if(blend) {
+            VideoManager->EnableBlending();
+            if(blend == 1)
+                VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+            else
+                VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+        } else {
+            VideoManager->DisableBlending();
+        }
+
+        TextureManager->_BindTexture(batch.texture_sheet->tex_id);
+        batch.texture_sheet->Smooth(batch.smooth);
+
+        if(batch.colored) {
+            VideoManager->EnableColorArray();
+            glColorPointer(4, GL_FLOAT, 0, &batch.colors[0]);
+        } else {
+            VideoManager->DisableColorArray();
+            VideoManager->SetColor(draw_color);
+        }
+
+        glVertexPointer(2, GL_FLOAT, 0, &batch.vertices[0]);
+        glTexCoordPointer(2, GL_FLOAT, 0, &batch.tex_coords[0]);
+        glDrawArrays(GL_QUADS, 0, batch.vertices.size() / 2);
+    }
+
+    VideoManager->ResetGLTransform();
+    VideoManager->PopMatrix();
+}
+
+}  // namespace vt_video
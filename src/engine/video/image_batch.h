@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2004-2011 by The Allacrost Project
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_batch.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the ImageBatch class.
+*** ***************************************************************************/
+
+#ifndef __IMAGE_BATCH_HEADER__
+#define __IMAGE_BATCH_HEADER__
+
+#include "color.h"
+
+namespace vt_video
+{
+
+class StillImage;
+
+namespace private_video
+{
+class TexSheet;
+}
+
+/** ****************************************************************************
+*** \brief Draws many still images with one draw call per texture sheet.
+***
+*** The vertex and texture coordinates of the images are computed once when
+*** they are added, and grouped by texture sheet. This is meant for content
+*** which doesn't change once built, like the map tiles, where drawing each
+*** image on its own would cost thousands of draw calls per frame.
+***
+*** It can also be rebuilt every frame to gather many small images drawn
+*** with the same blending, like the map halos and lights, giving each of
+*** them its own color.
+***
+*** \note The images are drawn with their top edge at their y position and
+*** their bottom edge at y + height, as in the coordinate systems whose
+*** vertical axis points down, like the map mode one. The flip and alignment
+*** draw flags, as well as the images own vertex colors, are ignored.
+***
+*** \note The batch doesn't reference the images textures: the images added
+*** must be kept alive as long as the batch is drawn.
+*** ***************************************************************************/
+class ImageBatch
+{
+public:
+    ImageBatch()
+    {}
+
+    //! \brief Removes all the images from the batch.
+    void Clear() {
+        _sheet_batches.clear();
+    }
+
+    //! \brief Tells whether no image was added to the batch.
+    bool IsEmpty() const {
+        return _sheet_batches.empty();
+    }
+
+    /** \brief Adds a still image to the batch
+    *** \param image The image to add, using its current dimensions and smoothing.
+    *** \param x, y The position of the image top left corner, relative to the batch origin.
+    *** \return false if the image has no texture loaded, in which case it isn't added.
+    **/
+    bool AddImage(const StillImage &image, float x, float y) {
+        return _AddImage(image, x, y, NULL);
+    }
+
+    /** \brief Adds a still image to the batch, modulated by the given color
+    *** \param color The color of this image, used instead of the batch draw color.
+    *** \return false if the image has no texture loaded or the color is fully transparent.
+    **/
+    bool AddImage(const StillImage &image, float x, float y, const Color &color) {
+        return _AddImage(image, x, y, &color);
+    }
+
+    /** \brief Draws all the images of the batch
+    *** \param draw_color The color to modulate the images added without color by.
+    *** The batch origin is put at the current draw cursor position, and the
+    *** blending draw flag and screen shaking are taken into account.
+    **/
+    void Draw(const Color &draw_color = Color::white) const;
+
+private:
+    //! \brief The images of the batch using the same texture sheet and smoothing.
+    struct SheetBatch {
+        private_video::TexSheet *texture_sheet;
+
+        bool smooth;
+
+        //! \brief Whether the images were added with their own color.
+        bool colored;
+
+        //! \brief Whether the images ask for blending when the draw context doesn't, as in ImageDescriptor::_DrawTexture().
+        bool blend;
+
+        //! \brief Four (x, y) vertices per image.
+        std::vector<float> vertices;
+
+        //! \brief Four (u, v) texture coordinates per image.
+        std::vector<float> tex_coords;
+
+        //! \brief Four (r, g, b, a) vertex colors per image, only used by the colored batches.
+        std::vector<float> colors;
+    };
+
+    std::vector<SheetBatch> _sheet_batches;
+
+    //! \brief Adds an image to the batch of its texture sheet, with the given color if any.
+    bool _AddImage(const StillImage &image, float x, float y, const Color *color);
+}; // class ImageBatch
+
+}  // namespace vt_video
+
+#endif // __IMAGE_BATCH_HEADER__
@@ -0,0 +1,332 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_decoder.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the ImageDecoder class.
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "image_decoder.h"
+
+#include "engine/profiler.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+//! \brief The maximum number of worker threads decoding the images.
+const uint32 IMAGE_DECODER_MAX_THREADS = 4;
+
+#if (THREAD_TYPE == SDL_THREADS)
+#define DECODER_LOCK() SDL_mutexP(_lock)
+#define DECODER_UNLOCK() SDL_mutexV(_lock)
+#define DECODER_WAIT(cond) SDL_CondWait(cond, _lock)
+#define DECODER_SIGNAL(cond) SDL_CondBroadcast(cond)
+#else
+#define DECODER_LOCK()
+#define DECODER_UNLOCK()
+#define DECODER_WAIT(cond)
+#define DECODER_SIGNAL(cond)
+#endif
+
+#if (THREAD_TYPE == SDL_THREADS)
+//! \brief Returns the number of processors available, or 1 if unknown.
+static uint32 getProcessorCount()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return std::max(static_cast<uint32>(info.dwNumberOfProcessors), static_cast<uint32>(1));
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 1 ? static_cast<uint32>(count) : 1;
+#endif
+}
+#endif
+
+
+
+ImageDecoder::ImageDecoder() :
+    _next_batch(1),
+    _threads_started(false),
+    _quit(false)
+{
+#if (THREAD_TYPE == SDL_THREADS)
+    _lock = SDL_CreateMutex();
+    _job_queued = SDL_CreateCond();
+    _job_done = SDL_CreateCond();
+#endif
+}
+
+
+
+ImageDecoder::~ImageDecoder()
+{
+    DECODER_LOCK();
+    _quit = true;
+    DECODER_SIGNAL(_job_queued);
+    DECODER_UNLOCK();
+
+#if (THREAD_TYPE == SDL_THREADS)
+    for(uint32 i = 0; i < _threads.size(); ++i)
+        SDL_WaitThread(_threads[i], NULL);
+#endif
+    _threads.clear();
+
+    for(std::list<DecodeJob *>::iterator it = _jobs.begin(); it != _jobs.end(); ++it)
+        _DeleteJob(*it);
+    _jobs.clear();
+
+#if (THREAD_TYPE == SDL_THREADS)
+    SDL_DestroyCond(_job_done);
+    SDL_DestroyCond(_job_queued);
+    SDL_DestroyMutex(_lock);
+#endif
+}
+
+
+
+uint32 ImageDecoder::AddBatch(const std::vector<std::string> &filenames)
+{
+    if(!_threads_started)
+        _StartThreads();
+
+    uint32 batch = _next_batch;
+    if(++_next_batch == 0)
+        _next_batch = 1;
+
+    if(filenames.empty())
+        return batch;
+
+    DECODER_LOCK();
+    for(uint32 i = 0; i < filenames.size(); ++i) {
+        DecodeJob *job = new DecodeJob();
+        job->filename = filenames[i];
+        job->batch = batch;
+        job->state = DECODE_QUEUED;
+        job->success = false;
+        _jobs.push_back(job);
+    }
+    DECODER_SIGNAL(_job_queued);
+    DECODER_UNLOCK();
+
+    return batch;
+}
+
+
+
+bool ImageDecoder::IsDecoding(uint32 batch)
+{
+    bool decoding = false;
+
+    DECODER_LOCK();
+    for(std::list<DecodeJob *>::iterator it = _jobs.begin(); it != _jobs.end(); ++it) {
+        if((*it)->batch == batch && (*it)->state != DECODE_DONE) {
+            decoding = true;
+            break;
+        }
+    }
+    DECODER_UNLOCK();
+
+    return decoding;
+}
+
+
+
+bool ImageDecoder::TakeBatchImage(uint32 batch, std::string &filename, ImageMemory &image)
+{
+    bool found = false;
+
+    DECODER_LOCK();
+    // Only the main thread removes jobs, so the iterator stays valid while waiting.
+    std::list<DecodeJob *>::iterator it = _jobs.begin();
+    while(it != _jobs.end() && !found) {
+        DecodeJob *job = *it;
+        if(job->batch != batch) {
+            ++it;
+            continue;
+        }
+
+        _WaitForJob(job);
+        it = _jobs.erase(it);
+
+        if(job->success) {
+            filename = job->filename;
+            image = job->image;
+            job->image.pixels = NULL;
+            found = true;
+        }
+        _DeleteJob(job);
+    }
+    DECODER_UNLOCK();
+
+    return found;
+}
+
+
+
+void ImageDecoder::DiscardBatch(uint32 batch)
+{
+    DECODER_LOCK();
+    std::list<DecodeJob *>::iterator it = _jobs.begin();
+    while(it != _jobs.end()) {
+        DecodeJob *job = *it;
+        if(job->batch != batch) {
+            ++it;
+            continue;
+        }
+
+        // The images being decoded are still used by the worker threads.
+        while(job->state == DECODE_RUNNING)
+            DECODER_WAIT(_job_done);
+
+        it = _jobs.erase(it);
+        _DeleteJob(job);
+    }
+    DECODER_UNLOCK();
+}
+
+
+
+bool ImageDecoder::TakeImage(const std::string &filename, ImageMemory &image)
+{
+    bool found = false;
+
+    DECODER_LOCK();
+    for(std::list<DecodeJob *>::iterator it = _jobs.begin(); it != _jobs.end(); ++it) {
+        DecodeJob *job = *it;
+        if(job->filename != filename)
+            continue;
+
+        _WaitForJob(job);
+        _jobs.erase(it);
+
+        if(job->success) {
+            image.width = job->image.width;
+            image.height = job->image.height;
+            image.rgb_format = job->image.rgb_format;
+            image.pixels = job->image.pixels;
+            job->image.pixels = NULL;
+            found = true;
+        }
+        _DeleteJob(job);
+        break;
+    }
+    DECODER_UNLOCK();
+
+    return found;
+}
+
+
+
+void ImageDecoder::_StartThreads()
+{
+    _threads_started = true;
+
+#if (THREAD_TYPE == SDL_THREADS)
+    if(!_lock || !_job_queued || !_job_done) {
+        PRINT_WARNING << "Unable to create the image decoding locks: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    // The main thread also decodes the images it waits for.
+    uint32 thread_count = std::min(std::max(getProcessorCount() - 1, static_cast<uint32>(1)), IMAGE_DECODER_MAX_THREADS);
+    for(uint32 i = 0; i < thread_count; ++i) {
+        Thread *thread = SDL_CreateThread(_WorkerThread, this);
+        if(!thread) {
+            // The images will then be decoded by the existing threads, or when waited for.
+            PRINT_WARNING << "Unable to create an image decoding thread: " << SDL_GetError() << std::endl;
+            break;
+        }
+        _threads.push_back(thread);
+    }
+#endif
+}
+
+
+
+void ImageDecoder::_RunJob(DecodeJob *job)
+{
+    job->state = DECODE_RUNNING;
+    DECODER_UNLOCK();
+
+    {
+        vt_system::TraceScope trace("ImageDecoder::Decode");
+        job->success = job->image.DecodeImage(job->filename);
+    }
+
+    DECODER_LOCK();
+    job->state = DECODE_DONE;
+    DECODER_SIGNAL(_job_done);
+}
+
+
+
+void ImageDecoder::_WaitForJob(DecodeJob *job)
+{
+    if(job->state == DECODE_QUEUED)
+        _RunJob(job);
+
+    while(job->state != DECODE_DONE)
+        DECODER_WAIT(_job_done);
+}
+
+
+
+void ImageDecoder::_DeleteJob(DecodeJob *job)
+{
+    if(job->image.pixels != NULL) {
+        free(job->image.pixels);
+        job->image.pixels = NULL;
+    }
+    delete job;
+}
+
+
+
+void ImageDecoder::_Work()
+{
+    DECODER_LOCK();
+    while(!_quit) {
+        DecodeJob *job = NULL;
+        for(std::list<DecodeJob *>::iterator it = _jobs.begin(); it != _jobs.end(); ++it) {
+            if((*it)->state == DECODE_QUEUED) {
+                job = *it;
+                break;
+            }
+        }
+
+        if(job)
+            _RunJob(job);
+        else
+            DECODER_WAIT(_job_queued);
+    }
+    DECODER_UNLOCK();
+}
+
+
+
+int ImageDecoder::_WorkerThread(void *decoder_ptr)
+{
+    static_cast<ImageDecoder *>(decoder_ptr)->_Work();
+    vt_system::ReleaseTraceBuffer();
+    return 0;
+}
+
+} // namespace private_video
+
+} // namespace vt_video
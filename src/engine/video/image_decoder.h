@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_decoder.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the ImageDecoder class.
+***
+*** Image files are decoded into system memory by a pool of worker threads,
+*** so that many images can be decoded at once before being loaded. Only the
+*** upload of the decoded pixels into a texture sheet is then left to the
+*** main thread.
+*** ***************************************************************************/
+
+#ifndef __IMAGE_DECODER_HEADER__
+#define __IMAGE_DECODER_HEADER__
+
+#include "image_base.h"
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+/** ****************************************************************************
+*** \brief Decodes batches of image files in worker threads
+***
+*** The image files are queued by batches, and decoded by the worker threads
+*** in the queue order. The decoded images are then taken one by one when
+*** their file is loaded, or all together once their batch is finished.
+***
+*** The thread waiting for an image or a batch decodes the queued images it
+*** waits for itself rather than staying idle, so that the images are also
+*** decoded when the worker threads couldn't be created.
+***
+*** \note The decoding uses ImageMemory::DecodeImage(), which doesn't rely on
+*** any other engine. The public methods must only be called by the main thread.
+*** ***************************************************************************/
+class ImageDecoder
+{
+public:
+    ImageDecoder();
+
+    //! \brief Stops the worker threads and frees the images which weren't taken.
+    ~ImageDecoder();
+
+    /** \brief Queues image files to be decoded
+    *** \param filenames The image files to decode.
+    *** \return The handle of the batch, never 0.
+    ***
+    *** The worker threads are started by the first batch.
+    **/
+    uint32 AddBatch(const std::vector<std::string> &filenames);
+
+    //! \brief Returns true while some images of the given batch aren't decoded yet.
+    bool IsDecoding(uint32 batch);
+
+    /** \brief Gives the next decoded image of a batch, waiting for it if needed
+    *** \param batch The handle of the batch.
+    *** \param filename Set to the image file.
+    *** \param image The image data to fill, whose pixels must be freed by the caller.
+    *** \return False once every image of the batch was given. The images which
+    *** couldn't be decoded are skipped, and the ones already taken with
+    *** TakeImage() aren't given again.
+    **/
+    bool TakeBatchImage(uint32 batch, std::string &filename, ImageMemory &image);
+
+    /** \brief Removes the images of a batch from the queue, and frees the decoded ones
+    *** \param batch The handle of the batch.
+    **/
+    void DiscardBatch(uint32 batch);
+
+    /** \brief Gives the decoded image of a file, if it was queued in any batch
+    *** \param filename The image file to load.
+    *** \param image The image data to fill, whose pixels must be freed by the caller.
+    *** \return True if the decoded image was found, false otherwise.
+    ***
+    *** This waits for the image if it is being decoded.
+    **/
+    bool TakeImage(const std::string &filename, ImageMemory &image);
+
+private:
+    //! \brief The decoding state of an image file.
+    enum DECODE_STATE {
+        DECODE_QUEUED = 0,
+        DECODE_RUNNING = 1,
+        DECODE_DONE = 2
+    };
+
+    //! \brief An image file to decode.
+    struct DecodeJob {
+        std::string filename;
+        uint32 batch;
+        DECODE_STATE state;
+        bool success;
+        ImageMemory image;
+    };
+
+    //! \brief The images not taken yet, in the queue order.
+    std::list<DecodeJob *> _jobs;
+
+    //! \brief The handle of the next batch.
+    uint32 _next_batch;
+
+    //! \brief The worker threads, whether they were started, and whether they must stop.
+    std::vector<Thread *> _threads;
+    bool _threads_started;
+    bool _quit;
+
+#if (THREAD_TYPE == SDL_THREADS)
+    //! \brief Protects the jobs list and states.
+    SDL_mutex *_lock;
+
+    //! \brief Signaled when a job is queued, and when a job is done.
+    SDL_cond *_job_queued;
+    SDL_cond *_job_done;
+#endif
+
+    //! \brief Starts the worker threads, depending on the number of processors.
+    void _StartThreads();
+
+    /** \brief Decodes a queued job, the lock being held
+    *** The lock is released during the decoding itself.
+    **/
+    void _RunJob(DecodeJob *job);
+
+    //! \brief Waits for a job to be done, decoding it when still queued, the lock being held.
+    void _WaitForJob(DecodeJob *job);
+
+    //! \brief Frees the image of a job and deletes it.
+    static void _DeleteJob(DecodeJob *job);
+
+    //! \brief Decodes the queued jobs until the decoder quits.
+    void _Work();
+
+    //! \brief The worker threads function.
+    static int _WorkerThread(void *decoder_ptr);
+}; // class ImageDecoder
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __IMAGE_DECODER_HEADER__
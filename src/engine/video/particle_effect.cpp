@@ -23,6 +23,7 @@
 
 #include "engine/script/script_read.h"
 #include "engine/system.h"
+#include "engine/profiler.h"
 
 #include "utils/utils_files.h"
 
@@ -404,6 +405,8 @@ bool ParticleEffect::LoadEffect(const std::string &filename)
 
 void ParticleEffect::Draw()
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_PARTICLE_DRAW);
+
     // move to the effect's location
     VideoManager->Move(_x, _y);
 
@@ -426,6 +429,8 @@ void ParticleEffect::Update()
 
 void ParticleEffect::Update(float frame_time)
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_PARTICLE_UPDATE);
+
     _age += frame_time;
     _num_particles = 0;
 
@@ -72,6 +72,10 @@ void ParticleSystem::Draw()
     if(!_alive || !_system_def->enabled || _age < _system_def->emitter._start_time)
         return;
 
+    // The particles are drawn directly, after the queued sprites.
+    VideoManager->FlushSprites();
+    VideoManager->LoadGLTransform();
+
     // set blending parameters
     if(_system_def->blend_mode == VIDEO_NO_BLEND) {
         VideoManager->DisableBlending();
@@ -79,9 +83,9 @@ void ParticleSystem::Draw()
         VideoManager->EnableBlending();
 
         if(_system_def->blend_mode == VIDEO_BLEND)
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         else
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE); // additive
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // additive
     }
 
 
@@ -115,12 +119,11 @@ void ParticleSystem::Draw()
 
     VideoManager->EnableTexture2D();
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
+    // The particles are always smoothed, the texture sheet only changing its filtering if needed.
     StillImage *id = _animation.GetFrame(_animation.GetCurrentFrameIndex());
     private_video::ImageTexture *img = id->_image_texture;
     TextureManager->_BindTexture(img->texture_sheet->tex_id);
+    img->texture_sheet->Smooth(true);
 
 
     float frame_progress = _animation.GetPercentProgress();
@@ -289,6 +292,7 @@ void ParticleSystem::Draw()
         StillImage *id2 = _animation.GetFrame(findex);
         private_video::ImageTexture *img2 = id2->_image_texture;
         TextureManager->_BindTexture(img2->texture_sheet->tex_id);
+        img2->texture_sheet->Smooth(true);
 
         u1 = img2->u1;
         u2 = img2->u2;
@@ -339,6 +343,8 @@ void ParticleSystem::Draw()
 
         glDrawArrays(GL_QUADS, 0, _num_particles * 4);
     }
+
+    VideoManager->ResetGLTransform();
 }
 
 //-----------------------------------------------------------------------------
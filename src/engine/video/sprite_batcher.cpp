@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    sprite_batcher.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the SpriteBatcher class.
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "sprite_batcher.h"
+
+#include "video.h"
+
+#include "utils/utils_numeric.h"
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+void Transform2D::Rotate(float angle)
+{
+    float radians = angle * vt_utils::UTILS_PI / 180.0f;
+    float cos_angle = cosf(radians);
+    float sin_angle = sinf(radians);
+
+    float a = _a * cos_angle + _c * sin_angle;
+    float b = _b * cos_angle + _d * sin_angle;
+    _c = _c * cos_angle - _a * sin_angle;
+    _d = _d * cos_angle - _b * sin_angle;
+    _a = a;
+    _b = b;
+}
+
+void Transform2D::GetMatrix(float matrix[16]) const
+{
+    for(uint32 i = 0; i < 16; ++i)
+        matrix[i] = 0.0f;
+
+    matrix[0] = _a;
+    matrix[1] = _b;
+    matrix[4] = _c;
+    matrix[5] = _d;
+    matrix[10] = 1.0f;
+    matrix[12] = _tx;
+    matrix[13] = _ty;
+    matrix[15] = 1.0f;
+}
+
+
+
+SpriteBatcher::SpriteBatcher():
+    _texture_sheet(NULL),
+    _smooth(false),
+    _blend(0),
+    _num_quads(0),
+    _num_draw_calls(0),
+    _frame_num_quads(0),
+    _frame_num_draw_calls(0)
+{}
+
+
+
+void SpriteBatcher::AddQuad(const float vertices[8], const float tex_coords[8], const Color *colors, bool unichrome)
+{
+    _vertices.insert(_vertices.end(), vertices, vertices + 8);
+
+    if(_texture_sheet)
+        _tex_coords.insert(_tex_coords.end(), tex_coords, tex_coords + 8);
+
+    for(uint32 i = 0; i < 4; ++i) {
+        const float *rgba = colors[unichrome ? 0 : i].GetColors();
+        _colors.insert(_colors.end(), rgba, rgba + 4);
+    }
+
+    ++_num_quads;
+}
+
+
+
+void SpriteBatcher::Flush()
+{
+    if(_vertices.empty())
+        return;
+
+    if(_blend) {
+        VideoManager->EnableBlending();
+        if(_blend == 1)
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+        else
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+    } else {
+        VideoManager->DisableBlending();
+    }
+
+    if(_texture_sheet) {
+        VideoManager->EnableTexture2D();
+        TextureManager->_BindTexture(_texture_sheet->tex_id);
+        _texture_sheet->Smooth(_smooth);
+
+        VideoManager->EnableTextureCoordArray();
+        glTexCoordPointer(2, GL_FLOAT, 0, &_tex_coords[0]);
+    } else {
+        VideoManager->DisableTexture2D();
+        // The texture coordinates pointer may be stale, and would be read for every vertex.
+        VideoManager->DisableTextureCoordArray();
+    }
+
+    VideoManager->EnableVertexArray();
+    glVertexPointer(2, GL_FLOAT, 0, &_vertices[0]);
+    VideoManager->EnableColorArray();
+    glColorPointer(4, GL_FLOAT, 0, &_colors[0]);
+
+    // The vertices were already transformed when queued, the OpenGL modelview matrix being the identity.
+    glDrawArrays(GL_QUADS, 0, _vertices.size() / 2);
+
+    ++_num_draw_calls;
+
+    _vertices.clear();
+    _tex_coords.clear();
+    _colors.clear();
+}
+
+
+
+void SpriteBatcher::EndFrame()
+{
+    _frame_num_quads = _num_quads;
+    _frame_num_draw_calls = _num_draw_calls;
+    _num_quads = 0;
+    _num_draw_calls = 0;
+}
+
+} // namespace private_video
+
+} // namespace vt_video
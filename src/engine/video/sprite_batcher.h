@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    sprite_batcher.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the SpriteBatcher class.
+***
+*** The images aren't drawn as soon as they are asked to: their quads are
+*** transformed on the CPU by the current modelview transformation and queued,
+*** and the consecutive quads using the same texture sheet, smoothing and
+*** blending are drawn together with a single draw call.
+*** ***************************************************************************/
+
+#ifndef __SPRITE_BATCHER_HEADER__
+#define __SPRITE_BATCHER_HEADER__
+
+#include "color.h"
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+class TexSheet;
+
+/** ****************************************************************************
+*** \brief A 2D affine transformation, behaving like the OpenGL modelview matrix
+***
+*** A point (x, y) is transformed into (a * x + c * y + tx, b * x + d * y + ty).
+*** As with OpenGL, each new transformation applies before the previous ones.
+***
+*** The video engine keeps its modelview transformation this way, so that the
+*** images quads are transformed on the CPU rather than by OpenGL.
+*** ***************************************************************************/
+class Transform2D
+{
+public:
+    Transform2D() {
+        SetIdentity();
+    }
+
+    void SetIdentity() {
+        _a = 1.0f;
+        _b = 0.0f;
+        _c = 0.0f;
+        _d = 1.0f;
+        _tx = 0.0f;
+        _ty = 0.0f;
+    }
+
+    //! \brief Sets the transformation from a column-major 4x4 OpenGL matrix, ignoring the z axis.
+    void SetMatrix(const float matrix[16]) {
+        _a = matrix[0];
+        _b = matrix[1];
+        _c = matrix[4];
+        _d = matrix[5];
+        _tx = matrix[12];
+        _ty = matrix[13];
+    }
+
+    void Translate(float x, float y) {
+        _tx += _a * x + _c * y;
+        _ty += _b * x + _d * y;
+    }
+
+    void Scale(float x, float y) {
+        _a *= x;
+        _b *= x;
+        _c *= y;
+        _d *= y;
+    }
+
+    //! \brief Rotates counterclockwise by the given angle in degrees, as glRotatef() does.
+    void Rotate(float angle);
+
+    //! \brief Gives the transformation as a column-major 4x4 OpenGL matrix.
+    void GetMatrix(float matrix[16]) const;
+
+    //! \brief Transforms the point (x, y) and stores the result in (out_x, out_y).
+    void Apply(float x, float y, float &out_x, float &out_y) const {
+        out_x = _a * x + _c * y + _tx;
+        out_y = _b * x + _d * y + _ty;
+    }
+
+private:
+    float _a, _b, _c, _d;
+    float _tx, _ty;
+}; // class Transform2D
+
+
+/** ****************************************************************************
+*** \brief Queues the images quads and draws them with as few draw calls as possible
+***
+*** The quads are queued as long as they share the same drawing state, and are
+*** drawn at once when the state changes or when the queue is flushed.
+***
+*** \note Anything drawing directly with OpenGL, or changing a state which
+*** isn't part of the quads one (scissoring, viewport, projection, stencil...),
+*** must flush the queue first with VideoEngine::FlushSprites(), so that the
+*** drawing order is kept.
+*** ***************************************************************************/
+class SpriteBatcher
+{
+public:
+    SpriteBatcher();
+
+    /** \brief Sets the drawing state of the next quads, drawing the queued ones first if it differs
+    *** \param texture_sheet The texture sheet of the quads, or NULL to draw plain colored quads.
+    *** \param smooth Whether the texture sheet is smoothed.
+    *** \param blend The blending: 0 for none, 1 for normal and 2 for additive blending, as in the draw context.
+    **/
+    void SetState(TexSheet *texture_sheet, bool smooth, int32 blend) {
+        if(texture_sheet == _texture_sheet && smooth == _smooth && blend == _blend)
+            return;
+
+        Flush();
+        _texture_sheet = texture_sheet;
+        _smooth = smooth;
+        _blend = blend;
+    }
+
+    /** \brief Queues a quad using the current state
+    *** \param vertices The four (x, y) vertices, already transformed.
+    *** \param tex_coords The four (u, v) texture coordinates, ignored when there is no texture sheet.
+    *** \param colors The four vertex colors, or a single one used by all of them when unichrome is true.
+    **/
+    void AddQuad(const float vertices[8], const float tex_coords[8], const Color *colors, bool unichrome);
+
+    //! \brief Draws the queued quads.
+    void Flush();
+
+    //! \brief Stores the number of quads and draw calls of the frame which ended, and resets them.
+    void EndFrame();
+
+    //! \brief Returns the number of quads and draw calls of the previous frame.
+    uint32 GetFrameQuadCount() const {
+        return _frame_num_quads;
+    }
+
+    uint32 GetFrameDrawCallCount() const {
+        return _frame_num_draw_calls;
+    }
+
+private:
+    //! \brief The drawing state of the queued quads.
+    TexSheet *_texture_sheet;
+    bool _smooth;
+    int32 _blend;
+
+    //! \brief Four (x, y) vertices per queued quad.
+    std::vector<float> _vertices;
+
+    //! \brief Four (u, v) texture coordinates per queued quad, when drawn with a texture sheet.
+    std::vector<float> _tex_coords;
+
+    //! \brief Four (r, g, b, a) vertex colors per queued quad.
+    std::vector<float> _colors;
+
+    //! \brief The number of quads and draw calls of the current frame and of the previous one.
+    uint32 _num_quads;
+    uint32 _num_draw_calls;
+    uint32 _frame_num_quads;
+    uint32 _frame_num_draw_calls;
+}; // class SpriteBatcher
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __SPRITE_BATCHER_HEADER__
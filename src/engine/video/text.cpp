@@ -27,6 +27,7 @@
 #include "video.h"
 
 #include "engine/script/script_read.h"
+#include "engine/profiler.h"
 
 // The script filename used to configure the text styles used in game.
 const std::string _font_script_filename = "dat/config/fonts.lua";
@@ -796,6 +797,8 @@ FontProperties *TextSupervisor::_GetFontProperties(const std::string &font_name)
 
 void TextSupervisor::Draw(const ustring &text, const TextStyle &style)
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_TEXT_RENDER);
+
     if(text.empty()) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "empty string was passed to function" << std::endl;
         return;
@@ -1129,14 +1132,16 @@ void TextSupervisor::_DrawTextHelper(const uint16 *const text, FontProperties *f
         return;
     }
 
-    glBlendFunc(GL_ONE, GL_ONE);
+    VideoManager->FlushSprites();
+
+    VideoManager->SetBlendFunc(GL_ONE, GL_ONE);
     VideoManager->EnableBlending();
 
     CoordSys &cs = VideoManager->_current_context.coordinate_system;
 
     _CacheGlyphs(text, fp);
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     VideoManager->EnableTexture2D();
 
     VideoManager->PushMatrix();
@@ -1154,6 +1159,9 @@ void TextSupervisor::_DrawTextHelper(const uint16 *const text, FontProperties *f
 
     VideoManager->EnableVertexArray();
     VideoManager->EnableTextureCoordArray();
+    VideoManager->DisableColorArray();
+
+    VideoManager->LoadGLTransform();
 
     GLint vertices[8];
     GLfloat tex_coords[8];
@@ -1183,6 +1191,7 @@ void TextSupervisor::_DrawTextHelper(const uint16 *const text, FontProperties *f
         TextureManager->_BindTexture(glyph_info->texture);
         if(VideoManager->CheckGLError()) {
             IF_PRINT_WARNING(VIDEO_DEBUG) << "OpenGL error detected: " << VideoManager->CreateGLErrorString() << std::endl;
+            VideoManager->ResetGLTransform();
             return;
         }
 
@@ -1203,12 +1212,13 @@ void TextSupervisor::_DrawTextHelper(const uint16 *const text, FontProperties *f
         tex_coords[6] = 0.0f;
         tex_coords[7] = 0.0f;
 
-        glColor4fv((GLfloat *)&text_color);
+        VideoManager->SetColor(text_color);
         glDrawArrays(GL_QUADS, 0, 4);
 
         xpos += glyph_info->advance;
     } // for (const uint16* glyph = text; *glyph != 0; glyph++)
 
+    VideoManager->ResetGLTransform();
     VideoManager->PopMatrix();
 } // void TextSupervisor::_DrawTextHelper(const uint16* const text, FontProperties* fp, Color color)
 
@@ -1216,6 +1226,8 @@ void TextSupervisor::_DrawTextHelper(const uint16 *const text, FontProperties *f
 
 bool TextSupervisor::_RenderText(vt_utils::ustring &string, TextStyle &style, ImageMemory &buffer)
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_TEXT_RENDER);
+
     FontProperties *fp = style.GetFontProperties();
 
     if(fp == NULL || fp->ttf_font == NULL) {
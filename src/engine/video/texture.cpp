@@ -20,6 +20,8 @@
 
 #include "video.h"
 
+#include "engine/profiler.h"
+
 using namespace vt_utils;
 
 namespace vt_video
@@ -106,6 +108,10 @@ bool TexSheet::Reload()
 
 bool TexSheet::CopyRect(int32 x, int32 y, ImageMemory &data)
 {
+    vt_system::TraceScope trace("TexSheet::CopyRect");
+
+    // The queued sprites may use the previous content of the sheet.
+    VideoManager->FlushSprites();
     TextureManager->_BindTexture(tex_id);
 
     glTexSubImage2D(
@@ -132,6 +138,8 @@ bool TexSheet::CopyRect(int32 x, int32 y, ImageMemory &data)
 
 bool TexSheet::CopyScreenRect(int32 x, int32 y, const ScreenRect &screen_rect)
 {
+    // The queued sprites must be drawn on the screen before copying it.
+    VideoManager->FlushSprites();
     TextureManager->_BindTexture(tex_id);
 
     glCopyTexSubImage2D(
@@ -158,7 +166,7 @@ bool TexSheet::CopyScreenRect(int32 x, int32 y, const ScreenRect &screen_rect)
 void TexSheet::Smooth(bool flag)
 {
     // If setting has changed, set the appropriate filtering
-    if(smoothed != flag) {
+    if(VideoManager->_IsGLStateChangeNeeded(smoothed != flag)) {
         smoothed = flag;
         GLenum filtering_type = smoothed ? GL_LINEAR : GL_NEAREST;
 
@@ -172,7 +180,7 @@ void TexSheet::Smooth(bool flag)
 
 void TexSheet::DEBUG_Draw() const
 {
-    // The vertex coordinate array to use (assumes glScale() has been appropriately set)
+    // The vertex coordinate array to use (assumes VideoEngine::Scale() has been appropriately set)
     static const float vertex_coords[] = {
         1.0f, 1.0f, // Lower right
         0.0f, 1.0f, // Lower left
@@ -189,9 +197,12 @@ void TexSheet::DEBUG_Draw() const
     };
 
     // Enable texturing and bind the texture
+    VideoManager->FlushSprites();
     VideoManager->DisableBlending();
     VideoManager->EnableTexture2D();
     TextureManager->_BindTexture(tex_id);
+    VideoManager->DisableColorArray();
+    VideoManager->SetColor(Color::white);
 
     // Enable and setup the texture coordinate array
     VideoManager->EnableTextureCoordArray();
@@ -200,7 +211,9 @@ void TexSheet::DEBUG_Draw() const
     // Use a vertex array to draw all of the vertices
     VideoManager->EnableVertexArray();
     glVertexPointer(2, GL_FLOAT, 0, vertex_coords);
+    VideoManager->LoadGLTransform();
     glDrawArrays(GL_QUADS, 0, 4);
+    VideoManager->ResetGLTransform();
 } // void TexSheet::DEBUG_Draw() const
 
 // -----------------------------------------------------------------------------
@@ -569,6 +582,17 @@ void VariableTexSheet::RemoveTexture(BaseTexture *img)
 
 
 
+uint32 VariableTexSheet::GetUsedArea()
+{
+    uint32 used_area = 0;
+    for(std::set<BaseTexture *>::iterator it = _textures.begin(); it != _textures.end(); ++it)
+        used_area += (*it)->width * (*it)->height;
+
+    return used_area;
+}
+
+
+
 void VariableTexSheet::_SetBlockProperties(BaseTexture *tex, BaseTexture *new_tex, bool free)
 {
     if(tex == NULL) {
@@ -599,6 +623,218 @@ void VariableTexSheet::_SetBlockProperties(BaseTexture *tex, BaseTexture *new_te
     }
 }
 
+// -----------------------------------------------------------------------------
+// PackedTexSheet class
+// -----------------------------------------------------------------------------
+
+PackedTexSheet::PackedTexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, TexSheetType sheet_type, bool sheet_static) :
+    TexSheet(sheet_width, sheet_height, sheet_id, sheet_type, sheet_static),
+    _used_area(0)
+{
+    // The sheet is packed at the pixel
+    _block_width = width;
+    _block_height = height;
+    _free_rects.push_back(PackedTexRect(0, 0, width, height));
+}
+
+
+
+PackedTexSheet::~PackedTexSheet()
+{
+    if(GetNumberTextures() != 0)
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "texture sheet being deleted when it has a non-zero allocated texture count: " << GetNumberTextures() << std::endl;
+}
+
+
+
+bool PackedTexSheet::AddTexture(BaseTexture *img, ImageMemory &data)
+{
+    if(InsertTexture(img) == false)
+        return false;
+
+    // Copy the pixel data for the texture over
+    if(CopyRect(img->x, img->y, data) == false) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "VIDEO ERROR: CopyRect() failed in TexSheet::AddImage()!" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+
+bool PackedTexSheet::InsertTexture(BaseTexture *img)
+{
+    if(img == NULL) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL pointer was given as function argument" << std::endl;
+        return false;
+    }
+
+    int32 w = img->width;
+    int32 h = img->height;
+
+    // Find the free rectangle leaving the smallest leftover on its shortest side,
+    // the longest side leftover breaking the ties.
+    int32 best_index = -1;
+    int32 best_short_side = width + height;
+    int32 best_long_side = width + height;
+    for(uint32 i = 0; i < _free_rects.size(); ++i) {
+        const PackedTexRect &rect = _free_rects[i];
+        if(rect.width < w || rect.height < h)
+            continue;
+
+        int32 short_side = std::min(rect.width - w, rect.height - h);
+        int32 long_side = std::max(rect.width - w, rect.height - h);
+        if(short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side)) {
+            best_index = i;
+            best_short_side = short_side;
+            best_long_side = long_side;
+        }
+    }
+
+    // There is no free rectangle large enough for this texture
+    if(best_index == -1)
+        return false;
+
+    PackedTexRect used(_free_rects[best_index].x, _free_rects[best_index].y, w, h);
+    _SplitFreeRects(used);
+    _PruneFreeRects();
+
+    // Calculate the pixel and uv coordinates for the newly inserted texture
+    img->x = used.x;
+    img->y = used.y;
+
+    float sheet_width = static_cast<float>(width);
+    float sheet_height = static_cast<float>(height);
+
+    img->u1 = static_cast<float>(img->x + 0.5f) / sheet_width;
+    img->u2 = static_cast<float>(img->x + img->width - 0.5f) / sheet_width;
+    img->v1 = static_cast<float>(img->y + 0.5f) / sheet_height;
+    img->v2 = static_cast<float>(img->y + img->height - 0.5f) / sheet_height;
+
+    img->texture_sheet = this;
+    _textures.insert(img);
+    _used_area += w * h;
+
+    return true;
+} // bool PackedTexSheet::InsertTexture(BaseTexture* img)
+
+
+
+void PackedTexSheet::RemoveTexture(BaseTexture *img)
+{
+    if(img == NULL) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "NULL pointer was given as function argument" << std::endl;
+        return;
+    }
+
+    if(_textures.erase(img) == 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "texture pointer argument was not contained within this texture sheet" << std::endl;
+        return;
+    }
+
+    _used_area -= img->width * img->height;
+
+    // An empty sheet is entirely free again, whatever the rectangles left by the previous textures.
+    if(_textures.empty()) {
+        _free_rects.clear();
+        _free_rects.push_back(PackedTexRect(0, 0, width, height));
+        return;
+    }
+
+    _free_rects.push_back(PackedTexRect(img->x, img->y, img->width, img->height));
+    _MergeFreeRects();
+    _PruneFreeRects();
+}
+
+
+
+void PackedTexSheet::_SplitFreeRects(const PackedTexRect &used)
+{
+    std::vector<PackedTexRect> new_rects;
+
+    uint32 i = 0;
+    while(i < _free_rects.size()) {
+        PackedTexRect rect = _free_rects[i];
+        if(!rect.Intersects(used)) {
+            ++i;
+            continue;
+        }
+
+        // Keep the maximal free rectangles on each side of the used one
+        if(used.x > rect.x)
+            new_rects.push_back(PackedTexRect(rect.x, rect.y, used.x - rect.x, rect.height));
+        if(used.x + used.width < rect.x + rect.width)
+            new_rects.push_back(PackedTexRect(used.x + used.width, rect.y, rect.x + rect.width - used.x - used.width, rect.height));
+        if(used.y > rect.y)
+            new_rects.push_back(PackedTexRect(rect.x, rect.y, rect.width, used.y - rect.y));
+        if(used.y + used.height < rect.y + rect.height)
+            new_rects.push_back(PackedTexRect(rect.x, used.y + used.height, rect.width, rect.y + rect.height - used.y - used.height));
+
+        _free_rects[i] = _free_rects.back();
+        _free_rects.pop_back();
+    }
+
+    _free_rects.insert(_free_rects.end(), new_rects.begin(), new_rects.end());
+}
+
+
+
+void PackedTexSheet::_MergeFreeRects()
+{
+    bool merged = true;
+    while(merged) {
+        merged = false;
+
+        for(uint32 i = 0; i < _free_rects.size() && !merged; ++i) {
+            for(uint32 j = i + 1; j < _free_rects.size(); ++j) {
+                PackedTexRect &a = _free_rects[i];
+                const PackedTexRect &b = _free_rects[j];
+
+                // Rectangles of the same width on top of each other, touching or overlapping
+                if(a.x == b.x && a.width == b.width && b.y <= a.y + a.height && a.y <= b.y + b.height) {
+                    int32 bottom = std::max(a.y + a.height, b.y + b.height);
+                    a.y = std::min(a.y, b.y);
+                    a.height = bottom - a.y;
+                }
+                // Rectangles of the same height side by side, touching or overlapping
+                else if(a.y == b.y && a.height == b.height && b.x <= a.x + a.width && a.x <= b.x + b.width) {
+                    int32 right = std::max(a.x + a.width, b.x + b.width);
+                    a.x = std::min(a.x, b.x);
+                    a.width = right - a.x;
+                } else {
+                    continue;
+                }
+
+                _free_rects.erase(_free_rects.begin() + j);
+                merged = true;
+                break;
+            }
+        }
+    }
+}
+
+
+
+void PackedTexSheet::_PruneFreeRects()
+{
+    for(uint32 i = 0; i < _free_rects.size(); ++i) {
+        uint32 j = i + 1;
+        while(j < _free_rects.size()) {
+            if(_free_rects[i].Contains(_free_rects[j])) {
+                _free_rects.erase(_free_rects.begin() + j);
+            } else if(_free_rects[j].Contains(_free_rects[i])) {
+                // The rectangle i is replaced by the larger one, which is compared again with the following ones.
+                _free_rects[i] = _free_rects[j];
+                _free_rects.erase(_free_rects.begin() + j);
+                j = i + 1;
+            } else {
+                ++j;
+            }
+        }
+    }
+}
+
 } // namespace private_video
 
 } // namespace vt_video
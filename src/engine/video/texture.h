@@ -38,6 +38,14 @@
 ***
 *** - <b>VariableTexNode</b>: represents a texture node entry for the
 *** VariableTexSheet class.
+***
+*** - <b>PackedTexSheet</b>: a texture sheet for variable-size textures, packed
+*** at the pixel by a MaxRects allocator. It wastes less space than the
+*** VariableTexSheet, and finds the place of a texture without scanning the
+*** whole sheet.
+***
+*** - <b>PackedTexRect</b>: represents a free rectangle of the PackedTexSheet
+*** class.
 *** ***************************************************************************/
 
 #ifndef __TEXTURE_HEADER__
@@ -65,8 +73,9 @@ enum TexSheetType {
     VIDEO_TEXSHEET_32x64 = 1,
     VIDEO_TEXSHEET_64x64 = 2,
     VIDEO_TEXSHEET_ANY = 3,
+    VIDEO_TEXSHEET_PACKED = 4,
 
-    VIDEO_TEXSHEET_TOTAL = 4
+    VIDEO_TEXSHEET_TOTAL = 5
 };
 
 
@@ -143,6 +152,9 @@ public:
     //! \brief Returns the number of textures that are contained on this texture sheet
     virtual uint32 GetNumberTextures() = 0;
 
+    //! \brief Returns the number of pixels of the sheet used by its textures
+    virtual uint32 GetUsedArea() = 0;
+
     /** \brief Unloads all texture memory used by OpenGL for this sheet
     *** \return Success/failure
     **/
@@ -295,6 +307,10 @@ public:
     void RestoreTexture(BaseTexture *img);
 
     uint32 GetNumberTextures();
+
+    uint32 GetUsedArea() {
+        return GetNumberTextures() * _texture_width * _texture_height;
+    }
     //@}
 
 private:
@@ -390,6 +406,8 @@ public:
     uint32 GetNumberTextures() {
         return _textures.size();
     }
+
+    uint32 GetUsedArea();
     //@}
 
 private:
@@ -411,6 +429,104 @@ private:
     void _SetBlockProperties(BaseTexture *tex, BaseTexture *new_tex, bool free);
 }; // class VariableTexSheet : public TexSheet
 
+
+/** ****************************************************************************
+*** \brief A free rectangle of a PackedTexSheet, in pixels
+*** ***************************************************************************/
+class PackedTexRect
+{
+public:
+    PackedTexRect(int32 rect_x, int32 rect_y, int32 rect_width, int32 rect_height) :
+        x(rect_x), y(rect_y), width(rect_width), height(rect_height) {}
+
+    //! \brief Returns true if the rectangle entirely contains the given one
+    bool Contains(const PackedTexRect &rect) const {
+        return rect.x >= x && rect.y >= y && rect.x + rect.width <= x + width && rect.y + rect.height <= y + height;
+    }
+
+    //! \brief Returns true if the rectangle overlaps the given one
+    bool Intersects(const PackedTexRect &rect) const {
+        return rect.x < x + width && rect.x + rect.width > x && rect.y < y + height && rect.y + rect.height > y;
+    }
+
+    int32 x, y, width, height;
+}; // class PackedTexRect
+
+
+/** ****************************************************************************
+*** \brief Used to manage texture sheets of variable image sizes, packed at the pixel
+***
+*** The sheet keeps the list of the maximal free rectangles, which may overlap
+*** each other (MaxRects algorithm). A texture is placed in the top-left corner
+*** of the free rectangle it fits best (best short side fit), and the free
+*** rectangles it overlaps are split into the maximal rectangles around it.
+***
+*** When a texture is removed, its rectangle is given back to the free list and
+*** merged with the free rectangles it is aligned with, so that the space can
+*** be used by larger textures again.
+***
+*** \note Freed textures keep their space until they are removed, so that they
+*** can always be restored.
+*** ***************************************************************************/
+class PackedTexSheet : public TexSheet
+{
+public:
+    /** \brief Constructs a new texture sheet
+    *** \param sheet_width The width of the sheet
+    *** \param sheet_height The height of the sheet
+    *** \param sheet_id The OpenGL texture ID value for the sheet
+    *** \param sheet_type The type of texture data that the texture sheet should hold
+    *** \param sheet_static Whether the sheet should be labeled static or not
+    **/
+    PackedTexSheet(int32 sheet_width, int32 sheet_height, GLuint sheet_id, TexSheetType sheet_type, bool sheet_static);
+
+    ~PackedTexSheet();
+
+    //! \name Methods inherited from TexSheet
+    //@{
+    bool AddTexture(BaseTexture *img, ImageMemory &data);
+
+    bool InsertTexture(BaseTexture *img);
+
+    void RemoveTexture(BaseTexture *img);
+
+    void FreeTexture(BaseTexture * /*img*/)
+    {}
+
+    void RestoreTexture(BaseTexture * /*img*/)
+    {}
+
+    uint32 GetNumberTextures() {
+        return _textures.size();
+    }
+
+    uint32 GetUsedArea() {
+        return _used_area;
+    }
+    //@}
+
+private:
+    //! \brief The maximal free rectangles of the sheet, which may overlap each other
+    std::vector<PackedTexRect> _free_rects;
+
+    //! \brief A set containing each texture that has been inserted into this class
+    std::set<BaseTexture *> _textures;
+
+    //! \brief The number of pixels used by the textures
+    uint32 _used_area;
+
+    /** \brief Splits the free rectangles overlapping a newly used rectangle
+    *** \param used The rectangle now used by a texture
+    **/
+    void _SplitFreeRects(const PackedTexRect &used);
+
+    //! \brief Merges the free rectangles sharing a whole edge, until none can be merged anymore
+    void _MergeFreeRects();
+
+    //! \brief Removes the free rectangles contained in another one
+    void _PruneFreeRects();
+}; // class PackedTexSheet : public TexSheet
+
 }  // namespace private_video
 
 }  // namespace vt_video
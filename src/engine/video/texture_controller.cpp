@@ -21,6 +21,8 @@
 
 #include "engine/mode_manager.h"
 #include "engine/video/video.h"
+#include "engine/video/image_decoder.h"
+#include "engine/profiler.h"
 
 using namespace vt_utils;
 using namespace vt_video::private_video;
@@ -35,6 +37,7 @@ TextureController *TextureManager = NULL;
 TextureController::TextureController() :
     debug_current_sheet(-1),
     _last_tex_id(INVALID_TEXTURE_ID),
+    _image_decoder(new ImageDecoder()),
     _debug_num_tex_switches(0)
 {}
 
@@ -56,6 +59,9 @@ TextureController::~TextureController()
     for(std::vector<TexSheet *>::iterator i = _tex_sheets.begin(); i != _tex_sheets.end(); ++i) {
         delete *i;
     }
+
+    delete _image_decoder;
+    ClearDecodedImages();
 }
 
 
@@ -75,11 +81,11 @@ bool TextureController::SingletonInitialize()
         PRINT_ERROR << "could not create default 64x64 texture sheet" << std::endl;
         return false;
     }
-    if(_CreateTexSheet(512, 512, VIDEO_TEXSHEET_ANY, true) == NULL) {
+    if(_CreateTexSheet(512, 512, VIDEO_TEXSHEET_PACKED, true) == NULL) {
         PRINT_ERROR << "could not create default static variable sized texture sheet" << std::endl;
         return false;
     }
-    if(_CreateTexSheet(512, 512, VIDEO_TEXSHEET_ANY, false) == NULL) {
+    if(_CreateTexSheet(512, 512, VIDEO_TEXSHEET_PACKED, false) == NULL) {
         PRINT_ERROR << "could not create default variable sized tex sheet" << std::endl;
         return false;
     }
@@ -169,6 +175,72 @@ bool TextureController::ReloadTextures()
 
 
 
+void TextureController::AddDecodedImage(const std::string &filename, ImageMemory &image)
+{
+    if(image.pixels == NULL)
+        return;
+
+    // Replace the previous data, which would be older.
+    std::map<std::string, ImageMemory>::iterator it = _decoded_images.find(filename);
+    if(it != _decoded_images.end()) {
+        free(it->second.pixels);
+        it->second.pixels = NULL;
+    }
+
+    _decoded_images[filename] = image;
+    image.pixels = NULL;
+}
+
+
+
+void TextureController::ClearDecodedImages()
+{
+    for(std::map<std::string, ImageMemory>::iterator it = _decoded_images.begin(); it != _decoded_images.end(); ++it) {
+        free(it->second.pixels);
+        it->second.pixels = NULL;
+    }
+    _decoded_images.clear();
+}
+
+
+
+uint32 TextureController::DecodeImages(const std::vector<std::string> &filenames)
+{
+    std::vector<std::string> decoded_filenames;
+    for(uint32 i = 0; i < filenames.size(); ++i) {
+        if(_images.find(filenames[i]) == _images.end() && _decoded_images.find(filenames[i]) == _decoded_images.end())
+            decoded_filenames.push_back(filenames[i]);
+    }
+
+    return _image_decoder->AddBatch(decoded_filenames);
+}
+
+
+
+bool TextureController::IsDecodingImages(uint32 batch)
+{
+    return _image_decoder->IsDecoding(batch);
+}
+
+
+
+void TextureController::FinishDecodingImages(uint32 batch)
+{
+    std::string filename;
+    ImageMemory image;
+    while(_image_decoder->TakeBatchImage(batch, filename, image))
+        AddDecodedImage(filename, image);
+}
+
+
+
+void TextureController::DiscardDecodedImages(uint32 batch)
+{
+    _image_decoder->DiscardBatch(batch);
+}
+
+
+
 void TextureController::DEBUG_NextTexSheet()
 {
     debug_current_sheet++;
@@ -233,7 +305,7 @@ void TextureController::DEBUG_ShowTexSheet()
     VideoManager->Move(20, 60);
     TextManager->Draw("Current Texture sheet:");
 
-    sprintf(buf, "  Sheet:   %d", debug_current_sheet);
+    sprintf(buf, "  Sheet:   %d / %d", debug_current_sheet, num_sheets);
     VideoManager->MoveRelative(0, 20);
     TextManager->Draw(buf);
 
@@ -249,6 +321,8 @@ void TextureController::DEBUG_ShowTexSheet()
         sprintf(buf, "  Type:    64x64");
     else if(sheet->type == VIDEO_TEXSHEET_ANY)
         sprintf(buf, "  Type:    Any size");
+    else if(sheet->type == VIDEO_TEXSHEET_PACKED)
+        sprintf(buf, "  Type:    Packed");
     else
         sprintf(buf, "  Type:    Unknown");
 
@@ -263,6 +337,12 @@ void TextureController::DEBUG_ShowTexSheet()
     VideoManager->MoveRelative(0, 20);
     TextManager->Draw(buf);
 
+    // The share of the sheet actually used by its textures
+    sprintf(buf, "  Used:    %d textures, %.1f%%", sheet->GetNumberTextures(),
+            100.0f * sheet->GetUsedArea() / static_cast<float>(sheet->width * sheet->height));
+    VideoManager->MoveRelative(0, 20);
+    TextManager->Draw(buf);
+
     VideoManager->PopState();
 } // void TextureController::DEBUG_ShowTexSheet()
 
@@ -270,6 +350,8 @@ void TextureController::DEBUG_ShowTexSheet()
 
 GLuint TextureController::_CreateBlankGLTexture(int32 width, int32 height)
 {
+    vt_system::TraceScope trace("TextureController::_CreateBlankGLTexture");
+
     GLuint tex_id;
     glGenTextures(1, &tex_id);
 
@@ -308,7 +390,7 @@ GLuint TextureController::_CreateBlankGLTexture(int32 width, int32 height)
 void TextureController::_BindTexture(GLuint tex_id)
 {
     // Return if this texture ID is already bound
-    if(tex_id == _last_tex_id)
+    if(!VideoManager->_IsGLStateChangeNeeded(tex_id != _last_tex_id))
         return;
 
     _last_tex_id = tex_id;
@@ -320,6 +402,8 @@ void TextureController::_BindTexture(GLuint tex_id)
 
 void TextureController::_DeleteTexture(GLuint tex_id)
 {
+    // The queued sprites may use the texture.
+    VideoManager->FlushSprites();
     glDeleteTextures(1, &tex_id);
 
     if(_last_tex_id == tex_id)
@@ -386,6 +470,8 @@ TexSheet *TextureController::_CreateTexSheet(int32 width, int32 height, TexSheet
         sheet = new FixedTexSheet(width, height, tex_id, type, is_static, 32, 64);
     else if(type == VIDEO_TEXSHEET_64x64)
         sheet = new FixedTexSheet(width, height, tex_id, type, is_static, 64, 64);
+    else if(type == VIDEO_TEXSHEET_PACKED)
+        sheet = new PackedTexSheet(width, height, tex_id, type, is_static);
     else
         sheet = new VariableTexSheet(width, height, tex_id, type, is_static);
 
@@ -455,7 +541,7 @@ TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
     else if(load_info.width == 64 && load_info.height == 64)
         type = VIDEO_TEXSHEET_64x64;
     else
-        type = VIDEO_TEXSHEET_ANY;
+        type = VIDEO_TEXSHEET_PACKED;
 
     // Look through all existing texture sheets and see if the image will fit in any of the ones which
     // match the type and static status that we are looking for
@@ -491,8 +577,27 @@ TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
 
 
 
+bool TextureController::_TakeDecodedImage(const std::string &filename, ImageMemory &image)
+{
+    std::map<std::string, ImageMemory>::iterator it = _decoded_images.find(filename);
+    if(it == _decoded_images.end())
+        return _image_decoder->TakeImage(filename, image);
+
+    image.width = it->second.width;
+    image.height = it->second.height;
+    image.rgb_format = it->second.rgb_format;
+    image.pixels = it->second.pixels;
+    it->second.pixels = NULL;
+    _decoded_images.erase(it);
+    return true;
+}
+
+
+
 bool TextureController::_ReloadImagesToSheet(TexSheet *sheet)
 {
+    vt_system::TraceScope trace("TextureController::_ReloadImagesToSheet");
+
     // Delete images
     std::map<std::string, std::pair<ImageMemory, ImageMemory> > multi_image_info;
 
@@ -36,6 +36,8 @@ namespace vt_video
 
 namespace private_video {
 class TextTexture;
+class SpriteBatcher;
+class ImageDecoder;
 }
 
 class TextureController : public vt_utils::Singleton<TextureController>
@@ -53,6 +55,8 @@ class TextureController : public vt_utils::Singleton<TextureController>
     friend class private_video::FixedTexSheet;
     friend class private_video::VariableTexSheet;
     friend class vt_mode_manager::ParticleSystem;
+    friend class ImageBatch;
+    friend class private_video::SpriteBatcher;
 
 public:
     TextureController();
@@ -76,6 +80,42 @@ public:
     **/
     bool ReloadTextures();
 
+    /** \brief Keeps an image already decoded from its file, to be used instead of reading the file again
+    *** \param filename The filename of the decoded image.
+    *** \param image The decoded image data. Its pixels are taken over by the texture controller.
+    ***
+    *** This permits to decode image files in another thread before they are actually loaded.
+    *** The decoded image is used and freed by the next load of the given file.
+    **/
+    void AddDecodedImage(const std::string &filename, private_video::ImageMemory &image);
+
+    //! \brief Frees the decoded images which weren't used by any load.
+    void ClearDecodedImages();
+
+    /** \brief Starts decoding image files in worker threads, before they are loaded
+    *** \param filenames The image files which will be loaded.
+    *** \return The handle of the decoding batch.
+    ***
+    *** The images are then loaded as usual: each load takes the decoded image of its
+    *** file, waiting for it if needed, so that only its upload into texture memory is
+    *** done by the main thread. The images already in texture memory are skipped.
+    **/
+    uint32 DecodeImages(const std::vector<std::string> &filenames);
+
+    //! \brief Returns true while some images of the given decoding batch aren't decoded yet.
+    bool IsDecodingImages(uint32 batch);
+
+    /** \brief Waits for the images of a decoding batch and keeps them as decoded images
+    *** The images are then used by the next load of their file, as with AddDecodedImage().
+    **/
+    void FinishDecodingImages(uint32 batch);
+
+    /** \brief Cancels the decoding of a batch and frees its decoded images
+    *** This should be done once the batch images are loaded, to free the images which
+    *** weren't used by any load.
+    **/
+    void DiscardDecodedImages(uint32 batch);
+
     //! \brief Cycles forward to show the next texture sheet
     void DEBUG_NextTexSheet();
 
@@ -103,6 +143,12 @@ private:
     //! \brief A STL map containing all of the images currently being managed by this class
     std::map<std::string, private_video::ImageTexture *> _images;
 
+    //! \brief The images decoded ahead of their load, indexed by filename
+    std::map<std::string, private_video::ImageMemory> _decoded_images;
+
+    //! \brief Decodes the image files of the decoding batches in worker threads
+    private_video::ImageDecoder *_image_decoder;
+
     //! \brief A STL set containing all of the text images currently being managed by this class
     std::set<private_video::TextTexture *> _text_images;
 
@@ -111,6 +157,14 @@ private:
 
     // ---------- Private methods
 
+    /** \brief Gives the image data decoded ahead for the given file, if any
+    *** This waits for the image if it is being decoded by a decoding batch.
+    *** \param filename The filename of the image to load.
+    *** \param image The image data to fill, whose pixels must be freed by the caller.
+    *** \return True if the decoded image was found, false otherwise.
+    **/
+    bool _TakeDecodedImage(const std::string &filename, private_video::ImageMemory &image);
+
     //! \name Texture Operations
     //@{
     /** \brief Creates a blank texture of the given width and height and returns integer used by OpenGL to refer to this texture. Returns 0xffffffff on failure.
@@ -21,6 +21,7 @@
 #include "engine/script/script_read.h"
 
 #include "engine/system.h"
+#include "engine/profiler.h"
 
 #include "utils/utils_strings.h"
 
@@ -73,6 +74,8 @@ VideoEngine::VideoEngine():
     _current_sample(0),
     _number_samples(0),
     _FPS_textimage(NULL),
+    _profiler_textimage(NULL),
+    _profiler_refresh_time(0),
     _gl_error_code(GL_NO_ERROR),
     _gl_blend_is_active(false),
     _gl_texture_2d_is_active(false),
@@ -82,6 +85,13 @@ VideoEngine::VideoEngine():
     _gl_vertex_array_is_activated(false),
     _gl_color_array_is_activated(false),
     _gl_texture_coord_array_is_activated(false),
+    _gl_blend_source_factor(GL_INVALID_ENUM),
+    _gl_blend_destination_factor(GL_INVALID_ENUM),
+    _gl_color_is_known(false),
+    _issued_gl_state_changes(0),
+    _elided_gl_state_changes(0),
+    _frame_issued_gl_state_changes(0),
+    _frame_elided_gl_state_changes(0),
     _viewport_x_offset(0),
     _viewport_y_offset(0),
     _viewport_width(0),
@@ -89,6 +99,7 @@ VideoEngine::VideoEngine():
     _screen_width(0),
     _screen_height(0),
     _fullscreen(false),
+    _vsync(false),
     _x_cursor(0),
     _y_cursor(0),
     _debug_info(false),
@@ -113,6 +124,8 @@ VideoEngine::VideoEngine():
                                          VIDEO_STANDARD_RES_HEIGHT);
     _current_context.scissoring_enabled = false;
 
+    _ResetGLStateCache();
+
     for(uint32 sample = 0; sample < FPS_SAMPLES; sample++)
         _fps_samples[sample] = 0;
 }
@@ -135,7 +148,7 @@ void VideoEngine::_UpdateFPS()
     //! \brief The number of samples to take if we need to play catchup with the current FPS
     const uint32 FPS_CATCHUP = 20;
 
-    uint32 frame_time = vt_system::SystemManager->GetUpdateTime();
+    uint32 frame_time = vt_system::SystemManager->GetFrameTime();
 
     // Calculate the FPS for the current frame
     uint32 current_fps = 1000;
@@ -194,6 +207,54 @@ void VideoEngine::_DrawFPS()
     PopState();
 } // void GUISystem::_DrawFPS()
 
+void VideoEngine::_UpdateProfiler()
+{
+    // Refreshing the text every frame would make it unreadable, and would be measured as text rendering.
+    _profiler_refresh_time += vt_system::SystemManager->GetFrameTime();
+    if(_profiler_textimage && _profiler_refresh_time < 500)
+        return;
+    _profiler_refresh_time = 0;
+
+    if(!_profiler_textimage)
+        _profiler_textimage = new TextImage("", TextStyle("text20", Color::white));
+
+    std::ostringstream text;
+    text.setf(std::ios::fixed);
+    text.precision(2);
+    text << "Frame times in ms (min / avg / max)";
+    for(uint32 i = 0; i < vt_system::PROFILE_TOTAL; ++i) {
+        vt_system::PROFILER_SECTION section = static_cast<vt_system::PROFILER_SECTION>(i);
+        float min_time, avg_time, max_time;
+        vt_system::GetProfilerStats(section, min_time, avg_time, max_time);
+        text << "\n" << vt_system::GetProfilerSectionName(section) << ": "
+             << min_time << " / " << avg_time << " / " << max_time;
+    }
+    text << "\nLate frames: " << vt_system::SystemManager->GetLateFrameCount()
+         << " / " << vt_system::SystemManager->GetFrameCount()
+         << ", dropped update time: " << vt_system::SystemManager->GetDroppedUpdateTime() << " ms";
+    text << "\nSprites: " << _sprite_batcher.GetFrameQuadCount() << " quads in "
+         << _sprite_batcher.GetFrameDrawCallCount() << " draw calls";
+    text << "\nGL state changes: " << _frame_issued_gl_state_changes << " issued, "
+         << _frame_elided_gl_state_changes << " elided";
+    _profiler_textimage->SetText(text.str());
+}
+
+void VideoEngine::_DrawProfiler()
+{
+    if(!_profiler_textimage)
+        return;
+
+    PushState();
+    SetStandardCoordSys();
+    SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP, VIDEO_BLEND, 0);
+    Move(10.0f, 60.0f);
+    DrawRectangle(_profiler_textimage->GetWidth() + 10.0f, _profiler_textimage->GetHeight() + 10.0f,
+                  Color(0.0f, 0.0f, 0.0f, 0.6f));
+    Move(15.0f, 65.0f);
+    _profiler_textimage->Draw();
+    PopState();
+}
+
 VideoEngine::~VideoEngine()
 {
     TextManager->SingletonDestroy();
@@ -201,6 +262,7 @@ VideoEngine::~VideoEngine()
     _default_menu_cursor.Clear();
     _rectangle_image.Clear();
     delete _FPS_textimage;
+    delete _profiler_textimage;
 
     TextureManager->SingletonDestroy();
 }
@@ -355,8 +417,16 @@ void VideoEngine::Clear()
 
 void VideoEngine::Clear(const Color& c)
 {
+    _sprite_batcher.Flush();
+    _sprite_batcher.EndFrame();
+
+    _frame_issued_gl_state_changes = _issued_gl_state_changes;
+    _frame_elided_gl_state_changes = _elided_gl_state_changes;
+    _issued_gl_state_changes = 0;
+    _elided_gl_state_changes = 0;
+
     _current_context.viewport = ScreenRect(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
-    glViewport(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
+    _SetGLViewport(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
     glClearColor(c[0], c[1], c[2], c[3]);
     glClear(GL_COLOR_BUFFER_BIT);
 
@@ -369,18 +439,25 @@ void VideoEngine::Update()
     uint32 frame_time = vt_system::SystemManager->GetUpdateTime();
 
     _screen_fader.Update(frame_time);
-
-    if (_fps_display)
-        _UpdateFPS();
 }
 
 void VideoEngine::DrawDebugInfo()
 {
+    // The debug info is refreshed once per drawn frame, as the game may be updated several times per frame.
+    if (_fps_display)
+        _UpdateFPS();
+
+    if(vt_system::IsProfilerEnabled())
+        _UpdateProfiler();
+
     if(TextureManager->debug_current_sheet >= 0)
         TextureManager->DEBUG_ShowTexSheet();
 
     if (_fps_display)
         _DrawFPS();
+
+    if(vt_system::IsProfilerEnabled())
+        _DrawProfiler();
 } // void VideoEngine::Draw()
 
 bool VideoEngine::CheckGLError() {
@@ -465,6 +542,7 @@ bool VideoEngine::ApplySettings()
     }
 
     // Clear GL state, after SDL_SetVideoMode() for OSX compatibility
+    _ResetGLStateCache();
     DisableBlending();
     DisableTexture2D();
     DisableAlphaTest();
@@ -481,6 +559,10 @@ bool VideoEngine::ApplySettings()
     _screen_height = _temp_height;
     _fullscreen = _temp_fullscreen;
 
+    // The swap control may not be honoured by the driver.
+    int swap_control = 0;
+    _vsync = (SDL_GL_GetAttribute(SDL_GL_SWAP_CONTROL, &swap_control) == 0 && swap_control > 0);
+
     _UpdateViewportMetrics();
 
     if(TextureManager)
@@ -521,12 +603,44 @@ void VideoEngine::_UpdateViewportMetrics()
     }
 }
 
+void VideoEngine::_ResetGLStateCache()
+{
+    _gl_blend_source_factor = GL_INVALID_ENUM;
+    _gl_blend_destination_factor = GL_INVALID_ENUM;
+    _gl_color_is_known = false;
+    for(uint32 i = 0; i < 4; ++i) {
+        _gl_viewport[i] = 0;
+        _gl_scissor_box[i] = 0;
+    }
+    _gl_viewport[2] = -1;
+    _gl_scissor_box[2] = -1;
+}
+
+void VideoEngine::_SetGLViewport(GLint x, GLint y, GLint width, GLint height)
+{
+    if(!_IsGLStateChangeNeeded(x != _gl_viewport[0] || y != _gl_viewport[1]
+                               || width != _gl_viewport[2] || height != _gl_viewport[3]))
+        return;
+
+    // The queued sprites must be drawn with the previous viewport.
+    _sprite_batcher.Flush();
+
+    glViewport(x, y, width, height);
+    _gl_viewport[0] = x;
+    _gl_viewport[1] = y;
+    _gl_viewport[2] = width;
+    _gl_viewport[3] = height;
+}
+
 //-----------------------------------------------------------------------------
 // VideoEngine class - Coordinate system and viewport methods
 //-----------------------------------------------------------------------------
 
 void VideoEngine::SetCoordSys(const CoordSys &coordinate_system)
 {
+    // The queued sprites must be drawn with the previous projection.
+    _sprite_batcher.Flush();
+
     _current_context.coordinate_system = coordinate_system;
 
     glMatrixMode(GL_PROJECTION);
@@ -536,6 +650,7 @@ void VideoEngine::SetCoordSys(const CoordSys &coordinate_system)
 
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
+    _transform.SetIdentity();
 }
 
 void VideoEngine::GetCurrentViewport(float &x, float &y, float &width, float &height)
@@ -561,13 +676,14 @@ void VideoEngine::SetViewport(float x, float y, float width, float height)
     _viewport_y_offset = y;
     _viewport_width = width;
     _viewport_height = height;
-    glViewport(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
+    _SetGLViewport(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
 }
 
 void VideoEngine::EnableScissoring()
 {
     _current_context.scissoring_enabled = true;
-    if(!_gl_scissor_test_is_active) {
+    if(_IsGLStateChangeNeeded(!_gl_scissor_test_is_active)) {
+        _sprite_batcher.Flush();
         glEnable(GL_SCISSOR_TEST);
         _gl_scissor_test_is_active = true;
     }
@@ -576,7 +692,8 @@ void VideoEngine::EnableScissoring()
 void VideoEngine::DisableScissoring()
 {
     _current_context.scissoring_enabled = false;
-    if(_gl_scissor_test_is_active) {
+    if(_IsGLStateChangeNeeded(_gl_scissor_test_is_active)) {
+        _sprite_batcher.Flush();
         glDisable(GL_SCISSOR_TEST);
         _gl_scissor_test_is_active = false;
     }
@@ -584,7 +701,8 @@ void VideoEngine::DisableScissoring()
 
 void VideoEngine::EnableAlphaTest()
 {
-    if(!_gl_alpha_test_is_active) {
+    if(_IsGLStateChangeNeeded(!_gl_alpha_test_is_active)) {
+        _sprite_batcher.Flush();
         glEnable(GL_ALPHA_TEST);
         _gl_alpha_test_is_active = true;
     }
@@ -592,7 +710,8 @@ void VideoEngine::EnableAlphaTest()
 
 void VideoEngine::DisableAlphaTest()
 {
-    if(_gl_alpha_test_is_active) {
+    if(_IsGLStateChangeNeeded(_gl_alpha_test_is_active)) {
+        _sprite_batcher.Flush();
         glDisable(GL_ALPHA_TEST);
         _gl_alpha_test_is_active = false;
     }
@@ -600,7 +719,7 @@ void VideoEngine::DisableAlphaTest()
 
 void VideoEngine::EnableBlending()
 {
-    if(!_gl_blend_is_active) {
+    if(_IsGLStateChangeNeeded(!_gl_blend_is_active)) {
         glEnable(GL_BLEND);
         _gl_blend_is_active = true;
     }
@@ -608,7 +727,7 @@ void VideoEngine::EnableBlending()
 
 void VideoEngine::DisableBlending()
 {
-    if(_gl_blend_is_active) {
+    if(_IsGLStateChangeNeeded(_gl_blend_is_active)) {
         glDisable(GL_BLEND);
         _gl_blend_is_active = false;
     }
@@ -616,7 +735,8 @@ void VideoEngine::DisableBlending()
 
 void VideoEngine::EnableStencilTest()
 {
-    if(!_gl_stencil_test_is_active) {
+    if(_IsGLStateChangeNeeded(!_gl_stencil_test_is_active)) {
+        _sprite_batcher.Flush();
         glEnable(GL_STENCIL_TEST);
         _gl_stencil_test_is_active = true;
     }
@@ -624,7 +744,8 @@ void VideoEngine::EnableStencilTest()
 
 void VideoEngine::DisableStencilTest()
 {
-    if(_gl_stencil_test_is_active) {
+    if(_IsGLStateChangeNeeded(_gl_stencil_test_is_active)) {
+        _sprite_batcher.Flush();
         glDisable(GL_STENCIL_TEST);
         _gl_stencil_test_is_active = false;
     }
@@ -632,7 +753,7 @@ void VideoEngine::DisableStencilTest()
 
 void VideoEngine::EnableTexture2D()
 {
-    if(!_gl_texture_2d_is_active) {
+    if(_IsGLStateChangeNeeded(!_gl_texture_2d_is_active)) {
         glEnable(GL_TEXTURE_2D);
         _gl_texture_2d_is_active = true;
     }
@@ -640,7 +761,7 @@ void VideoEngine::EnableTexture2D()
 
 void VideoEngine::DisableTexture2D()
 {
-    if(_gl_texture_2d_is_active) {
+    if(_IsGLStateChangeNeeded(_gl_texture_2d_is_active)) {
         glDisable(GL_TEXTURE_2D);
         _gl_texture_2d_is_active = false;
     }
@@ -648,7 +769,7 @@ void VideoEngine::DisableTexture2D()
 
 void VideoEngine::EnableColorArray()
 {
-    if(!_gl_color_array_is_activated) {
+    if(_IsGLStateChangeNeeded(!_gl_color_array_is_activated)) {
         glEnableClientState(GL_COLOR_ARRAY);
         _gl_color_array_is_activated = true;
     }
@@ -656,15 +777,17 @@ void VideoEngine::EnableColorArray()
 
 void VideoEngine::DisableColorArray()
 {
-    if(_gl_color_array_is_activated) {
+    if(_IsGLStateChangeNeeded(_gl_color_array_is_activated)) {
         glDisableClientState(GL_COLOR_ARRAY);
         _gl_color_array_is_activated = false;
+        // The current color is undefined after drawing with a color array.
+        _gl_color_is_known = false;
     }
 }
 
 void VideoEngine::EnableVertexArray()
 {
-    if(!_gl_vertex_array_is_activated) {
+    if(_IsGLStateChangeNeeded(!_gl_vertex_array_is_activated)) {
         glEnableClientState(GL_VERTEX_ARRAY);
         _gl_vertex_array_is_activated = true;
     }
@@ -672,7 +795,7 @@ void VideoEngine::EnableVertexArray()
 
 void VideoEngine::DisableVertexArray()
 {
-    if(_gl_vertex_array_is_activated) {
+    if(_IsGLStateChangeNeeded(_gl_vertex_array_is_activated)) {
         glDisableClientState(GL_VERTEX_ARRAY);
         _gl_vertex_array_is_activated = false;
     }
@@ -680,7 +803,7 @@ void VideoEngine::DisableVertexArray()
 
 void VideoEngine::EnableTextureCoordArray()
 {
-    if(!_gl_texture_coord_array_is_activated) {
+    if(_IsGLStateChangeNeeded(!_gl_texture_coord_array_is_activated)) {
         glEnableClientState(GL_TEXTURE_COORD_ARRAY);
         _gl_texture_coord_array_is_activated = true;
     }
@@ -688,21 +811,34 @@ void VideoEngine::EnableTextureCoordArray()
 
 void VideoEngine::DisableTextureCoordArray()
 {
-    if(_gl_texture_coord_array_is_activated) {
+    if(_IsGLStateChangeNeeded(_gl_texture_coord_array_is_activated)) {
         glDisableClientState(GL_TEXTURE_COORD_ARRAY);
         _gl_texture_coord_array_is_activated = false;
     }
 }
 
-void VideoEngine::SetScissorRect(float left, float right, float bottom, float top)
+void VideoEngine::SetBlendFunc(GLenum source_factor, GLenum destination_factor)
 {
-    _current_context.scissor_rectangle = CalculateScreenRect(left, right, bottom, top);
+    if(_IsGLStateChangeNeeded(source_factor != _gl_blend_source_factor
+                              || destination_factor != _gl_blend_destination_factor)) {
+        glBlendFunc(source_factor, destination_factor);
+        _gl_blend_source_factor = source_factor;
+        _gl_blend_destination_factor = destination_factor;
+    }
+}
 
-    glScissor(static_cast<GLint>((_current_context.scissor_rectangle.left / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-              static_cast<GLint>((_current_context.scissor_rectangle.top / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height),
-              static_cast<GLsizei>((_current_context.scissor_rectangle.width / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-              static_cast<GLsizei>((_current_context.scissor_rectangle.height / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height)
-             );
+void VideoEngine::SetColor(const Color &color)
+{
+    if(_IsGLStateChangeNeeded(!_gl_color_is_known || color != _gl_color)) {
+        glColor4fv(color.GetColors());
+        _gl_color = color;
+        _gl_color_is_known = true;
+    }
+}
+
+void VideoEngine::SetScissorRect(float left, float right, float bottom, float top)
+{
+    SetScissorRect(CalculateScreenRect(left, right, bottom, top));
 }
 
 
@@ -710,12 +846,33 @@ void VideoEngine::SetScissorRect(float left, float right, float bottom, float to
 void VideoEngine::SetScissorRect(const ScreenRect &rect)
 {
     _current_context.scissor_rectangle = rect;
+    _ApplyScissorRect();
+}
+
+
+
+void VideoEngine::_ApplyScissorRect()
+{
+    const ScreenRect &rect = _current_context.scissor_rectangle;
+    const ScreenRect &viewport = _current_context.viewport;
+    GLint box[4] = {
+        static_cast<GLint>((rect.left / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * viewport.width),
+        static_cast<GLint>((rect.top / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * viewport.height),
+        static_cast<GLsizei>((rect.width / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * viewport.width),
+        static_cast<GLsizei>((rect.height / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * viewport.height)
+    };
+
+    if(!_IsGLStateChangeNeeded(box[0] != _gl_scissor_box[0] || box[1] != _gl_scissor_box[1]
+                               || box[2] != _gl_scissor_box[2] || box[3] != _gl_scissor_box[3]))
+        return;
 
-    glScissor(static_cast<GLint>((_current_context.scissor_rectangle.left / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-              static_cast<GLint>((_current_context.scissor_rectangle.top / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height),
-              static_cast<GLsizei>((_current_context.scissor_rectangle.width / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-              static_cast<GLsizei>((_current_context.scissor_rectangle.height / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height)
-             );
+    // The queued sprites must be drawn with the previous box.
+    if(_gl_scissor_test_is_active)
+        _sprite_batcher.Flush();
+
+    glScissor(box[0], box[1], box[2], box[3]);
+    for(uint32 i = 0; i < 4; ++i)
+        _gl_scissor_box[i] = box[i];
 }
 
 
@@ -756,8 +913,8 @@ ScreenRect VideoEngine::CalculateScreenRect(float left, float right, float botto
 
 void VideoEngine::Move(float x, float y)
 {
-    glLoadIdentity();
-    glTranslatef(x, y, 0);
+    _transform.SetIdentity();
+    _transform.Translate(x, y);
     _x_cursor = x;
     _y_cursor = y;
 }
@@ -766,25 +923,30 @@ void VideoEngine::Move(float x, float y)
 
 void VideoEngine::MoveRelative(float x, float y)
 {
-    glTranslatef(x, y, 0);
+    _transform.Translate(x, y);
     _x_cursor += x;
     _y_cursor += y;
 }
 
 void VideoEngine::PushMatrix()
 {
-    glPushMatrix();
+    _transform_stack.push_back(_transform);
 }
 
 void VideoEngine::PopMatrix()
 {
-    glPopMatrix();
+    if(_transform_stack.empty()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "no transformation was pushed on the stack" << std::endl;
+        return;
+    }
+
+    _transform = _transform_stack.back();
+    _transform_stack.pop_back();
 }
 
 void VideoEngine::PushState()
 {
     // Push current modelview transformation
-    glMatrixMode(GL_MODELVIEW);
     PushMatrix();
 
     _context_stack.push(_current_context);
@@ -804,17 +966,12 @@ void VideoEngine::PopState()
     _context_stack.pop();
 
     // Restore the modelview transformation
-    glMatrixMode(GL_MODELVIEW);
     PopMatrix();
-    glViewport(_current_context.viewport.left, _current_context.viewport.top, _current_context.viewport.width, _current_context.viewport.height);
+    _SetGLViewport(_current_context.viewport.left, _current_context.viewport.top, _current_context.viewport.width, _current_context.viewport.height);
 
     if(_current_context.scissoring_enabled) {
         EnableScissoring();
-        glScissor(static_cast<GLint>((_current_context.scissor_rectangle.left / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-                  static_cast<GLint>((_current_context.scissor_rectangle.top / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height),
-                  static_cast<GLsizei>((_current_context.scissor_rectangle.width / static_cast<float>(VIDEO_STANDARD_RES_WIDTH)) * _current_context.viewport.width),
-                  static_cast<GLsizei>((_current_context.scissor_rectangle.height / static_cast<float>(VIDEO_STANDARD_RES_HEIGHT)) * _current_context.viewport.height)
-                 );
+        _ApplyScissorRect();
     } else {
         DisableScissoring();
     }
@@ -822,21 +979,31 @@ void VideoEngine::PopState()
 
 void VideoEngine::Rotate(float angle)
 {
-    glRotatef(angle, 0, 0, 1);
+    _transform.Rotate(angle);
 }
 
 void VideoEngine::Scale(float x, float y)
 {
-    glScalef(x, y, 1.0f);
+    _transform.Scale(x, y);
 }
 
 void VideoEngine::SetTransform(float matrix[16])
 {
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    _transform.SetMatrix(matrix);
+}
+
+void VideoEngine::LoadGLTransform()
+{
+    float matrix[16];
+    _transform.GetMatrix(matrix);
     glLoadMatrixf(matrix);
 }
 
+void VideoEngine::ResetGLTransform()
+{
+    glLoadIdentity();
+}
+
 void VideoEngine::DrawFadeEffect()
 {
     _screen_fader.Draw();
@@ -1006,6 +1173,8 @@ void VideoEngine::MakeScreenshot(const std::string &filename)
 {
     private_video::ImageMemory buffer;
 
+    _sprite_batcher.Flush();
+
     // Retrieve the width and height of the viewport.
     GLint viewport_dimensions[4]; // viewport_dimensions[2] is the width, [3] is the height
     glGetIntegerv(GL_VIEWPORT, viewport_dimensions);
@@ -1128,18 +1297,21 @@ void VideoEngine::DrawLine(float x1, float y1, float x2, float y2, float width,
         x1, y1,
         x2, y2
     };
+    _sprite_batcher.Flush();
     EnableBlending();
     DisableTexture2D();
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+    SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
     glPushAttrib(GL_LINE_WIDTH);
 
     glLineWidth(width);
     EnableVertexArray();
     DisableColorArray();
     DisableTextureCoordArray();
-    glColor4fv((GLfloat *)color.GetColors());
+    SetColor(color);
     glVertexPointer(2, GL_FLOAT, 0, vert_coords);
+    LoadGLTransform();
     glDrawArrays(GL_LINES, 0, 2);
+    ResetGLTransform();
 
     glPopAttrib(); // GL_LINE_WIDTH
 }
@@ -1169,8 +1341,10 @@ void VideoEngine::DrawGrid(float x, float y, float x_step, float y_step, const C
         vertices.push_back(y);
         num_vertices += 2;
     }
-    glColor4fv(&c[0]);
+    _sprite_batcher.Flush();
     DisableTexture2D();
+    DisableColorArray();
+    SetColor(c);
     EnableVertexArray();
     glVertexPointer(2, GL_FLOAT, 0, &(vertices[0]));
     glDrawArrays(GL_LINES, 0, num_vertices);
@@ -35,6 +35,7 @@
 #include "engine/video/fade.h"
 #include "engine/video/image.h"
 #include "engine/video/screen_rect.h"
+#include "engine/video/sprite_batcher.h"
 #include "engine/video/texture_controller.h"
 #include "engine/video/text.h"
 
@@ -149,6 +150,7 @@ class VideoEngine : public vt_utils::Singleton<VideoEngine>
     friend class private_video::VariableTexSheet;
 
     friend class ImageDescriptor;
+    friend class ImageBatch;
     friend class CompositeImage;
     friend class private_video::TextElement;
     friend class TextImage;
@@ -245,6 +247,11 @@ public:
         return _fullscreen;
     }
 
+    //! \brief Returns true if the buffers swap waits for the vertical synchronization
+    bool IsVSyncEnabled() const {
+        return _vsync;
+    }
+
     /** \brief sets the current resolution to the given width and height
     *** \param width new screen width
     *** \param height new screen height
@@ -282,6 +289,15 @@ public:
         return _smooth_pixel_art;
     }
 
+    //! \brief Returns the current blending draw flag: VIDEO_NO_BLEND, VIDEO_BLEND or VIDEO_BLEND_ADD
+    int32 GetBlendFlag() const {
+        if(_current_context.blend == 1)
+            return VIDEO_BLEND;
+        else if(_current_context.blend == 2)
+            return VIDEO_BLEND_ADD;
+        return VIDEO_NO_BLEND;
+    }
+
     //! \brief Returns a reference to the current coordinate system
     const CoordSys &GetCoordSys() const {
         return _current_context.coordinate_system;
@@ -355,6 +371,24 @@ public:
     void EnableTextureCoordArray();
     void DisableTextureCoordArray();
 
+    //! \brief Sets the blending factors, as glBlendFunc() does, but only if necessary.
+    void SetBlendFunc(GLenum source_factor, GLenum destination_factor);
+
+    //! \brief Sets the current vertex color, as glColor4fv() does, but only if necessary.
+    void SetColor(const Color &color);
+
+    /** \brief Returns the number of OpenGL state changes issued and elided during the previous frame
+    *** The state changes asked through the video engine and the texture controller
+    *** are elided when the state is already set.
+    **/
+    uint32 GetIssuedGLStateChanges() const {
+        return _frame_issued_gl_state_changes;
+    }
+
+    uint32 GetElidedGLStateChanges() const {
+        return _frame_elided_gl_state_changes;
+    }
+
     /** \brief Enables the scissoring effect in the video engine
     *** Scissoring is where you can specify a rectangle of the screen which is affected
     *** by rendering operations (and hence, specify what area is not affected). Make sure
@@ -441,36 +475,49 @@ public:
     ***
     *** \note This is a very expensive function call. If you only need to push
     *** the current transformation, you should use PushMatrix() and PopMatrix().
-    ***
-    *** \note The size of the stack is small (around 32 entries), so you should
-    *** try and limit the maximum number of pushed state entries so that this
-    *** limit is not exceeded
     **/
     void PushState();
 
     //! \brief Restores the most recently pushed video engine state
     void PopState();
 
-    /** \brief Rotates images counterclockwise by the specified number of radians
-    *** \param angle How many radians to perform the rotation by
-    *** \note You should understand how transformation matrices work in OpenGL
-    *** prior to using this function.
+    /** \brief Rotates images counterclockwise by the specified angle
+    *** \param angle How many degrees to perform the rotation by
     **/
     void Rotate(float angle);
 
     /** \brief Scales all subsequent image drawing calls in the horizontal and vertical direction
     *** \param x The amount of horizontal scaling to perform (0.5 for half, 1.0 for normal, 2.0 for double, etc)
     *** \param y The amount of vertical scaling to perform (0.5 for half, 1.0 for normal, 2.0 for double, etc)
-    *** \note You should understand how transformation matrices work in OpenGL
-    *** prior to using this function.
     **/
     void Scale(float x, float y);
 
-    /** \brief Sets the OpenGL transform to the contents of 4x4 matrix
-    *** \param matrix A pointer to an array of 16 float values that form a 4x4 transformation matrix
+    /** \brief Sets the current transformation to the contents of 4x4 matrix
+    *** \param matrix A pointer to an array of 16 float values that form a column-major
+    *** 4x4 transformation matrix, as used by OpenGL. Only its 2D part is kept.
     **/
     void SetTransform(float matrix[16]);
 
+    /** \brief Loads the current transformation into the OpenGL modelview matrix
+    *** The images quads are transformed on the CPU, so that the OpenGL modelview matrix
+    *** is kept as the identity. The code drawing directly with OpenGL must call it before
+    *** drawing, and ResetGLTransform() once done.
+    **/
+    void LoadGLTransform();
+
+    //! \brief Resets the OpenGL modelview matrix to the identity.
+    void ResetGLTransform();
+
+    /** \brief Draws the images queued since the last call
+    *** The images are queued to be drawn together, and must be drawn before
+    *** anything is drawn directly with OpenGL, or before a state which isn't
+    *** part of the images one (scissoring, viewport, projection, stencil...) changes.
+    *** The video engine methods changing such a state call it themselves.
+    **/
+    void FlushSprites() {
+        _sprite_batcher.Flush();
+    }
+
     // ----------  Image operation methods
 
     /** \brief Captures the contents of the screen and saves it as an image texture
@@ -684,6 +731,10 @@ private:
     //! The FPS text
     TextImage* _FPS_textimage;
 
+    //! \brief The profiler overlay text, and the time since it was last refreshed.
+    TextImage* _profiler_textimage;
+    uint32 _profiler_refresh_time;
+
     //! \brief Holds the most recently fetched OpenGL error code
     GLenum _gl_error_code;
 
@@ -704,6 +755,22 @@ private:
     bool _gl_color_array_is_activated;
     //! \brief Holds whether the GL_VERTEX_ARRAY state is activated. Used to optimize the drawing logic
     bool _gl_texture_coord_array_is_activated;
+    //! \brief Holds the current blending factors, or GL_INVALID_ENUM when unknown.
+    GLenum _gl_blend_source_factor;
+    GLenum _gl_blend_destination_factor;
+    //! \brief Holds the current vertex color, and whether it is known.
+    //! \note The current color is undefined after drawing with a color array.
+    Color _gl_color;
+    bool _gl_color_is_known;
+    //! \brief Holds the current OpenGL viewport and scissor box, in pixels. Their width is -1 when unknown.
+    GLint _gl_viewport[4];
+    GLint _gl_scissor_box[4];
+
+    //! \brief The number of OpenGL state changes issued and elided during the current frame and the previous one.
+    uint32 _issued_gl_state_changes;
+    uint32 _elided_gl_state_changes;
+    uint32 _frame_issued_gl_state_changes;
+    uint32 _frame_elided_gl_state_changes;
 
     //! \brief The x/y offsets, width and height of the current viewport (the drawn part), in pixels
     //! \note the viewport is different from the screen size when in non-4:3 modes.
@@ -719,9 +786,22 @@ private:
     //! \brief True if the game is currently running fullscreen
     bool _fullscreen;
 
+    //! \brief True if the buffers swap waits for the vertical synchronization
+    bool _vsync;
+
     //! \brief The x and y coordinates of the current draw cursor position
     float _x_cursor, _y_cursor;
 
+    /** \brief The current modelview transformation, and the pushed ones
+    *** It is applied on the CPU, so that the images quads can be transformed before
+    *** being queued in the sprite batcher, and the OpenGL matrices are left untouched.
+    **/
+    private_video::Transform2D _transform;
+    std::vector<private_video::Transform2D> _transform_stack;
+
+    //! \brief Queues the images quads to draw them with as few draw calls as possible.
+    private_video::SpriteBatcher _sprite_batcher;
+
     //! \brief Contains information about the current video engine's context, such as draw flags, the coordinate system, etc.
     private_video::Context _current_context;
 
@@ -800,11 +880,36 @@ private:
     //! \note it also centers the viewport when the resolution isn't a 4:3 one.
     void _UpdateViewportMetrics();
 
+    /** \brief Counts an OpenGL state change request
+    *** \param needed Whether the state differs from the asked one.
+    *** \return The needed value, so that the state is only changed if needed.
+    **/
+    bool _IsGLStateChangeNeeded(bool needed) {
+        if(needed)
+            ++_issued_gl_state_changes;
+        else
+            ++_elided_gl_state_changes;
+        return needed;
+    }
+
+    //! \brief Forgets the cached OpenGL state which can't be reset through the enable/disable methods.
+    void _ResetGLStateCache();
+
+    //! \brief Sets the OpenGL viewport, but only if necessary.
+    void _SetGLViewport(GLint x, GLint y, GLint width, GLint height);
+
+    //! \brief Sets the OpenGL scissor box from the current context scissor rectangle, but only if necessary.
+    void _ApplyScissorRect();
+
     // Debug info
     //! \brief Updates the FPS counter.
     void _UpdateFPS();
     //! \brief Draws the current average FPS to the screen.
     void _DrawFPS();
+    //! \brief Refreshes the profiler statistics text twice a second.
+    void _UpdateProfiler();
+    //! \brief Draws the profiler statistics to the screen.
+    void _DrawProfiler();
 }; // class VideoEngine : public vt_utils::Singleton<VideoEngine>
 
 }  // namespace vt_video
@@ -36,6 +36,7 @@
 #include "engine/mode_manager.h"
 #include "engine/video/video.h"
 #include "engine/system.h"
+#include "engine/profiler.h"
 
 #include "common/global/global.h"
 #include "common/gui/gui.h"
@@ -84,6 +85,9 @@ void BindModeCode();
 **/
 void QuitApp()
 {
+    // Write the trace events of the last frame, if any.
+    vt_system::StopTracing();
+
     // NOTE: Even if the singleton objects do not exist when this function is called, invoking the
     // static Destroy() singleton function will do no harm (it checks that the object exists before deleting it).
 
@@ -494,34 +498,61 @@ int main(int argc, char *argv[])
     try {
         // This is the main loop for the game. The loop iterates once for every frame drawn to the screen.
         while(SystemManager->NotDone()) {
-            // Update only every 10 milliseconds.
-            SDL_Delay(10);
+            SystemManager->BeginFrame();
 
-            // 1) Render the scene
-            VideoManager->Clear();
-            ModeManager->Draw();
-            ModeManager->DrawEffects();
-            ModeManager->DrawPostEffects();
-            VideoManager->DrawFadeEffect();
-            VideoManager->DrawDebugInfo();
+            // Process all new events, even when no update step is due on this frame.
+            InputManager->EventHandler();
 
-            // Swap the buffers once the draw operations are done.
-            SDL_GL_SwapBuffers();
+            // Update any streaming audio sources
+            {
+                vt_system::TraceScope trace("AudioManager::Update");
+                AudioManager->Update();
+            }
 
-            // Update timers for correct time-based movement operation
-            SystemManager->UpdateTimers();
+            // 1) Update the game by fixed steps, as many as needed to catch up with the time elapsed.
+            while(SystemManager->NotDone()) {
+                // Update timers for correct time-based movement operation
+                {
+                    vt_system::TraceScope trace("UpdateTimers");
+                    if(!SystemManager->UpdateTimers())
+                        break;
+                }
+
+                // Update video
+                VideoManager->Update();
+
+                // Update the game status
+                {
+                    vt_system::TraceScope trace("ModeManager::Update");
+                    ModeManager->Update();
+                }
+
+                // The new events are only handled once, by the first update step.
+                InputManager->ClearPressAndReleaseEvents();
+            }
 
-            // Process all new events
-            InputManager->EventHandler();
+            // 2) Render the scene, interpolated between the last two update steps where supported.
+            {
+                vt_system::TraceScope trace("Draw");
+                VideoManager->Clear();
+                ModeManager->Draw();
+                ModeManager->DrawEffects();
+                ModeManager->DrawPostEffects();
+                VideoManager->DrawFadeEffect();
+                VideoManager->DrawDebugInfo();
+                VideoManager->FlushSprites();
+            }
 
-            // Update video
-            VideoManager->Update();
+            // 3) Sleep what is left of the frame time, unless the buffers swap waits for the vertical sync.
+            SystemManager->WaitForNextFrame(VideoManager->IsVSyncEnabled());
 
-            // Update any streaming audio sources
-            AudioManager->Update();
+            // Swap the buffers once the draw operations are done.
+            {
+                vt_system::ProfilerMarker marker(vt_system::PROFILE_SWAP_BUFFERS);
+                SDL_GL_SwapBuffers();
+            }
 
-            // Update the game status
-            ModeManager->Update();
+            vt_system::EndProfilerFrame();
 
         } // while (SystemManager->NotDone())
     } catch(const Exception &e) {
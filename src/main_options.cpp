@@ -23,10 +23,13 @@
 #include "engine/script/script.h"
 #include "engine/input.h"
 #include "engine/system.h"
+#include "engine/profiler.h"
 #include "engine/mode_manager.h"
 
 #include "common/global/global.h"
 
+#include "modes/map/map_path_benchmark.h"
+
 namespace vt_battle {
 extern bool BATTLE_DEBUG;
 }
@@ -65,6 +68,19 @@ bool ParseProgramOptions(int32 &return_code, int32 argc, char **argv)
                 return_code = 1;
             }
             return false;
+        } else if(options[i] == "--benchmark-paths") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            if(BenchmarkPathFinding(options[i + 1]) == true) {
+                return_code = 0;
+            } else {
+                return_code = 1;
+            }
+            return false;
         } else if(options[i] == "-d" || options[i] == "--debug") {
             if((i + 1) >= options.size()) {
                 std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
@@ -90,6 +106,18 @@ bool ParseProgramOptions(int32 &return_code, int32 argc, char **argv)
                 return_code = 1;
             }
             return false;
+        } else if(options[i] == "-t" || options[i] == "--trace") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            if(vt_system::StartTracing(options[i + 1]) == false) {
+                return_code = 1;
+                return false;
+            }
+            i++;
         } else if(options[i] == "-r" || options[i] == "--reset") {
             if(ResetSettings() == true) {
                 return_code = 0;
@@ -148,6 +176,9 @@ void PrintUsage()
 {
     std::cout
             << "usage: "APPSHORTNAME" [options]" << std::endl
+            << "  --benchmark-paths <map> :: replays random path searches on the collision" << std::endl
+            << "                       grid of the given map data file, e.g." << std::endl
+            << "                       dat/maps/layna_forest/layna_forest_north_east_map.lua" << std::endl
             << "  --check/-c        :: checks all files for integrity" << std::endl
             << "  --debug/-d <args> :: enables debug statements in specified sections of the" << std::endl
             << "                       program, where <args> can be:" << std::endl
@@ -157,7 +188,23 @@ void PrintUsage()
             << "  --disable-audio   :: disables loading and playing audio" << std::endl
             << "  --help/-h         :: prints this help menu" << std::endl
             << "  --info/-i         :: prints information about the user's system" << std::endl
-            << "  --reset/-r        :: resets game configuration to use default settings" << std::endl;
+            << "  --reset/-r        :: resets game configuration to use default settings" << std::endl
+            << "  --trace/-t <file> :: records a timeline of the engine activity into <file>," << std::endl
+            << "                       which can be opened in chrome://tracing or Perfetto" << std::endl;
+}
+
+
+
+bool BenchmarkPathFinding(const std::string &filename)
+{
+    // The searches are timed with the SDL timer.
+    if(SDL_Init(SDL_INIT_TIMER) != 0) {
+        std::cerr << "ERROR: Unable to initialize SDL: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    atexit(SDL_Quit);
+
+    return vt_map::BenchmarkPathFinding(filename);
 }
 
 
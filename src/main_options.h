@@ -42,6 +42,12 @@ bool ParseSecondaryOptions(const std::string& vars, std::vector<std::string>& op
 //! \brief Prints out the program usage for running the program.
 void PrintUsage();
 
+/** \brief Replays random path searches on a map and prints how long the path finding methods take.
+*** \param filename The map data Lua filename.
+*** \return False if the map data couldn't be loaded.
+**/
+bool BenchmarkPathFinding(const std::string& filename);
+
 /** \brief Prints information about the user's system.
 *** \return False if an error occured while retrieving system information.
 **/
@@ -25,6 +25,7 @@
 
 #include "engine/audio/audio.h"
 #include "engine/input.h"
+#include "engine/profiler.h"
 #include "engine/mode_manager.h"
 #include "engine/script/script.h"
 #include "engine/video/video.h"
@@ -73,38 +74,76 @@ const char *DEFAULT_VICTORY_MUSIC  = "mus/Fanfare.ogg";
 const char *DEFAULT_DEFEAT_MUSIC   = "mus/Battle_lost-OGA-Mumu.ogg";
 //@}
 
+//! \brief The default battle images, used as indices in the BATTLE_MEDIA_IMAGES table.
+enum BATTLE_MEDIA_IMAGE {
+    BATTLE_MEDIA_BACKGROUND = 0,
+    BATTLE_MEDIA_STAMINA_ICON_SELECTED,
+    BATTLE_MEDIA_ATTACK_POINT_INDICATOR,
+    BATTLE_MEDIA_STAMINA_METER,
+    BATTLE_MEDIA_ACTOR_SELECTION,
+    BATTLE_MEDIA_CHARACTER_SELECTED_HIGHLIGHT,
+    BATTLE_MEDIA_CHARACTER_COMMAND_HIGHLIGHT,
+    BATTLE_MEDIA_BOTTOM_MENU,
+    BATTLE_MEDIA_CHARACTER_ACTION_BUTTONS,
+    BATTLE_MEDIA_TARGET_TYPE_ICONS,
+    BATTLE_MEDIA_STUNNED_ICON,
+    BATTLE_MEDIA_IMAGE_TOTAL
+};
+
+//! \brief Filenames of the default battle images, all decoded at once when the battle media are loaded
+const char *BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_IMAGE_TOTAL] = {
+    "img/backdrops/battle/desert_cave/desert_cave.png",
+    "img/menus/stamina_icon_selected.png",
+    "img/icons/battle/attack_point_target.png",
+    "img/menus/stamina_bar.png",
+    "img/icons/battle/character_selector.png",
+    "img/menus/battle_character_selection.png",
+    "img/menus/battle_character_command.png",
+    "img/menus/battle_bottom_menu.png",
+    "img/menus/battle_command_buttons.png",
+    "img/icons/effects/targets.png",
+    "img/icons/effects/zzz.png"
+};
+
 BattleMedia::BattleMedia()
 {
-    if(!background_image.Load("img/backdrops/battle/desert_cave/desert_cave.png"))
+    // Decode the image files at once in the texture manager worker threads,
+    // so that the loads below only have to upload them into texture memory.
+    uint32 decoding_batch = TextureManager->DecodeImages(std::vector<std::string>(BATTLE_MEDIA_IMAGES,
+                            BATTLE_MEDIA_IMAGES + BATTLE_MEDIA_IMAGE_TOTAL));
+
+    if(!background_image.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_BACKGROUND]))
         PRINT_ERROR << "failed to load default background image" << std::endl;
 
-    if(stamina_icon_selected.Load("img/menus/stamina_icon_selected.png") == false)
+    if(stamina_icon_selected.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_STAMINA_ICON_SELECTED]) == false)
         PRINT_ERROR << "failed to load stamina icon selected image" << std::endl;
 
     attack_point_indicator.SetDimensions(16.0f, 16.0f);
-    if(attack_point_indicator.LoadFromFrameGrid("img/icons/battle/attack_point_target.png",
+    if(attack_point_indicator.LoadFromFrameGrid(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_ATTACK_POINT_INDICATOR],
             std::vector<uint32>(4, 100), 1, 4) == false)
         PRINT_ERROR << "failed to load attack point indicator." << std::endl;
 
-    if(stamina_meter.Load("img/menus/stamina_bar.png") == false)
+    if(stamina_meter.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_STAMINA_METER]) == false)
         PRINT_ERROR << "failed to load time meter." << std::endl;
 
-    if(actor_selection_image.Load("img/icons/battle/character_selector.png") == false)
+    if(actor_selection_image.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_ACTOR_SELECTION]) == false)
         PRINT_ERROR << "unable to load player selector image" << std::endl;
 
-    if(character_selected_highlight.Load("img/menus/battle_character_selection.png") == false)
+    if(character_selected_highlight.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_CHARACTER_SELECTED_HIGHLIGHT]) == false)
         PRINT_ERROR << "failed to load character selection highlight image" << std::endl;
 
-    if(character_command_highlight.Load("img/menus/battle_character_command.png") == false)
+    if(character_command_highlight.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_CHARACTER_COMMAND_HIGHLIGHT]) == false)
         PRINT_ERROR << "failed to load character command highlight image" << std::endl;
 
-    if(bottom_menu_image.Load("img/menus/battle_bottom_menu.png") == false)
+    if(bottom_menu_image.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_BOTTOM_MENU]) == false)
         PRINT_ERROR << "failed to load bottom menu image" << std::endl;
 
-    if(ImageDescriptor::LoadMultiImageFromElementGrid(character_action_buttons, "img/menus/battle_command_buttons.png", 2, 5) == false)
+    if(ImageDescriptor::LoadMultiImageFromElementGrid(character_action_buttons,
+            BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_CHARACTER_ACTION_BUTTONS], 2, 5) == false)
         PRINT_ERROR << "failed to load character action buttons" << std::endl;
 
-    if(ImageDescriptor::LoadMultiImageFromElementGrid(_target_type_icons, "img/icons/effects/targets.png", 1, 8) == false)
+    if(ImageDescriptor::LoadMultiImageFromElementGrid(_target_type_icons,
+            BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_TARGET_TYPE_ICONS], 1, 8) == false)
         PRINT_ERROR << "failed to load character action buttons" << std::endl;
 
     character_HP_text.SetStyle(TextStyle("text18", Color::white));
@@ -119,8 +158,11 @@ BattleMedia::BattleMedia()
         IF_PRINT_WARNING(BATTLE_DEBUG) << "failed to load defeat music file: " << DEFAULT_DEFEAT_MUSIC << std::endl;
 
     // Load the stunned icon
-    if(!_stunned_icon.Load("img/icons/effects/zzz.png"))
+    if(!_stunned_icon.Load(BATTLE_MEDIA_IMAGES[BATTLE_MEDIA_STUNNED_ICON]))
         IF_PRINT_WARNING(BATTLE_DEBUG) << "failed to load stunned icon" << std::endl;
+
+    // Free the images which weren't used, e.g. because already in texture memory.
+    TextureManager->DiscardDecodedImages(decoding_batch);
 }
 
 
@@ -320,6 +362,21 @@ static bool CompareObjectsYCoord(BattleObject *one, BattleObject *other)
     return (one->GetYLocation() < other->GetYLocation());
 }
 
+//! \brief Decodes the images of the given animation scripts at once, in the texture manager worker threads.
+//! \return The decoding batch handle, to discard once the animations are loaded.
+static uint32 DecodeAnimationImages(const std::vector<std::string> &animation_files)
+{
+    std::vector<std::string> image_filenames;
+    for(uint32 i = 0; i < animation_files.size(); ++i) {
+        if(animation_files[i].empty())
+            continue;
+        std::string image_filename = AnimatedImage::GetAnimationScriptImage(animation_files[i]);
+        if(!image_filename.empty())
+            image_filenames.push_back(image_filename);
+    }
+    return TextureManager->DecodeImages(image_filenames);
+}
+
 void BattleMode::Update()
 {
     // Update potential battle animations
@@ -537,7 +594,13 @@ void BattleMode::AddEnemy(uint32 new_enemy_id, float position_x, float position_
         return;
     }
 
+    // Decode the enemy sprite sheets at once before the enemy loads its animations.
+    std::vector<std::string> animation_files;
+    GlobalEnemy::GetBattleAnimationFiles(new_enemy_id, animation_files);
+    uint32 decoding_batch = DecodeAnimationImages(animation_files);
+
     BattleEnemy* new_battle_enemy = new BattleEnemy(new_enemy_id);
+    TextureManager->DiscardDecodedImages(decoding_batch);
 
     // Compute a position when needed.
     if (position_x == 0.0f && position_y == 0.0f) {
@@ -757,6 +820,8 @@ bool BattleMode::isOneCharacterDead() const
 
 void BattleMode::_Initialize()
 {
+    vt_system::TraceScope trace("BattleMode::_Initialize");
+
     // Unset a possible last enemy dying sequence.
     _last_enemy_dying = false;
 
@@ -769,6 +834,19 @@ void BattleMode::_Initialize()
         return;
     }
 
+    // Decode the characters weapon and ammo sprite sheets at once before the actors load them.
+    // Their battle animations were already loaded along with the characters.
+    std::vector<std::string> animation_files;
+    for(uint32 i = 0; i < party_size; ++i) {
+        GlobalCharacter *character = active_party->GetCharacterAtIndex(i);
+        GlobalWeapon *weapon = character->GetWeaponEquipped();
+        if(!weapon)
+            continue;
+        animation_files.push_back(weapon->GetWeaponAnimationFile(character->GetID(), "idle"));
+        animation_files.push_back(weapon->GetAmmoImageFile());
+    }
+    uint32 decoding_batch = DecodeAnimationImages(animation_files);
+
     for(uint32 i = 0; i < party_size; ++i) {
         BattleCharacter *new_actor = new BattleCharacter(active_party->GetCharacterAtIndex(i));
         _character_actors.push_back(new_actor);
@@ -783,6 +861,8 @@ void BattleMode::_Initialize()
         if(new_actor->GetHitPoints() == 0)
             new_actor->ChangeState(ACTOR_STATE_DEAD);
     }
+    TextureManager->DiscardDecodedImages(decoding_batch);
+
     _command_supervisor->ConstructMenus();
 
     // Determine the origin position for all characters and enemies
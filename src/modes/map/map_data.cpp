@@ -0,0 +1,707 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_data.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the map data loading.
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "modes/map/map_data.h"
+
+#include "engine/profiler.h"
+#include "engine/system.h"
+#include "engine/video/video.h"
+#include "utils/utils_files.h"
+
+#if LUA_VERSION_NUM < 502
+# define lua_rawlen lua_objlen
+#endif
+
+using namespace vt_utils;
+using namespace vt_video;
+using namespace vt_system;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The compiled map data file identifier and version. Increase the version when changing the format.
+const char COMPILED_MAP_MAGIC[4] = { 'V', 'T', 'M', 'P' };
+const uint32 COMPILED_MAP_VERSION = 2;
+
+//! \brief Used to detect compiled files written on a machine with another byte order.
+const uint32 COMPILED_MAP_BYTE_ORDER = 0x01020304;
+
+static LAYER_TYPE getLayerType(const std::string &type)
+{
+    if(type == "ground")
+        return GROUND_LAYER;
+    else if(type == "sky")
+        return SKY_LAYER;
+    return INVALID_LAYER;
+}
+
+/** \brief A Lua state only used to read the data files, which only define tables.
+*** It is independent from the script engine one, so that any thread can use it.
+**/
+class DataFileState
+{
+public:
+    DataFileState():
+        _state(luaL_newstate())
+    {}
+
+    ~DataFileState() {
+        if(_state)
+            lua_close(_state);
+    }
+
+    lua_State *Get() {
+        return _state;
+    }
+
+private:
+    lua_State *_state;
+
+    DataFileState(const DataFileState &);
+    DataFileState &operator=(const DataFileState &);
+};
+
+//! \brief Runs a data file in the given state, so that its tables are defined.
+static bool runDataFile(lua_State *state, const std::string &filename, std::ostream &messages)
+{
+    if(luaL_loadfile(state, filename.c_str()) != 0 || lua_pcall(state, 0, 0, 0) != 0) {
+        const char *error = lua_tostring(state, -1);
+        messages << "Couldn't open the data file: " << filename << ", error message: "
+                 << (error ? error : "") << std::endl;
+        lua_pop(state, 1);
+        return false;
+    }
+    return true;
+}
+
+//! \brief Counts the values of the table at the top of the stack, as its keys may not start from 1.
+static uint32 getTableSize(lua_State *state)
+{
+    uint32 size = 0;
+    lua_pushnil(state);
+    while(lua_next(state, -2) != 0) {
+        lua_pop(state, 1);
+        ++size;
+    }
+    return size;
+}
+
+//! \brief Reads the numbers of the array at the top of the stack, or none if it isn't a table.
+template <typename T>
+static void readNumbers(lua_State *state, std::vector<T> &values)
+{
+    values.clear();
+    if(!lua_istable(state, -1))
+        return;
+
+    uint32 size = lua_rawlen(state, -1);
+    values.resize(size);
+    for(uint32 i = 0; i < size; ++i) {
+        lua_rawgeti(state, -1, i + 1);
+        values[i] = static_cast<T>(lua_tonumber(state, -1));
+        lua_pop(state, 1);
+    }
+}
+
+/** \brief Reads the image filename of a tileset definition file, or returns an empty string.
+*** The errors aren't kept, as the tileset definition files are read again and checked when loading the map.
+**/
+static std::string readTilesetImage(const std::string &filename)
+{
+    DataFileState data_state;
+    lua_State *state = data_state.Get();
+    std::ostringstream messages;
+    if(!state || !runDataFile(state, filename, messages))
+        return std::string();
+
+    lua_getglobal(state, "tileset");
+    if(!lua_istable(state, -1))
+        return std::string();
+
+    lua_getfield(state, -1, "image");
+    const char *image = lua_tostring(state, -1);
+    return image ? std::string(image) : std::string();
+}
+
+/** \brief Reads the values of a compiled map data file straight into their destination.
+*** Every read fails once the end of the file is reached, so that truncated files are detected.
+**/
+class CompiledMapReader
+{
+public:
+    CompiledMapReader(std::ifstream &file, size_t size):
+        _file(file),
+        _remaining(size)
+    {}
+
+    bool ReadUInt(uint32 &value) {
+        return ReadArray(&value, 1);
+    }
+
+    //! \brief Reads count values, and skips the padding used to keep the next values aligned on 4 bytes.
+    template <typename T>
+    bool ReadArray(T *values, size_t count) {
+        size_t length = count * sizeof(T);
+        if(!_Reserve(length))
+            return false;
+        if(length > 0)
+            _file.read(reinterpret_cast<char *>(values), length);
+        _SkipPadding(length);
+        return !_file.fail();
+    }
+
+    bool ReadString(std::string &value) {
+        uint32 length = 0;
+        if(!ReadUInt(length) || !_Reserve(length))
+            return false;
+        value.resize(length);
+        if(length > 0)
+            _file.read(&value[0], length);
+        _SkipPadding(length);
+        return !_file.fail();
+    }
+
+    bool IsAtEnd() const {
+        return _remaining == 0;
+    }
+
+private:
+    std::ifstream &_file;
+    size_t _remaining;
+
+    //! \brief Checks that the file has enough bytes left for the given length and its padding, and counts them as read.
+    bool _Reserve(size_t length) {
+        size_t padded_length = (length + 3) & ~static_cast<size_t>(3);
+        if(_remaining < padded_length)
+            return false;
+        _remaining -= padded_length;
+        return true;
+    }
+
+    void _SkipPadding(size_t length) {
+        size_t padding = ((length + 3) & ~static_cast<size_t>(3)) - length;
+        if(padding > 0)
+            _file.ignore(padding);
+    }
+};
+
+//! \brief Writes the values of a compiled map data file.
+class CompiledMapWriter
+{
+public:
+    CompiledMapWriter(std::ofstream &file):
+        _file(file)
+    {}
+
+    void WriteUInt(uint32 value) {
+        WriteArray(&value, 1);
+    }
+
+    //! \brief Writes count values, padded with zeros to keep the next values aligned on 4 bytes.
+    template <typename T>
+    void WriteArray(const T *values, size_t count) {
+        size_t length = count * sizeof(T);
+        if(length > 0)
+            _file.write(reinterpret_cast<const char *>(values), length);
+        _WritePadding(length);
+    }
+
+    void WriteString(const std::string &value) {
+        WriteUInt(value.size());
+        _file.write(value.data(), value.size());
+        _WritePadding(value.size());
+    }
+
+private:
+    std::ofstream &_file;
+
+    void _WritePadding(size_t length) {
+        static const char padding[4] = { 0, 0, 0, 0 };
+        _file.write(padding, ((length + 3) & ~static_cast<size_t>(3)) - length);
+    }
+};
+
+MapData::MapData():
+    num_tile_on_x_axis(0),
+    num_tile_on_y_axis(0),
+    num_grid_x_axis(0),
+    num_grid_y_axis(0)
+{}
+
+bool MapData::Load(const std::string &filename)
+{
+    vt_system::TraceScope trace("MapData::Load");
+
+    std::string compiled_filename = _GetCompiledFilename(filename);
+
+    // Use the compiled file when it was written from this very version of the Lua file.
+    // The stamp is taken before reading the Lua file, so that a change made meanwhile is noticed next time.
+    std::vector<uint32> source_stamp = _GetSourceStamp(filename);
+    if(!source_stamp.empty() && DoesFileExist(compiled_filename)) {
+        if(_LoadCompiledFile(compiled_filename, source_stamp))
+            return true;
+
+        if(MAP_DEBUG)
+            _messages << "Outdated or invalid compiled map data file: " << compiled_filename
+                      << ", reading back: " << filename << std::endl;
+    }
+
+    if(!_LoadLuaFile(filename))
+        return false;
+
+    if(source_stamp.empty())
+        return true;
+
+    if(!_SaveCompiledFile(compiled_filename, source_stamp)) {
+        _messages << "Couldn't write the compiled map data file: " << compiled_filename << std::endl;
+        DeleteFile(compiled_filename);
+    }
+    return true;
+}
+
+void MapData::PrintMessages()
+{
+    std::string messages = _messages.str();
+    if(messages.empty())
+        return;
+
+    PRINT_WARNING << messages;
+    _messages.str(std::string());
+}
+
+bool MapData::_LoadLuaFile(const std::string &filename)
+{
+    DataFileState data_state;
+    lua_State *state = data_state.Get();
+    if(!state || !runDataFile(state, filename, _messages))
+        return false;
+
+    lua_getglobal(state, "map_data");
+    if(!lua_istable(state, -1)) {
+        _messages << "Couldn't open table 'map_data' in: " << filename << std::endl;
+        return false;
+    }
+
+    // Load the map dimensions and tilesets
+    lua_getfield(state, -1, "num_tile_rows");
+    num_tile_on_y_axis = static_cast<uint16>(lua_tonumber(state, -1));
+    lua_getfield(state, -2, "num_tile_cols");
+    num_tile_on_x_axis = static_cast<uint16>(lua_tonumber(state, -1));
+    lua_pop(state, 2);
+
+    tileset_filenames.clear();
+    lua_getfield(state, -1, "tileset_filenames");
+    if(lua_istable(state, -1)) {
+        uint32 tilesets_number = lua_rawlen(state, -1);
+        for(uint32 i = 1; i <= tilesets_number; ++i) {
+            lua_rawgeti(state, -1, i);
+            if(lua_isstring(state, -1))
+                tileset_filenames.push_back(lua_tostring(state, -1));
+            lua_pop(state, 1);
+        }
+    }
+    lua_pop(state, 1); // tileset_filenames
+
+    lua_getfield(state, -1, "layers");
+    if(!lua_istable(state, -1)) {
+        _messages << "No 'layers' table in the map file: " << filename << std::endl;
+        return false;
+    }
+
+    // Read in the map tile indeces from all tile layers.
+    std::vector<int32> table_x_indeces; // Used to temporarily store a row of table indeces
+
+    uint32 layers_number = getTableSize(state);
+
+    // Every layer starts empty, and is ignored when drawing unless it is successfully read
+    layers.clear();
+    layers.resize(layers_number);
+    for(uint32 layer_id = 0; layer_id < layers_number; ++layer_id) {
+        layers[layer_id].layer_type = INVALID_LAYER;
+        layers[layer_id].Resize(num_tile_on_x_axis, num_tile_on_y_axis);
+    }
+
+    // layers[0]-[n]
+    for(uint32 layer_id = 0; layer_id < layers_number; ++layer_id) {
+        lua_rawgeti(state, -1, layer_id);
+        if(!lua_istable(state, -1)) {
+            lua_pop(state, 1);
+            continue;
+        }
+
+        lua_getfield(state, -1, "type");
+        const char *type = lua_tostring(state, -1);
+        LAYER_TYPE layer_type = getLayerType(type ? type : "");
+        lua_pop(state, 1);
+
+        if(layer_type == INVALID_LAYER) {
+            _messages << "Ignoring unexisting layer type: " << (type ? type : "") << " in file: " << filename << std::endl;
+            lua_pop(state, 1); // layers[layer_id]
+            continue;
+        }
+
+        layers[layer_id].layer_type = layer_type;
+
+        // Read the tile data
+        for(uint32 y = 0; y < num_tile_on_y_axis; ++y) {
+            // Check to make sure tables are of the proper size
+            lua_rawgeti(state, -1, y);
+            if(!lua_istable(state, -1)) {
+                _messages << "the layers[" << layer_id << "] table size was not equal to the number of tile rows specified by the map, "
+                          " first missing row: " << y << std::endl;
+                return false;
+            }
+
+            readNumbers(state, table_x_indeces);
+            lua_pop(state, 1);
+
+            // Check the number of columns
+            if(table_x_indeces.size() != num_tile_on_x_axis) {
+                _messages << "the layers[" << layer_id << "][" << y << "] table size was not equal to the number of tile columns specified by the map, "
+                          "should have " << num_tile_on_x_axis << " values." << std::endl;
+                return false;
+            }
+
+            for(uint32 x = 0; x < num_tile_on_x_axis; ++x) {
+                layers[layer_id].SetTile(x, y, table_x_indeces[x]);
+            }
+        }
+        lua_pop(state, 1); // layers[layer_id]
+    }
+
+    lua_pop(state, 1); // layers
+
+    lua_getfield(state, -1, "map_grid");
+    if(!lua_istable(state, -1)) {
+        _messages << "No map grid found in map file: " << filename << std::endl;
+        return false;
+    }
+
+    // Construct the collision grid, row after row
+    num_grid_y_axis = getTableSize(state);
+    num_grid_x_axis = 0;
+    collision_grid.Initialize(0, 0);
+
+    std::vector<uint32> grid_row;
+    for(uint16 y = 0; y < num_grid_y_axis; ++y) {
+        lua_rawgeti(state, -1, y);
+        readNumbers(state, grid_row);
+        lua_pop(state, 1);
+
+        if(y == 0) {
+            num_grid_x_axis = grid_row.size();
+            collision_grid.Initialize(num_grid_x_axis, num_grid_y_axis);
+        }
+        else if(grid_row.size() != num_grid_x_axis) {
+            _messages << "The map_grid[" << y << "] row size is not equal to the first row one: "
+                      << num_grid_x_axis << ", in map file: " << filename << std::endl;
+            return false;
+        }
+
+        for(uint32 x = 0; x < grid_row.size(); ++x) {
+            if(grid_row[x] > 0)
+                collision_grid.SetWall(x, y);
+        }
+    }
+
+    // The data file state is closed when leaving.
+    return true;
+}
+
+bool MapData::_LoadCompiledFile(const std::string &filename, const std::vector<uint32> &source_stamp)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if(!file)
+        return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if(size <= 0)
+        return false;
+
+    CompiledMapReader reader(file, static_cast<size_t>(size));
+    bool valid = true;
+
+    // Header
+    char magic[4];
+    uint32 version = 0;
+    uint32 byte_order = 0;
+    valid = reader.ReadArray(magic, 4) && memcmp(magic, COMPILED_MAP_MAGIC, 4) == 0
+            && reader.ReadUInt(version) && version == COMPILED_MAP_VERSION
+            && reader.ReadUInt(byte_order) && byte_order == COMPILED_MAP_BYTE_ORDER;
+
+    // The Lua file stamp, which must be the one of the current Lua file
+    std::vector<uint32> stamp(source_stamp.size(), 0);
+    if(valid)
+        valid = reader.ReadArray(&stamp[0], stamp.size()) && stamp == source_stamp;
+
+    // Dimensions and tilesets
+    uint32 value = 0;
+    if(valid && (valid = reader.ReadUInt(value)))
+        num_tile_on_x_axis = value;
+    if(valid && (valid = reader.ReadUInt(value)))
+        num_tile_on_y_axis = value;
+
+    uint32 tilesets_number = 0;
+    if(valid)
+        valid = reader.ReadUInt(tilesets_number);
+    tileset_filenames.clear();
+    for(uint32 i = 0; valid && i < tilesets_number; ++i) {
+        tileset_filenames.push_back(std::string());
+        valid = reader.ReadString(tileset_filenames.back());
+    }
+
+    // Layers
+    uint32 layers_number = 0;
+    if(valid)
+        valid = reader.ReadUInt(layers_number);
+    layers.clear();
+    for(uint32 layer_id = 0; valid && layer_id < layers_number; ++layer_id) {
+        layers.push_back(Layer());
+        Layer &layer = layers.back();
+        layer.Resize(num_tile_on_x_axis, num_tile_on_y_axis);
+
+        uint32 layer_type = INVALID_LAYER;
+        valid = reader.ReadUInt(layer_type) && layer_type <= INVALID_LAYER;
+        if(valid) {
+            layer.layer_type = static_cast<LAYER_TYPE>(layer_type);
+            std::vector<int16> &tiles = layer.GetTiles();
+            valid = tiles.empty() || reader.ReadArray(&tiles[0], tiles.size());
+        }
+    }
+
+    // Collision grid, whose wall bits are read as they are stored in memory
+    if(valid && (valid = reader.ReadUInt(value)))
+        num_grid_x_axis = value;
+    if(valid && (valid = reader.ReadUInt(value)))
+        num_grid_y_axis = value;
+    if(valid) {
+        collision_grid.Initialize(num_grid_x_axis, num_grid_y_axis);
+        std::vector<uint32> &words = collision_grid.GetWords();
+        valid = (words.empty() || reader.ReadArray(&words[0], words.size())) && reader.IsAtEnd();
+    }
+
+    return valid;
+}
+
+bool MapData::_SaveCompiledFile(const std::string &filename, const std::vector<uint32> &source_stamp) const
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file)
+        return false;
+
+    CompiledMapWriter writer(file);
+
+    // Header
+    writer.WriteArray(COMPILED_MAP_MAGIC, 4);
+    writer.WriteUInt(COMPILED_MAP_VERSION);
+    writer.WriteUInt(COMPILED_MAP_BYTE_ORDER);
+    writer.WriteArray(&source_stamp[0], source_stamp.size());
+
+    // Dimensions and tilesets
+    writer.WriteUInt(num_tile_on_x_axis);
+    writer.WriteUInt(num_tile_on_y_axis);
+    writer.WriteUInt(tileset_filenames.size());
+    for(uint32 i = 0; i < tileset_filenames.size(); ++i)
+        writer.WriteString(tileset_filenames[i]);
+
+    // Layers
+    writer.WriteUInt(layers.size());
+    for(uint32 layer_id = 0; layer_id < layers.size(); ++layer_id) {
+        const Layer &layer = layers[layer_id];
+        writer.WriteUInt(layer.layer_type);
+
+        const std::vector<int16> &tiles = layer.GetTiles();
+        if(!tiles.empty())
+            writer.WriteArray(&tiles[0], tiles.size());
+    }
+
+    // Collision grid, as bits
+    writer.WriteUInt(num_grid_x_axis);
+    writer.WriteUInt(num_grid_y_axis);
+    const std::vector<uint32> &words = collision_grid.GetWords();
+    if(!words.empty())
+        writer.WriteArray(&words[0], words.size());
+
+    file.close();
+    return !file.fail();
+}
+
+std::vector<uint32> MapData::_GetSourceStamp(const std::string &filename)
+{
+    std::vector<uint32> stamp;
+    time_t modification_time = GetFileModificationTime(filename);
+    if(modification_time == 0)
+        return stamp;
+
+    // The modification time and size are stored as two 32-bit words each.
+    uint64_t time = static_cast<uint64_t>(modification_time);
+    uint64_t size = GetFileSize(filename);
+    stamp.push_back(static_cast<uint32>(time));
+    stamp.push_back(static_cast<uint32>(time >> 32));
+    stamp.push_back(static_cast<uint32>(size));
+    stamp.push_back(static_cast<uint32>(size >> 32));
+    return stamp;
+}
+
+std::string MapData::_GetCompiledFilename(const std::string &filename)
+{
+    // The compiled files are stored in the user data directory, as the game data one may not be writable.
+    std::string directory = GetUserDataPath() + "maps/";
+    if(!DoesFileExist(directory))
+        MakeDirectory(directory);
+
+    // e.g.: dat/maps/layna_village/layna_village_center_map.lua -> dat_maps_layna_village_layna_village_center_map.vtmap
+    std::string name = filename;
+    std::string::size_type extension = name.rfind(".lua");
+    if(extension != std::string::npos)
+        name.erase(extension);
+    for(uint32 i = 0; i < name.size(); ++i) {
+        if(name[i] == '/' || name[i] == '\\' || name[i] == ':')
+            name[i] = '_';
+    }
+    return directory + name + ".vtmap";
+}
+
+MapPreloader::MapPreloader() :
+    _map_data_loaded(false),
+    _thread(NULL),
+    _lock(NULL),
+    _loading_done(false),
+    _decoding_started(false),
+    _decoding_batch(0)
+{}
+
+MapPreloader::~MapPreloader()
+{
+    // The files being read can't be interrupted.
+    if(_thread)
+        SystemManager->WaitForThread(_thread);
+    if(_lock)
+        SystemManager->DestroySemaphore(_lock);
+
+    if(_decoding_batch)
+        TextureManager->DiscardDecodedImages(_decoding_batch);
+}
+
+void MapPreloader::Start(const std::string &filename)
+{
+    if(!_filename.empty()) {
+        PRINT_WARNING << "The map preloading was already started." << std::endl;
+        return;
+    }
+
+    _filename = filename;
+
+#if (THREAD_TYPE == SDL_THREADS)
+    _lock = SystemManager->CreateSemaphore(1);
+    if(_lock)
+        _thread = SDL_CreateThread(_LoadingThread, this);
+
+    if(_thread)
+        return;
+    PRINT_WARNING << "Unable to create the map preloading thread: " << SDL_GetError() << std::endl;
+#endif
+
+    _Load();
+    _loading_done = true;
+}
+
+void MapPreloader::Update()
+{
+    if(_decoding_started)
+        return;
+
+    bool loading_done = true;
+    if(_thread) {
+        SystemManager->LockThread(_lock);
+        loading_done = _loading_done;
+        SystemManager->UnlockThread(_lock);
+    }
+
+    if(loading_done)
+        _StartDecoding();
+}
+
+MapData *MapPreloader::Finish()
+{
+    if(!_decoding_started)
+        _StartDecoding();
+
+    if(_decoding_batch) {
+        TextureManager->FinishDecodingImages(_decoding_batch);
+        _decoding_batch = 0;
+    }
+
+    return _map_data_loaded ? &_map_data : NULL;
+}
+
+bool MapPreloader::IsLoading() const
+{
+    if(!_decoding_started)
+        return !_filename.empty();
+
+    return _decoding_batch && TextureManager->IsDecodingImages(_decoding_batch);
+}
+
+void MapPreloader::_Load()
+{
+    vt_system::TraceScope trace("MapPreloader::Load");
+
+    _map_data_loaded = _map_data.Load(_filename);
+    if(!_map_data_loaded)
+        return;
+
+    // Only the tileset images are needed to start decoding them.
+    for(uint32 i = 0; i < _map_data.tileset_filenames.size(); ++i) {
+        std::string image_filename = readTilesetImage(_map_data.tileset_filenames[i]);
+        if(!image_filename.empty())
+            _image_filenames.push_back(image_filename);
+    }
+}
+
+void MapPreloader::_StartDecoding()
+{
+    _decoding_started = true;
+
+    if(_thread) {
+        SystemManager->WaitForThread(_thread);
+        _thread = NULL;
+    }
+
+    _map_data.PrintMessages();
+    if(_map_data_loaded)
+        _decoding_batch = TextureManager->DecodeImages(_image_filenames);
+}
+
+int MapPreloader::_LoadingThread(void *preloader_ptr)
+{
+    MapPreloader *preloader = static_cast<MapPreloader *>(preloader_ptr);
+    preloader->_Load();
+    vt_system::ReleaseTraceBuffer();
+
+    SystemManager->LockThread(preloader->_lock);
+    preloader->_loading_done = true;
+    SystemManager->UnlockThread(preloader->_lock);
+    return 0;
+}
+
+} // namespace private_map
+
+} // namespace vt_map
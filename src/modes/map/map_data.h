@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_data.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the map data loading.
+***
+*** The map data files (*_map.lua) store the map dimensions, tilesets, tile
+*** layers and collision grid as Lua tables, which are slow to parse element
+*** by element. The first time a map data file is loaded, its content is
+*** compiled into a binary file (*.vtmap) saved in the user data directory,
+*** whose arrays are then read in bulk by the next loads, as long as the Lua
+*** file modification time and size are the ones recorded in it.
+***
+*** The data files only define tables, and are read in a Lua state of their
+*** own rather than in the script engine one, so that the map data can be
+*** preloaded by another thread, along with the decoded tileset images, while
+*** the previous map is fading out.
+*** ***************************************************************************/
+
+#ifndef __MAP_DATA_HEADER__
+#define __MAP_DATA_HEADER__
+
+#include "modes/map/map_tiles.h"
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+/** ****************************************************************************
+*** \brief The content of a map data file
+***
+*** The supervisors take their part of the data from this class when the map
+*** is loaded.
+*** ***************************************************************************/
+class MapData
+{
+public:
+    MapData();
+
+    /** \brief Loads the map data from the compiled file if up to date, or from the Lua file
+    *** \param filename The map data Lua filename (e.g. "dat/maps/layna_village/layna_village_center_map.lua")
+    *** \return False if the data couldn't be loaded.
+    ***
+    *** When the data is read from the Lua file, the compiled file is written again.
+    *** This doesn't rely on any engine, so that it can be called by any thread.
+    **/
+    bool Load(const std::string &filename);
+
+    /** \brief Prints the errors and warnings met by the last load.
+    *** They are kept until then as the data may be loaded by another thread than the main one.
+    **/
+    void PrintMessages();
+
+    //! \brief The number of tile columns and rows of the map.
+    uint16 num_tile_on_x_axis;
+    uint16 num_tile_on_y_axis;
+
+    //! \brief The tileset definition filenames used by the map.
+    std::vector<std::string> tileset_filenames;
+
+    /** \brief The map tile layers.
+    *** The tile ids are the ones of the map file: the tileset index * TILES_PER_TILESET
+    *** plus the tile index in the tileset, or -1 when there is no tile.
+    *** The layers which couldn't be read are kept empty with the INVALID_LAYER type.
+    **/
+    std::vector<Layer> layers;
+
+    //! \brief The number of collision grid columns and rows of the map.
+    uint16 num_grid_x_axis;
+    uint16 num_grid_y_axis;
+
+    //! \brief The collision grid walls, stored as bits as in the compiled file.
+    CollisionGrid collision_grid;
+
+private:
+    //! \brief The errors and warnings not printed yet.
+    std::ostringstream _messages;
+
+    //! \brief Reads the data from the map data Lua file.
+    bool _LoadLuaFile(const std::string &filename);
+
+    /** \brief Reads the data from a compiled map data file
+    *** \param source_stamp The map data Lua file modification time and size, as given by _GetSourceStamp().
+    *** \return False if the compiled file isn't valid, or was written for another version of the Lua file.
+    **/
+    bool _LoadCompiledFile(const std::string &filename, const std::vector<uint32> &source_stamp);
+
+    //! \brief Writes the data into a compiled map data file, along with the Lua file stamp.
+    bool _SaveCompiledFile(const std::string &filename, const std::vector<uint32> &source_stamp) const;
+
+    /** \brief Gives the modification time and size of the map data Lua file, or an empty stamp if unknown.
+    *** The compiled file is only used when its recorded stamp is exactly the same.
+    **/
+    static std::vector<uint32> _GetSourceStamp(const std::string &filename);
+
+    //! \brief Gives the compiled file name used to store the given map data Lua file.
+    static std::string _GetCompiledFilename(const std::string &filename);
+}; // class MapData
+
+
+/** ****************************************************************************
+*** \brief Loads the data of a map ahead, while the previous map is still running
+***
+*** The map data file and tileset definition files are read by a thread of
+*** their own, and the tileset images are then decoded by the texture manager
+*** worker threads. Once finished, the decoded images are kept by the texture
+*** manager, so that only their upload into texture memory is left to the map
+*** mode loading.
+*** ***************************************************************************/
+class MapPreloader
+{
+public:
+    MapPreloader();
+
+    //! \brief Waits for the loading thread, cancels the decoding and frees the images which weren't given.
+    ~MapPreloader();
+
+    /** \brief Starts loading the map data and tileset definitions in a thread
+    *** \param filename The map data Lua filename
+    *** They are loaded right away when the thread can't be created.
+    **/
+    void Start(const std::string &filename);
+
+    /** \brief Starts decoding the tileset images once the loading thread is done
+    *** This should be called regularly while the map is preloaded, so that the decoding starts
+    *** as soon as possible.
+    **/
+    void Update();
+
+    /** \brief Waits for the loading thread and the tileset images decoding, and gives them to the texture manager
+    *** \return The preloaded map data, or NULL if it couldn't be loaded.
+    **/
+    MapData *Finish();
+
+    //! \brief Returns true while the map data is being loaded or the tileset images decoded.
+    bool IsLoading() const;
+
+    //! \brief Returns the preloaded map data filename.
+    const std::string &GetFilename() const {
+        return _filename;
+    }
+
+private:
+    //! \brief The preloaded map data filename.
+    std::string _filename;
+
+    //! \brief The preloaded map data, and whether it was loaded successfully.
+    MapData _map_data;
+    bool _map_data_loaded;
+
+    //! \brief The tileset images to decode, read from the tileset definition files.
+    std::vector<std::string> _image_filenames;
+
+    //! \brief The loading thread, or NULL once joined.
+    Thread *_thread;
+
+    //! \brief Protects the loading done flag, set by the loading thread.
+    Semaphore *_lock;
+    bool _loading_done;
+
+    //! \brief Whether the tileset images decoding was started, and the handle of its batch, or 0 if none.
+    bool _decoding_started;
+    uint32 _decoding_batch;
+
+    //! \brief Loads the map data and reads the tileset images filenames.
+    void _Load();
+
+    //! \brief Joins the loading thread, and starts decoding the tileset images.
+    void _StartDecoding();
+
+    //! \brief The loading thread function.
+    static int _LoadingThread(void *preloader_ptr);
+}; // class MapPreloader
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_DATA_HEADER__
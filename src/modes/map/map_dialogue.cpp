@@ -51,10 +51,18 @@ namespace private_map
 // SpriteDialogue Class Functions
 ///////////////////////////////////////////////////////////////////////////////
 
+//! \brief Returns the handle of the event group storing the seen dialogues
+static vt_utils::StringId GetDialoguesGroupHandle()
+{
+    static vt_utils::StringId dialogues_group = vt_utils::InternString("dialogues");
+    return dialogues_group;
+}
+
 SpriteDialogue::SpriteDialogue() :
     Dialogue(MapMode::CurrentInstance()->GetDialogueSupervisor()->GenerateDialogueID()),
     _input_blocked(false),
     _restore_state(true),
+    _event_handle(vt_utils::INVALID_STRING_ID),
     _dialogue_seen(false)
 {}
 
@@ -62,14 +70,16 @@ SpriteDialogue::SpriteDialogue(const std::string& dialogue_event_name) :
     Dialogue(MapMode::CurrentInstance()->GetDialogueSupervisor()->GenerateDialogueID()),
     _input_blocked(false),
     _restore_state(true),
-    _event_name(dialogue_event_name)
+    _event_name(dialogue_event_name),
+    _event_handle(vt_utils::INVALID_STRING_ID)
 {
     // Check whether the dialogue as already been seen
     _dialogue_seen = false;
     if (_event_name.empty())
         return;
 
-    int32 seen = vt_global::GlobalManager->GetEventValue("dialogues", _event_name);
+    _event_handle = vt_utils::InternString(_event_name);
+    int32 seen = vt_global::GlobalManager->GetEventValue(GetDialoguesGroupHandle(), _event_handle);
     if (seen > 0)
         _dialogue_seen = true;
 }
@@ -86,7 +96,7 @@ void SpriteDialogue::SetAsSeen(bool seen)
     if (_dialogue_seen)
         event_value = 1;
 
-    vt_global::GlobalManager->SetEventValue("dialogues", _event_name, event_value);
+    vt_global::GlobalManager->SetEventValue(GetDialoguesGroupHandle(), _event_handle, event_value);
 }
 
 void SpriteDialogue::AddLine(const std::string &text, MapSprite *speaker)
@@ -22,6 +22,8 @@
 
 #include "map_utils.h"
 
+#include "utils/utils_strings.h"
+
 namespace vt_map
 {
 
@@ -269,6 +271,9 @@ private:
     //! and coming back.
     std::string _event_name;
 
+    //! \brief The handle of the event name, used to look it up in the 'dialogues' event group
+    vt_utils::StringId _event_handle;
+
     //! \brief Tells whether the dialogue has been seen by the player.
     bool _dialogue_seen;
 
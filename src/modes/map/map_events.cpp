@@ -19,12 +19,15 @@
 #include "modes/map/map_events.h"
 
 #include "modes/map/map_mode.h"
+#include "modes/map/map_data.h"
 
 #include "modes/map/map_sprites.h"
 
 #include "modes/shop/shop.h"
 #include "modes/battle/battle.h"
 
+#include "engine/profiler.h"
+
 using namespace vt_audio;
 using namespace vt_mode_manager;
 using namespace vt_script;
@@ -160,33 +163,58 @@ MapTransitionEvent::MapTransitionEvent(const std::string &event_id,
     _transition_map_data_filename(data_filename),
     _transition_map_script_filename(script_filename),
     _transition_origin(coming_from),
-    _done(false)
+    _done(false),
+    _preloader(NULL),
+    _trigger_zone(NULL)
 {}
 
 
 
+MapTransitionEvent::~MapTransitionEvent()
+{
+    delete _preloader;
+}
+
+
+
 void MapTransitionEvent::_Start()
 {
     MapMode::CurrentInstance()->PushState(STATE_SCENE);
 
     VideoManager->_StartTransitionFadeOut(Color::black, MAP_FADE_OUT_TIME);
     _done = false;
+
+    // Load the new map data and decode its tileset images while fading out,
+    // unless the map was already prefetched when getting close to the transition zone.
+    delete _preloader;
+    _preloader = MapMode::CurrentInstance()->GetEventSupervisor()->TakePrefetchedMap(_transition_map_data_filename);
+    if(!_preloader) {
+        _preloader = new MapPreloader();
+        _preloader->Start(_transition_map_data_filename);
+    }
 }
 
 
 
 bool MapTransitionEvent::_Update()
 {
-    if(VideoManager->IsFading())
+    if(VideoManager->IsFading()) {
+        if(_preloader)
+            _preloader->Update();
         return false;
+    }
 
     // Only load the map once the fade out is done, since the load time can
     // break the fade smoothness and visible duration.
     if(!_done) {
         vt_global::GlobalManager->SetPreviousLocation(_transition_origin);
+        MapData *map_data = _preloader ? _preloader->Finish() : NULL;
         MapMode* MM = new MapMode(_transition_map_data_filename,
                                   _transition_map_script_filename,
-                                  MapMode::CurrentInstance()->GetStamina());
+                                  MapMode::CurrentInstance()->GetStamina(),
+                                  map_data);
+        delete _preloader;
+        _preloader = NULL;
         ModeManager->Pop();
         ModeManager->Push(MM, false, true);
         _done = true;
@@ -285,7 +313,9 @@ void BattleEncounterEvent::_Start()
 
 IfEvent::IfEvent(const std::string& event_id, const std::string& check_function,
                  const std::string& on_true_event, const std::string& on_false_event) :
-    MapEvent(event_id, IF_EVENT)
+    MapEvent(event_id, IF_EVENT),
+    _true_event_handle(on_true_event.empty() ? vt_utils::INVALID_STRING_ID : vt_utils::InternString(on_true_event)),
+    _false_event_handle(on_false_event.empty() ? vt_utils::INVALID_STRING_ID : vt_utils::InternString(on_false_event))
 {
     ReadScriptDescriptor &map_script = MapMode::CurrentInstance()->GetMapScript();
     if (!MapMode::CurrentInstance()->OpenMapTablespace(true))
@@ -298,9 +328,6 @@ IfEvent::IfEvent(const std::string& event_id, const std::string& check_function,
 
     map_script.CloseTable(); // map_functions
     map_script.CloseTable(); // tablespace
-
-    _true_event_id = on_true_event;
-    _false_event_id = on_false_event;
 }
 
 
@@ -315,11 +342,11 @@ void IfEvent::_Start()
         // We had a timer of 100ms her to avoid launching an event within an event
         // for the sake of the engine loop. That time is unnoticeable, anyway.
         if (ScriptCallFunction<bool>(_check_function)
-            && !_true_event_id.empty() && !events->IsEventActive(_true_event_id)) {
-            events->StartEvent(_true_event_id, 100);
+            && _true_event_handle != vt_utils::INVALID_STRING_ID && !events->IsEventActive(_true_event_handle)) {
+            events->StartEvent(_true_event_handle, 100);
         }
-        else if (!_false_event_id.empty() && !events->IsEventActive(_false_event_id)) {
-            events->StartEvent(_false_event_id, 100);
+        else if (_false_event_handle != vt_utils::INVALID_STRING_ID && !events->IsEventActive(_false_event_handle)) {
+            events->StartEvent(_false_event_handle, 100);
         }
     } catch(const luabind::error &e) {
         PRINT_ERROR << "Error while loading IFEvent check function." << std::endl;
@@ -617,6 +644,7 @@ PathMoveSpriteEvent::PathMoveSpriteEvent(const std::string &event_id, uint16 spr
     _current_node_x(0.0f),
     _current_node_y(0.0f),
     _current_node(0),
+    _path_request_id(0),
     _run(run)
 {}
 
@@ -633,6 +661,7 @@ PathMoveSpriteEvent::PathMoveSpriteEvent(const std::string &event_id, VirtualSpr
     _current_node_x(0.0f),
     _current_node_y(0.0f),
     _current_node(0),
+    _path_request_id(0),
     _run(run)
 {}
 
@@ -649,6 +678,7 @@ PathMoveSpriteEvent::PathMoveSpriteEvent(const std::string &event_id, VirtualSpr
     _current_node_x(0.0f),
     _current_node_y(0.0f),
     _current_node(0),
+    _path_request_id(0),
     _run(run)
 {}
 
@@ -656,7 +686,7 @@ PathMoveSpriteEvent::PathMoveSpriteEvent(const std::string &event_id, VirtualSpr
 
 void PathMoveSpriteEvent::SetDestination(float x_coord, float y_coord, bool run)
 {
-    if(MapMode::CurrentInstance()->GetEventSupervisor()->IsEventActive(GetEventID()) == true) {
+    if(MapMode::CurrentInstance()->GetEventSupervisor()->IsEventActive(GetEventHandle()) == true) {
         IF_PRINT_WARNING(MAP_DEBUG) << "attempted illegal operation while event was active: "
                                     << GetEventID() << std::endl;
         return;
@@ -673,7 +703,7 @@ void PathMoveSpriteEvent::SetDestination(float x_coord, float y_coord, bool run)
 
 void PathMoveSpriteEvent::SetDestination(VirtualSprite *target_sprite, bool run)
 {
-    if(MapMode::CurrentInstance()->GetEventSupervisor()->IsEventActive(GetEventID()) == true) {
+    if(MapMode::CurrentInstance()->GetEventSupervisor()->IsEventActive(GetEventHandle()) == true) {
         IF_PRINT_WARNING(MAP_DEBUG) << "attempted illegal operation while event was active: "
                                     << GetEventID() << std::endl;
         return;
@@ -711,24 +741,39 @@ void PathMoveSpriteEvent::_Start()
             && (uint32)_sprite->GetYPosition() == (uint32)_destination_y)
         return;
 
-    _path = MapMode::CurrentInstance()->GetObjectSupervisor()->FindPath(_sprite, dest);
-    if(_path.empty()) {
+    // The path is computed asynchronously and picked up in _Update().
+    _path.clear();
+    _path_request_id = MapMode::CurrentInstance()->GetObjectSupervisor()->RequestPath(_sprite, dest);
+    if(!_path_request_id) {
         PRINT_ERROR << "No path to destination (" << _destination_x
                     << ", " << _destination_y << ") for sprite: "
                     << _sprite->GetObjectID() << std::endl;
         return;
     }
-
-    _current_node_x = _path[_current_node].x;
-    _current_node_y = _path[_current_node].y;
-
-    _sprite->moving = true;
 }
 
 
 
 bool PathMoveSpriteEvent::_Update()
 {
+    if(_path_request_id) {
+        // Wait for the path to be computed.
+        if(!MapMode::CurrentInstance()->GetObjectSupervisor()->RetrievePath(_path_request_id, _path))
+            return false;
+        _path_request_id = 0;
+
+        if(_path.empty()) {
+            PRINT_ERROR << "No path to destination (" << _destination_x
+                        << ", " << _destination_y << ") for sprite: "
+                        << _sprite->GetObjectID() << std::endl;
+        }
+        else {
+            _current_node_x = _path[_current_node].x;
+            _current_node_y = _path[_current_node].y;
+            _sprite->moving = true;
+        }
+    }
+
     if(_path.empty()) {
         // No path
         Terminate();
@@ -771,6 +816,12 @@ bool PathMoveSpriteEvent::_Update()
 
 void PathMoveSpriteEvent::Terminate()
 {
+    // Discard the path being computed, if any.
+    if(_path_request_id) {
+        MapMode::CurrentInstance()->GetObjectSupervisor()->CancelPathRequest(_path_request_id);
+        _path_request_id = 0;
+    }
+
     _sprite->moving = false;
     SpriteEvent::Terminate();
 }
@@ -977,6 +1028,11 @@ void TreasureEvent::AddEvent(const std::string& event_id)
 
 EventSupervisor::~EventSupervisor()
 {
+    for(std::list<MapPreloader *>::iterator it = _prefetched_maps.begin(); it != _prefetched_maps.end(); ++it)
+        delete *it;
+    _prefetched_maps.clear();
+    _transition_events.clear();
+
     _active_events.clear();
     _paused_events.clear();
     _active_delayed_events.clear();
@@ -986,6 +1042,7 @@ EventSupervisor::~EventSupervisor()
         delete it->second;
     }
     _all_events.clear();
+    _events_by_id.clear();
 }
 
 
@@ -997,7 +1054,7 @@ void EventSupervisor::RegisterEvent(MapEvent *new_event)
         return;
     }
 
-    if(GetEvent(new_event->_event_id) != NULL) {
+    if(GetEvent(new_event->_event_handle) != NULL) {
         PRINT_WARNING << "The event with this ID already existed: '"
                       << new_event->_event_id
                       << "' in map script: "
@@ -1006,6 +1063,11 @@ void EventSupervisor::RegisterEvent(MapEvent *new_event)
     }
 
     _all_events.insert(std::make_pair(new_event->_event_id, new_event));
+
+    vt_utils::StringId event_handle = new_event->_event_handle;
+    if(event_handle >= _events_by_id.size())
+        _events_by_id.resize(event_handle + 1, NULL);
+    _events_by_id[event_handle] = new_event;
 }
 
 
@@ -1038,7 +1100,40 @@ void EventSupervisor::StartEvent(const std::string &event_id, uint32 launch_time
     if(launch_time == 0)
         StartEvent(event);
     else
-        _active_delayed_events.push_back(std::make_pair(static_cast<int32>(launch_time), event));
+        _AddDelayedEvent(event, launch_time);
+}
+
+
+
+void EventSupervisor::StartEvent(vt_utils::StringId event_id)
+{
+    MapEvent *event = GetEvent(event_id);
+    if(event == NULL) {
+        PRINT_WARNING << "No event with this ID existed: '" << vt_utils::GetInternedString(event_id)
+            << "' in map script: "
+            << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
+    }
+
+    StartEvent(event);
+}
+
+
+
+void EventSupervisor::StartEvent(vt_utils::StringId event_id, uint32 launch_time)
+{
+    MapEvent *event = GetEvent(event_id);
+    if(event == NULL) {
+        PRINT_WARNING << "No event with this ID existed: '" << vt_utils::GetInternedString(event_id)
+            << "' in map script: "
+            << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
+    }
+
+    if(launch_time == 0)
+        StartEvent(event);
+    else
+        _AddDelayedEvent(event, launch_time);
 }
 
 
@@ -1054,7 +1149,7 @@ void EventSupervisor::StartEvent(MapEvent *event, uint32 launch_time)
     if(launch_time == 0)
         StartEvent(event);
     else
-        _active_delayed_events.push_back(std::make_pair(static_cast<int32>(launch_time), event));
+        _AddDelayedEvent(event, launch_time);
 }
 
 
@@ -1075,18 +1170,16 @@ void EventSupervisor::StartEvent(MapEvent *event)
         return;
     }
 
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end(); ++it) {
-        if((*it) == event) {
-            PRINT_WARNING << "The event: '" << event->GetEventID()
-                          << "' is already active and can be active only once at a time. "
-                          << "The StartEvent() call will be ignored."
-                          << std::endl << " You should fix the map script: "
-                          << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
-            return;
-        }
+    if(event->_is_active) {
+        PRINT_WARNING << "The event: '" << event->GetEventID()
+                      << "' is already active and can be active only once at a time. "
+                      << "The StartEvent() call will be ignored."
+                      << std::endl << " You should fix the map script: "
+                      << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
     }
 
-    _active_events.push_back(event);
+    _AddActiveEvent(event);
     event->_Start();
     _ExamineEventLinks(event, true);
 }
@@ -1105,25 +1198,17 @@ void EventSupervisor::PauseEvents(const std::string &event_id)
     }
 
     // Search for active ones
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        if((*it)->_event_id == event_id) {
-            _paused_events.push_back(*it);
-            it = _active_events.erase(it);
-        } else {
-            ++it;
-        }
+    MapEvent *event = GetEvent(event_id);
+    if(event && event->_is_active) {
+        _RemoveActiveEvent(event);
+        _paused_events.push_back(event);
     }
 
     // and for the delayed ones
-    for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            _paused_delayed_events.push_back(*it);
-            it = _active_delayed_events.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    std::vector<DelayedEvent> removed_events;
+    _RemoveDelayedEvents(event_id, NULL, removed_events);
+    for(std::vector<DelayedEvent>::iterator it = removed_events.begin(); it != removed_events.end(); ++it)
+        _paused_delayed_events.push_back(std::make_pair(_GetRemainingTime(*it), it->event));
 }
 
 
@@ -1144,10 +1229,11 @@ void EventSupervisor::PauseAllEvents(VirtualSprite *sprite)
     }
 
     // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
+    for(std::list<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
         if(event && event->GetSprite() == sprite) {
             _paused_events.push_back(*it);
+            (*it)->_is_active = false;
             it = _active_events.erase(it);
         } else {
             ++it;
@@ -1155,16 +1241,10 @@ void EventSupervisor::PauseAllEvents(VirtualSprite *sprite)
     }
 
     // Looking at incoming ones.
-    for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
-        if(event && event->GetSprite() == sprite) {
-            _paused_delayed_events.push_back(*it);
-            it = _active_delayed_events.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    std::vector<DelayedEvent> removed_events;
+    _RemoveDelayedEvents(std::string(), sprite, removed_events);
+    for(std::vector<DelayedEvent>::iterator it = removed_events.begin(); it != removed_events.end(); ++it)
+        _paused_delayed_events.push_back(std::make_pair(_GetRemainingTime(*it), it->event));
 }
 
 
@@ -1183,7 +1263,7 @@ void EventSupervisor::ResumeEvents(const std::string &event_id)
     for(std::vector<MapEvent *>::iterator it = _paused_events.begin();
             it != _paused_events.end();) {
         if((*it)->_event_id == event_id) {
-            _active_events.push_back(*it);
+            _ResumePausedEvent(*it);
             it = _paused_events.erase(it);
         } else {
             ++it;
@@ -1194,7 +1274,7 @@ void EventSupervisor::ResumeEvents(const std::string &event_id)
     for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _paused_delayed_events.begin();
             it != _paused_delayed_events.end();) {
         if((*it).second->_event_id == event_id) {
-            _active_delayed_events.push_back(*it);
+            _AddDelayedEvent(it->second, it->first);
             it = _paused_delayed_events.erase(it);
         } else {
             ++it;
@@ -1223,7 +1303,7 @@ void EventSupervisor::ResumeAllEvents(VirtualSprite *sprite)
     for(std::vector<MapEvent *>::iterator it = _paused_events.begin(); it != _paused_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
         if(event && event->GetSprite() == sprite) {
-            _active_events.push_back(*it);
+            _ResumePausedEvent(*it);
             it = _paused_events.erase(it);
         } else {
             ++it;
@@ -1235,7 +1315,7 @@ void EventSupervisor::ResumeAllEvents(VirtualSprite *sprite)
             it != _paused_delayed_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
         if(event && event->GetSprite() == sprite) {
-            _active_delayed_events.push_back(*it);
+            _AddDelayedEvent(it->second, it->first);
             it = _paused_delayed_events.erase(it);
         } else {
             ++it;
@@ -1259,36 +1339,28 @@ void EventSupervisor::TerminateEvents(const std::string &event_id, bool trigger_
     }
 
     // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        if((*it)->_event_id == event_id) {
-            SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(*it);
-            // Terminated sprite events need to release their owned sprite.
-            if(sprite_event)
-                sprite_event->Terminate();
+    MapEvent *event = GetEvent(event_id);
+    if(event && event->_is_active) {
+        SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(event);
+        // Terminated sprite events need to release their owned sprite.
+        if(sprite_event)
+            sprite_event->Terminate();
 
-            MapEvent *terminated_event = *it;
-            it = _active_events.erase(it);
-            // We examine the event links only after the event has been removed from the active list
-            if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
-        } else {
-            ++it;
-        }
+        _RemoveActiveEvent(event);
+        // We examine the event links only after the event has been removed from the active list
+        if(trigger_event_links)
+            _ExamineEventLinks(event, false);
     }
 
     // Looking at incoming ones.
-    for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            MapEvent *terminated_event = (*it).second;
-            it = _active_delayed_events.erase(it);
+    // The terminated events are removed first, as examining their links may add new delayed events.
+    std::vector<DelayedEvent> terminated_events;
+    _RemoveDelayedEvents(event_id, NULL, terminated_events);
 
-            // We examine the event links only after the event has been removed from the active list
-            if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
-        } else {
-            ++it;
-        }
+    // We examine the event links only after the event has been removed from the active list
+    if(trigger_event_links) {
+        for(std::vector<DelayedEvent>::iterator it = terminated_events.begin(); it != terminated_events.end(); ++it)
+            _ExamineEventLinks(it->event, false);
     }
 
     // And paused ones
@@ -1363,12 +1435,13 @@ void EventSupervisor::TerminateAllEvents(VirtualSprite *sprite)
     }
 
     // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
+    for(std::list<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
         if(event && event->GetSprite() == sprite) {
             // Active events need to release their owned sprite upon termination.
             event->Terminate();
 
+            event->_is_active = false;
             it = _active_events.erase(it);
         } else {
             ++it;
@@ -1376,14 +1449,8 @@ void EventSupervisor::TerminateAllEvents(VirtualSprite *sprite)
     }
 
     // Looking at incoming ones.
-    for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
-        if(event && event->GetSprite() == sprite)
-            it = _active_delayed_events.erase(it);
-        else
-            ++it;
-    }
+    std::vector<DelayedEvent> removed_events;
+    _RemoveDelayedEvents(std::string(), sprite, removed_events);
 
 
     // And paused ones
@@ -1413,24 +1480,20 @@ void EventSupervisor::TerminateAllEvents(VirtualSprite *sprite)
 
 void EventSupervisor::Update()
 {
-    // Store the events that became active in the delayed event loop.
-    std::vector<MapEvent *> events_to_start;
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_EVENT_UPDATE);
 
-    // Update all launch event timers and start all events whose timers have finished
-    for(std::vector<std::pair<int32, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        it->first -= SystemManager->GetUpdateTime();
+    _current_time += SystemManager->GetUpdateTime();
 
-        if(it->first <= 0) {  // Timer has expired
-            MapEvent *start_event = it->second;
-            it = _active_delayed_events.erase(it);
+    // Store the events that became active in the delayed event loop.
+    std::vector<MapEvent *> events_to_start;
 
-            // We add the event ready to start i a vector, waiting for the loop to end
-            // before starting it.
-            events_to_start.push_back(start_event);
-        } else {
-            ++it;
-        }
+    // Take the delayed events whose launch time has been reached, in launch order.
+    while(!_active_delayed_events.empty() && _active_delayed_events.front().launch_time <= _current_time) {
+        // We add the event ready to start i a vector, waiting for the loop to end
+        // before starting it.
+        events_to_start.push_back(_active_delayed_events.front().event);
+        std::pop_heap(_active_delayed_events.begin(), _active_delayed_events.end(), DelayedEventCompare());
+        _active_delayed_events.pop_back();
     }
 
     // Starts the events that became active.
@@ -1444,12 +1507,13 @@ void EventSupervisor::Update()
     _is_updating = true;
 
     // Check for active events which have finished
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
+    for(std::list<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
         if((*it)->_Update() == true) {
             // Add it ot the finished events list
             finished_events.push_back(*it);
 
             // Remove the finished event from the active queue.
+            (*it)->_is_active = false;
             it = _active_events.erase(it);
         } else {
             ++it;
@@ -1463,18 +1527,58 @@ void EventSupervisor::Update()
     for(std::vector<MapEvent *>::iterator it = finished_events.begin(); it != finished_events.end(); ++it) {
         _ExamineEventLinks(*it, false);
     }
+
+    _UpdateMapPrefetch();
 }
 
 
 
 bool EventSupervisor::IsEventActive(const std::string &event_id) const
 {
-    for(std::vector<MapEvent *>::const_iterator it = _active_events.begin(); it != _active_events.end(); ++it) {
-        if((*it)->_event_id == event_id) {
-            return true;
+    MapEvent *event = GetEvent(event_id);
+    return (event && event->_is_active);
+}
+
+
+
+bool EventSupervisor::IsEventActive(vt_utils::StringId event_id) const
+{
+    MapEvent *event = GetEvent(event_id);
+    return (event && event->_is_active);
+}
+
+
+
+void EventSupervisor::SetMapTransitionZone(const std::string &event_id, MapZone *zone)
+{
+    MapTransitionEvent *event = dynamic_cast<MapTransitionEvent *>(GetEvent(event_id));
+    if(event == NULL) {
+        PRINT_WARNING << "No map transition event with this ID existed: '" << event_id
+            << "' in map script: "
+            << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
+    }
+
+    if(event->GetTriggerZone() == NULL && zone != NULL)
+        _transition_events.push_back(event);
+    else if(zone == NULL)
+        _transition_events.erase(std::remove(_transition_events.begin(), _transition_events.end(), event),
+                                 _transition_events.end());
+    event->SetTriggerZone(zone);
+}
+
+
+
+MapPreloader *EventSupervisor::TakePrefetchedMap(const std::string &data_filename)
+{
+    for(std::list<MapPreloader *>::iterator it = _prefetched_maps.begin(); it != _prefetched_maps.end(); ++it) {
+        if((*it)->GetFilename() == data_filename) {
+            MapPreloader *preloader = *it;
+            _prefetched_maps.erase(it);
+            return preloader;
         }
     }
-    return false;
+    return NULL;
 }
 
 
@@ -1491,6 +1595,88 @@ MapEvent *EventSupervisor::GetEvent(const std::string &event_id) const
 
 
 
+void EventSupervisor::_AddActiveEvent(MapEvent *event)
+{
+    event->_active_position = _active_events.insert(_active_events.end(), event);
+    event->_is_active = true;
+}
+
+
+
+void EventSupervisor::_ResumePausedEvent(MapEvent *event)
+{
+    // The event may have been started again while paused, and can be active only once at a time.
+    if(event->_is_active) {
+        PRINT_WARNING << "The paused event: '" << event->GetEventID()
+                      << "' was started again meanwhile and is already active. It won't be resumed."
+                      << std::endl << " You should fix the map script: "
+                      << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
+    }
+
+    _AddActiveEvent(event);
+}
+
+
+
+void EventSupervisor::_RemoveActiveEvent(MapEvent *event)
+{
+    _active_events.erase(event->_active_position);
+    event->_is_active = false;
+}
+
+
+
+void EventSupervisor::_AddDelayedEvent(MapEvent *event, uint32 launch_time)
+{
+    DelayedEvent delayed_event;
+    delayed_event.launch_time = _current_time + launch_time;
+    delayed_event.order = _delayed_event_order++;
+    delayed_event.event = event;
+
+    _active_delayed_events.push_back(delayed_event);
+    std::push_heap(_active_delayed_events.begin(), _active_delayed_events.end(), DelayedEventCompare());
+}
+
+
+
+int32 EventSupervisor::_GetRemainingTime(const DelayedEvent &delayed_event) const
+{
+    if(delayed_event.launch_time <= _current_time)
+        return 0;
+    return static_cast<int32>(delayed_event.launch_time - _current_time);
+}
+
+
+
+void EventSupervisor::_RemoveDelayedEvents(const std::string &event_id, VirtualSprite *sprite,
+                                           std::vector<DelayedEvent> &removed_events)
+{
+    for(std::vector<DelayedEvent>::iterator it = _active_delayed_events.begin();
+            it != _active_delayed_events.end();) {
+        bool matches = false;
+        if(sprite) {
+            SpriteEvent *event = dynamic_cast<SpriteEvent *>(it->event);
+            matches = event && event->GetSprite() == sprite;
+        } else {
+            matches = it->event->_event_id == event_id;
+        }
+
+        if(matches) {
+            removed_events.push_back(*it);
+            it = _active_delayed_events.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Erasing elements breaks the heap ordering.
+    if(!removed_events.empty())
+        std::make_heap(_active_delayed_events.begin(), _active_delayed_events.end(), DelayedEventCompare());
+}
+
+
+
 void EventSupervisor::_ExamineEventLinks(MapEvent *parent_event, bool event_start)
 {
     for(uint32 i = 0; i < parent_event->_event_links.size(); ++i) {
@@ -1502,11 +1688,11 @@ void EventSupervisor::_ExamineEventLinks(MapEvent *parent_event, bool event_star
         }
         // Case 2: The child event is to be launched immediately
         else if(link.launch_timer == 0) {
-            StartEvent(link.child_event_id);
+            StartEvent(link.child_event_handle);
         }
         // Case 3: The child event has a timer associated with it and needs to be placed in the event launch container
         else {
-            MapEvent *child = GetEvent(link.child_event_id);
+            MapEvent *child = GetEvent(link.child_event_handle);
             if(child == NULL) {
                 PRINT_WARNING << "Couldn't launch child event, no event with this ID existed: '"
                               << link.child_event_id << "' from parent event ID: '"
@@ -1515,12 +1701,64 @@ void EventSupervisor::_ExamineEventLinks(MapEvent *parent_event, bool event_star
                               << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
                 continue;
             } else {
-                _active_delayed_events.push_back(std::make_pair(static_cast<int32>(link.launch_timer), child));
+                _AddDelayedEvent(child, link.launch_timer);
             }
         }
     }
 }
 
+
+
+
+void EventSupervisor::_UpdateMapPrefetch()
+{
+    // Start decoding the tileset images of the maps whose data got loaded.
+    for(std::list<MapPreloader *>::iterator it = _prefetched_maps.begin(); it != _prefetched_maps.end(); ++it)
+        (*it)->Update();
+
+    VirtualSprite *camera = MapMode::CurrentInstance()->GetCamera();
+    if(_transition_events.empty() || camera == NULL)
+        return;
+
+    // Find the transition zone closest to the camera.
+    MapTransitionEvent *closest_event = NULL;
+    float closest_distance = MAP_PREFETCH_DISTANCE;
+    for(std::vector<MapTransitionEvent *>::const_iterator it = _transition_events.begin(); it != _transition_events.end(); ++it) {
+        float distance = (*it)->GetTriggerZone()->GetDistance(camera->GetXPosition(), camera->GetYPosition());
+        if(distance < closest_distance) {
+            closest_distance = distance;
+            closest_event = *it;
+        }
+    }
+    if(closest_event == NULL)
+        return;
+
+    // Keep the most recently needed map first when it was already prefetched.
+    const std::string &data_filename = closest_event->GetMapDataFilename();
+    for(std::list<MapPreloader *>::iterator it = _prefetched_maps.begin(); it != _prefetched_maps.end(); ++it) {
+        if((*it)->GetFilename() == data_filename) {
+            _prefetched_maps.splice(_prefetched_maps.begin(), _prefetched_maps, it);
+            return;
+        }
+    }
+
+    // Prefetch a single map at a time, so that dropping the oldest map never waits for its loading.
+    for(std::list<MapPreloader *>::const_iterator it = _prefetched_maps.begin(); it != _prefetched_maps.end(); ++it) {
+        if((*it)->IsLoading())
+            return;
+    }
+
+    while(_prefetched_maps.size() >= MAX_PREFETCHED_MAPS) {
+        delete _prefetched_maps.back();
+        _prefetched_maps.pop_back();
+    }
+
+    // The preloader is kept even if the map data couldn't be loaded, to not try again on every update.
+    MapPreloader *preloader = new MapPreloader();
+    preloader->Start(data_filename);
+    _prefetched_maps.push_front(preloader);
+}
+
 } // namespace private_map
 
 } // namespace vt_map
@@ -31,6 +31,8 @@
 
 #include "engine/script/script.h"
 
+#include "utils/utils_strings.h"
+
 namespace vt_map
 {
 
@@ -38,7 +40,9 @@ namespace private_map
 {
 
 class ContextZone;
+class MapPreloader;
 class MapSprite;
+class MapZone;
 class SpriteDialogue;
 class VirtualSprite;
 
@@ -67,7 +71,8 @@ class EventLink
 {
 public:
     EventLink(const std::string &child_id, bool start, uint32 time) :
-        child_event_id(child_id), launch_at_start(start), launch_timer(time) {}
+        child_event_id(child_id), child_event_handle(vt_utils::InternString(child_id)),
+        launch_at_start(start), launch_timer(time) {}
 
     ~EventLink()
     {}
@@ -75,6 +80,9 @@ public:
     //! \brief The ID of the child event in this link
     std::string child_event_id;
 
+    //! \brief The handle of the child event ID, used to look the event up
+    vt_utils::StringId child_event_handle;
+
     //! \brief The event will launch relative to the parent event's start if true, or its finish if false
     bool launch_at_start;
 
@@ -107,7 +115,7 @@ class MapEvent
 public:
     //! \param id The ID for the map event (an empty() value is invalid)
     MapEvent(const std::string &id, EVENT_TYPE type) :
-        _event_id(id), _event_type(type) {}
+        _event_id(id), _event_handle(vt_utils::InternString(id)), _event_type(type), _is_active(false) {}
 
     virtual ~MapEvent()
     {}
@@ -116,6 +124,11 @@ public:
         return _event_id;
     }
 
+    //! \brief Returns the handle of the event ID, as given by vt_utils::InternString()
+    vt_utils::StringId GetEventHandle() const {
+        return _event_handle;
+    }
+
     EVENT_TYPE GetEventType() const {
         return _event_type;
     }
@@ -177,11 +190,20 @@ private:
     //! \brief A unique ID string for the event. An empty value is invalid
     std::string _event_id;
 
+    //! \brief The handle of the event ID, used to look the event up without string comparisons
+    vt_utils::StringId _event_handle;
+
     //! \brief Identifier for the class type of this event
     EVENT_TYPE _event_type;
 
     //! \brief All child events of this class, represented by EventLink objects
     std::vector<EventLink> _event_links;
+
+    //! \brief Tells whether the event is in the event supervisor active events list
+    bool _is_active;
+
+    //! \brief The event position in the event supervisor active events list, only valid when active
+    std::list<MapEvent *>::iterator _active_position;
 }; // class MapEvent
 
 
@@ -394,10 +416,25 @@ public:
                        const std::string &script_filename,
                        const std::string &coming_from);
 
-    ~MapTransitionEvent() {};
+    ~MapTransitionEvent();
+
+    const std::string &GetMapDataFilename() const {
+        return _transition_map_data_filename;
+    }
+
+    /** \brief Sets the zone in which the camera triggers this event
+    *** The new map is then prefetched when the camera gets close to the zone.
+    **/
+    void SetTriggerZone(MapZone *zone) {
+        _trigger_zone = zone;
+    }
+
+    MapZone *GetTriggerZone() const {
+        return _trigger_zone;
+    }
 
 protected:
-    //! \brief Begins the transition process by fading out the screen and music
+    //! \brief Begins the transition process by fading out the screen and music, and preloading the new map
     void _Start();
 
     //! \brief Once the fading process completes, creates the new map mode to transition to
@@ -414,6 +451,12 @@ protected:
 
     //! \brief tells the update function to trigger the new map.
     bool _done;
+
+    //! \brief Preloads the new map data and tileset images during the fade out.
+    MapPreloader *_preloader;
+
+    //! \brief The zone in which the camera triggers this event, or NULL if unknown.
+    MapZone *_trigger_zone;
 }; // class MapTransitionEvent : public MapEvent
 
 
@@ -528,8 +571,9 @@ protected:
     //! \brief A pointer to the Lua function that starts the event
     ScriptObject _check_function;
 
-    std::string _true_event_id;
-    std::string _false_event_id;
+    //! \brief The handles of the events to start, or vt_utils::INVALID_STRING_ID for none
+    vt_utils::StringId _true_event_handle;
+    vt_utils::StringId _false_event_handle;
 
     //! \brief Calls the Lua _start_function, if one was defined
     void _Start();
@@ -877,10 +921,13 @@ protected:
     //! \brief Holds the path needed to traverse from source to destination
     Path _path;
 
+    //! \brief The id of the path request being computed, or 0 if none.
+    uint32 _path_request_id;
+
     //! \brief Tells whether the sprite should use the walk or run animation
     bool _run;
 
-    //! \brief Calculates a path for the sprite to move to the destination
+    //! \brief Requests a path for the sprite to move to the destination
     void _Start();
 
     //! \brief Returns true when the sprite has reached the destination
@@ -1068,7 +1115,9 @@ class EventSupervisor
 {
 public:
     EventSupervisor():
-        _is_updating(false)
+        _is_updating(false),
+        _current_time(0),
+        _delayed_event_order(0)
     {}
 
     ~EventSupervisor();
@@ -1099,6 +1148,14 @@ public:
     void StartEvent(MapEvent *event);
     void StartEvent(MapEvent *event, uint32 launch_time);
 
+    /** \brief Marks a specified event as active and starts the event
+    *** \param event_id The handle of the event ID, given by vt_utils::InternString()
+    *** \param launch_time The time to wait before launching the event.
+    *** This avoids looking up the event ID string, which is useful for scripts starting events often.
+    **/
+    void StartEvent(vt_utils::StringId event_id);
+    void StartEvent(vt_utils::StringId event_id, uint32 launch_time);
+
     /** \brief Pauses the active events by preventing them from updating
     *** \param event_id The ID of the active event(s) to pause
     *** If the event corresponding to the ID is not active, a warning will be issued and no change
@@ -1149,6 +1206,7 @@ public:
     *** \return True if the event is active, false if it is not or the event could not be found
     **/
     bool IsEventActive(const std::string &event_id) const;
+    bool IsEventActive(vt_utils::StringId event_id) const;
 
     //! \brief Returns true if any events are active
     bool HasActiveEvent() const {
@@ -1166,23 +1224,71 @@ public:
     **/
     MapEvent *GetEvent(const std::string &event_id) const;
 
+    /** \brief Returns a pointer to a specified event stored by this class
+    *** \param event_id The handle of the event ID, given by vt_utils::InternString()
+    *** \return A MapEvent pointer, or NULL if no event was found
+    **/
+    MapEvent *GetEvent(vt_utils::StringId event_id) const {
+        return (event_id < _events_by_id.size()) ? _events_by_id[event_id] : NULL;
+    }
+
     bool DoesEventExist(const std::string &event_id) const
     { return !(GetEvent(event_id) == NULL); }
 
+    /** \brief Sets the zone in which the camera triggers the given map transition event
+    *** \param event_id The ID of the map transition event
+    *** \param zone The zone triggering the event
+    *** When the camera gets close to the zone, the destination map is prefetched in the background.
+    *** \note The map scripts call it right after adding the zones checked to start their transitions,
+    *** as the transitions without zone are never prefetched.
+    **/
+    void SetMapTransitionZone(const std::string &event_id, MapZone *zone);
+
+    /** \brief Gives the preloader of the given map if it was prefetched
+    *** \param data_filename The map data filename to transition to
+    *** \return The map preloader, deleted by the caller, or NULL if the map wasn't prefetched.
+    **/
+    MapPreloader *TakePrefetchedMap(const std::string &data_filename);
+
 private:
     //! \brief A container for all map events, where the event's ID serves as the key to the std::map
     std::map<std::string, MapEvent *> _all_events;
 
-    //! \brief A list of all events which have started but are not yet finished
-    std::vector<MapEvent *> _active_events;
+    //! \brief The registered events indexed by the handle of their ID, or NULL
+    std::vector<MapEvent *> _events_by_id;
+
+    /** \brief A list of all events which have started but are not yet finished
+    *** The events keep their position in the list, so that they are removed in constant time.
+    **/
+    std::list<MapEvent *> _active_events;
 
     //! \brief A list of all events which have been paused
     std::vector<MapEvent *> _paused_events;
 
-    /** \brief A list of all events that are waiting on their launch timers to expire before being started
-    *** The interger part of this std::pair is the countdown timer for this event to be launched
+    //! \brief An event waiting on its launch time to be reached before being started
+    struct DelayedEvent {
+        //! \brief The event supervisor time at which the event is launched, in milliseconds
+        uint32 launch_time;
+
+        //! \brief Keeps the events with the same launch time in their addition order
+        uint32 order;
+
+        MapEvent *event;
+    };
+
+    //! \brief Orders the delayed events heap, so that the next event to launch is first.
+    struct DelayedEventCompare {
+        bool operator()(const DelayedEvent &a, const DelayedEvent &b) const {
+            if(a.launch_time != b.launch_time)
+                return a.launch_time > b.launch_time;
+            return a.order > b.order;
+        }
+    };
+
+    /** \brief A heap of all events that are waiting on their launch time before being started
+    *** Only the first events need to be checked on every update, instead of every timer being updated.
     **/
-    std::vector<std::pair<int32, MapEvent *> > _active_delayed_events;
+    std::vector<DelayedEvent> _active_delayed_events;
 
     /** \brief A list of all events that are waiting on their launch timers to expire before being started
     *** The interger part of this std::pair is the countdown timer for this event to be launched
@@ -1195,11 +1301,54 @@ private:
     **/
     volatile bool _is_updating;
 
+    //! \brief The time spent updating the events, in milliseconds, used as a base for the delayed events launch time
+    uint32 _current_time;
+
+    //! \brief The order given to the next delayed event
+    uint32 _delayed_event_order;
+
+    //! \brief The map transition events with a trigger zone, used to prefetch the next map
+    std::vector<MapTransitionEvent *> _transition_events;
+
+    /** \brief The prefetched maps, the most recently needed first
+    *** \note The number of maps kept is bounded by MAX_PREFETCHED_MAPS.
+    **/
+    std::list<MapPreloader *> _prefetched_maps;
+
     /** \brief A function that is called whenever an event starts or finishes to examine that event's links
     *** \param parent_event The event that has just started or finished
     *** \param event_start The event has just started if this member is true, or if it just finished it will be false
     **/
     void _ExamineEventLinks(MapEvent *parent_event, bool event_start);
+
+    //! \brief Adds an event to the active events list and keeps its position in it.
+    void _AddActiveEvent(MapEvent *event);
+
+    //! \brief Adds a paused event back to the active events, unless it was started again meanwhile.
+    void _ResumePausedEvent(MapEvent *event);
+
+    //! \brief Removes an active event from the active events list, in constant time.
+    void _RemoveActiveEvent(MapEvent *event);
+
+    /** \brief Adds an event to launch later into the delayed events heap
+    *** \param event The event to launch
+    *** \param launch_time The number of milliseconds to wait before launching the event
+    **/
+    void _AddDelayedEvent(MapEvent *event, uint32 launch_time);
+
+    //! \brief Returns the number of milliseconds left before launching a delayed event.
+    int32 _GetRemainingTime(const DelayedEvent &delayed_event) const;
+
+    /** \brief Removes delayed events from the delayed events heap, keeping it ordered
+    *** \param event_id The id of the events to remove, used when no sprite is given
+    *** \param sprite When not NULL, the sprite whose sprite events are removed
+    *** \param removed_events Filled with the removed delayed events
+    **/
+    void _RemoveDelayedEvents(const std::string &event_id, VirtualSprite *sprite,
+                              std::vector<DelayedEvent> &removed_events);
+
+    //! \brief Prefetches the destination map of the transition zone closest to the camera.
+    void _UpdateMapPrefetch();
 }; // class EventSupervisor
 
 } // namespace private_map
@@ -22,6 +22,8 @@
 #include "engine/video/video.h"
 #include "common/gui/menu_window.h"
 
+#include "utils/utils_files.h"
+
 // Used for the collision to XPM dev function
 #ifdef DEBUG_FEATURES
 #include "engine/script/script_write.h"
@@ -33,22 +35,120 @@ namespace vt_map
 namespace private_map
 {
 
-//! \brief allows for scoped-based control of SDL Surfaces
-struct SDLSurfaceController {
-    SDL_Surface *_surface;
-    inline SDLSurfaceController(const char *str) :
-        _surface(IMG_Load(str))
-    {
-        if(!_surface)
-            PRINT_ERROR << "Couldn't create white_noise image for collision map: " << SDL_GetError() << std::endl;
+//! \brief The number of threads writing the procedural minimap rows.
+static const uint32 MINIMAP_GENERATION_THREADS = 4;
+
+//! \brief The data needed to write a range of pixel rows of the procedural minimap.
+struct MinimapRowsJob {
+    //! \brief The collision cells, set to 1 for walls, stored like this: walls[y * grid_width + x]
+    const std::vector<uint8> *walls;
+
+    //! \brief The white noise image drawn on walls, in RGBA format.
+    const vt_video::private_video::ImageMemory *noise;
+
+    //! \brief The minimap RGBA pixels, and its width in pixels.
+    uint8 *pixels;
+    uint32 width;
+
+    uint32 grid_width;
+    uint32 box_x_length;
+    uint32 box_y_length;
+
+    //! \brief The range of pixel rows to write.
+    uint32 first_row;
+    uint32 end_row;
+};
+
+//! \brief Writes the pixels rows of a job. Only reads the job inputs, so that jobs can run in parallel.
+static int writeMinimapRows(void *job_ptr)
+{
+    const MinimapRowsJob &job = *static_cast<MinimapRowsJob *>(job_ptr);
+    const uint32 *noise_pixels = static_cast<const uint32 *>(job.noise->pixels);
+
+    for(uint32 y = job.first_row; y < job.end_row; ++y) {
+        uint32 *dst = reinterpret_cast<uint32 *>(job.pixels) + y * job.width;
+        const uint32 *noise_row = noise_pixels + (y % job.noise->height) * job.noise->width;
+        const uint8 *wall_row = &(*job.walls)[(y / job.box_y_length) * job.grid_width];
+
+        // The walls are covered by the tiled white noise image, and the rest is transparent.
+        for(uint32 col = 0; col < job.grid_width; ++col) {
+            uint32 x = col * job.box_x_length;
+            if(wall_row[col]) {
+                for(uint32 i = 0; i < job.box_x_length; ++i, ++x)
+                    dst[x] = noise_row[x % job.noise->width];
+            } else {
+                memset(dst + x, 0, job.box_x_length * 4);
+            }
+        }
     }
+    return 0;
+}
 
-    ~SDLSurfaceController()
-    {
-        if(_surface)
-            SDL_FreeSurface(_surface);
+//! \brief Adds a value to a FNV-1a hash.
+static void hashValue(uint32 &hash, uint32 value)
+{
+    for(uint32 i = 0; i < 4; ++i, value >>= 8)
+        hash = (hash ^ (value & 0xFF)) * 16777619u;
+}
+
+//! \brief Adds a file modification time and size to a FNV-1a hash, so that it changes along with the file.
+static void hashFileStamp(uint32 &hash, const std::string &filename)
+{
+    uint64_t time = static_cast<uint64_t>(vt_utils::GetFileModificationTime(filename));
+    uint64_t size = vt_utils::GetFileSize(filename);
+    hashValue(hash, static_cast<uint32>(time));
+    hashValue(hash, static_cast<uint32>(time >> 32));
+    hashValue(hash, static_cast<uint32>(size));
+    hashValue(hash, static_cast<uint32>(size >> 32));
+}
+
+/** \brief Returns a FNV-1a hash of everything the minimap walls are made of, used to name its cache file.
+*** This avoids computing the walls when the cache file is up to date: the collision grid comes from the map
+*** data file, and the static objects are added by the map script, possibly depending on the game progress.
+**/
+static uint32 hashMinimapSources(const std::vector<MapObject *> &ground_objects, uint32 grid_width, uint32 grid_height,
+                                 uint32 box_x_length, uint32 box_y_length)
+{
+    MapMode *map_mode = MapMode::CurrentInstance();
+
+    uint32 hash = 2166136261u;
+    hashValue(hash, grid_width);
+    hashValue(hash, grid_height);
+    hashValue(hash, box_x_length);
+    hashValue(hash, box_y_length);
+    hashFileStamp(hash, map_mode->GetMapDataFilename());
+    hashFileStamp(hash, map_mode->GetMapScriptFilename());
+
+    // The objects taken into account by ObjectSupervisor::IsStaticCollision()
+    for(uint32 i = 0; i < ground_objects.size(); ++i) {
+        const MapObject *object = ground_objects[i];
+        if(object->collision_mask == NO_COLLISION || object->GetObjectType() != PHYSICAL_TYPE)
+            continue;
+
+        MapRectangle rect = object->GetCollisionRectangle();
+        float bounds[4] = { rect.left, rect.top, rect.right, rect.bottom };
+        for(uint32 j = 0; j < 4; ++j) {
+            uint32 bits;
+            memcpy(&bits, &bounds[j], sizeof(bits));
+            hashValue(hash, bits);
+        }
     }
-};
+    return hash;
+}
+
+//! \brief Gives the prefix of the minimap cache files of a map, e.g. "dat_maps_layna_village_layna_village_center_map_".
+static std::string getMinimapCachePrefix(const std::string &map_data_filename)
+{
+    std::string prefix = map_data_filename;
+    std::string::size_type extension = prefix.rfind(".lua");
+    if(extension != std::string::npos)
+        prefix.erase(extension);
+    for(uint32 i = 0; i < prefix.size(); ++i) {
+        if(prefix[i] == '/' || prefix[i] == '\\' || prefix[i] == ':')
+            prefix[i] = '_';
+    }
+    return prefix + "_";
+}
 
 static const vt_video::Color default_opacity(1.0f, 1.0f, 1.0f, 0.75f);
 static const vt_video::Color overlap_opacity(1.0f, 1.0f, 1.0f, 0.45f);
@@ -98,111 +198,102 @@ Minimap::Minimap(const std::string& minimap_image_filename) :
     _viewport_height = 128.0f * ratio_y;
 }
 
-static inline bool _PrepareSurface(SDL_Surface *temp_surface)
-{
-    static const SDLSurfaceController white_noise("img/menus/minimap_collision.png");
-    SDL_Rect r;
-    r.x = r.y = 0;
-
-    //prepare the surface with the image. we tile the white noise image onto the surface
-    //with full alpha
-    for(int x = 0; x < temp_surface->w; x += white_noise._surface->w) {
-        r.x = x;
-        for(int y = 0; y < temp_surface->h; y += white_noise._surface->h) {
-            r.y = y;
-            if(SDL_BlitSurface(white_noise._surface, NULL, temp_surface, &r)) {
-                PRINT_ERROR << "Couldn't fill a rect on temp_surface: " << SDL_GetError() << std::endl;
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
 vt_video::StillImage Minimap::_CreateProcedurally()
 {
     ObjectSupervisor *map_object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
 
-    float x, y, width, height;
-    vt_video::VideoManager->GetCurrentViewport(x, y, width, height);
-
-    //create a new SDL surface that is the rendering dimensions we want.
-    SDL_Surface *temp_surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
-                                                     _grid_width * _box_x_length, _grid_height * _box_y_length, 32,
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-                                                     0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
-#else
-                                                     0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
-#endif
+    uint32 width = _grid_width * _box_x_length;
+    uint32 height = _grid_height * _box_y_length;
+
+    // The minimap is cached in the user data directory, under a name depending on the map files and static objects,
+    // so that it is only generated again when the map collisions change.
+    std::string cache_directory = vt_utils::GetUserDataPath() + "minimaps/";
+    if(!vt_utils::DoesFileExist(cache_directory))
+        vt_utils::MakeDirectory(cache_directory);
+    std::string cache_prefix = getMinimapCachePrefix(MapMode::CurrentInstance()->GetMapDataFilename());
+    std::string cache_name = cache_prefix + vt_utils::NumberToString(
+        hashMinimapSources(map_object_supervisor->GetGroundObjects(), _grid_width, _grid_height,
+                           _box_x_length, _box_y_length)) + ".png";
+    std::string cache_filename = cache_directory + cache_name;
+
+    vt_video::StillImage minimap_image;
+    if(vt_utils::DoesFileExist(cache_filename) && minimap_image.Load(cache_filename, width, height))
+        return minimap_image;
+
+    // Only keep one cache file per map, by removing the ones written for previous versions of it.
+    std::vector<std::string> cache_files = vt_utils::ListDirectory(cache_directory, cache_prefix);
+    for(uint32 i = 0; i < cache_files.size(); ++i) {
+        if(cache_files[i].compare(0, cache_prefix.size(), cache_prefix) == 0 && cache_files[i] != cache_name)
+            vt_utils::DeleteFile(cache_directory + cache_files[i]);
+    }
 
-    if(!temp_surface) {
-        PRINT_ERROR << "Couldn't create temp_surface for collision map: " << SDL_GetError() << std::endl;
-        MapMode::CurrentInstance()->ShowMinimap(false);
-        return vt_video::StillImage();
+    // Get the collision of every grid cell once, as the physical objects have to be taken into account.
+    std::vector<uint8> walls(_grid_width * _grid_height, 0);
+    for(uint32 row = 0; row < _grid_height; ++row) {
+        for(uint32 col = 0; col < _grid_width; ++col) {
+            if(map_object_supervisor->IsStaticCollision(col, row))
+                walls[row * _grid_width + col] = 1;
+        }
     }
 
-    //set the basic rect information
-    SDL_Rect r;
-    r.w = _box_x_length;
-    r.h = _box_y_length;
-    r.x = r.y = 0;
-
-    //very simple. Just go through the entire grid, checking the visible-character's
-    //context against the map-grid's collision context. if this is NOT a colidable location
-    //fill that square in with a full alpha block
-    //note that the ordering needs to be transposed for drawing
-    if (!_PrepareSurface(temp_surface)) {
-        SDL_FreeSurface(temp_surface);
+    vt_video::private_video::ImageMemory noise;
+    if(!noise.DecodeImage("img/menus/minimap_collision.png")) {
+        PRINT_ERROR << "Couldn't create white_noise image for collision map" << std::endl;
         MapMode::CurrentInstance()->ShowMinimap(false);
         return vt_video::StillImage();
     }
 
-    for(uint32 row = 0; row < _grid_width; ++row)
-    {
-        r.y = 0;
-        for(uint32 col = 0; col < _grid_height; ++col)
-        {
-            if(!map_object_supervisor->IsStaticCollision(row, col))
-            {
-
-                if(SDL_FillRect(temp_surface, &r, SDL_MapRGBA(temp_surface->format, 0x00, 0x00, 0x00, 0x00)))
-                {
-                    PRINT_ERROR << "Couldn't fill a rect on temp_surface: " << SDL_GetError() << std::endl;
-                    SDL_FreeSurface(temp_surface);
-                    return vt_video::StillImage();
-                }
+    //setup a temporary memory space to write the minimap pixels into
+    vt_video::private_video::ImageMemory temp_data;
+    temp_data.rgb_format = false;
+    temp_data.width = width;
+    temp_data.height = height;
+    temp_data.pixels = malloc(width * height * 4);
+
+    // Write the pixel rows in parallel, each thread taking a range of rows.
+    MinimapRowsJob jobs[MINIMAP_GENERATION_THREADS];
+    uint32 rows_per_job = (height + MINIMAP_GENERATION_THREADS - 1) / MINIMAP_GENERATION_THREADS;
+    for(uint32 i = 0; i < MINIMAP_GENERATION_THREADS; ++i) {
+        jobs[i].walls = &walls;
+        jobs[i].noise = &noise;
+        jobs[i].pixels = static_cast<uint8 *>(temp_data.pixels);
+        jobs[i].width = width;
+        jobs[i].grid_width = _grid_width;
+        jobs[i].box_x_length = _box_x_length;
+        jobs[i].box_y_length = _box_y_length;
+        jobs[i].first_row = std::min(height, i * rows_per_job);
+        jobs[i].end_row = std::min(height, (i + 1) * rows_per_job);
+    }
 
-            }
-            r.y += _box_y_length;
-        }
-        r.x += _box_x_length;
+#if (THREAD_TYPE == SDL_THREADS)
+    // The first job is done by the current thread.
+    SDL_Thread *threads[MINIMAP_GENERATION_THREADS];
+    for(uint32 i = 1; i < MINIMAP_GENERATION_THREADS; ++i) {
+        threads[i] = SDL_CreateThread(writeMinimapRows, &jobs[i]);
+        if(threads[i] == NULL)
+            writeMinimapRows(&jobs[i]);
+    }
+    writeMinimapRows(&jobs[0]);
+    for(uint32 i = 1; i < MINIMAP_GENERATION_THREADS; ++i) {
+        if(threads[i] != NULL)
+            SDL_WaitThread(threads[i], NULL);
     }
+#else
+    for(uint32 i = 0; i < MINIMAP_GENERATION_THREADS; ++i)
+        writeMinimapRows(&jobs[i]);
+#endif
 
-    //flush the SDL surface. This forces any pending writes onto the surface to complete
-    SDL_UpdateRect(temp_surface, 0, 0, 0, 0);
+    free(noise.pixels);
+    noise.pixels = NULL;
 
-    if (!temp_surface) {
-        MapMode::CurrentInstance()->ShowMinimap(false);
-        return vt_video::StillImage();
-    }
+    if(!temp_data.SaveImage(cache_filename))
+        PRINT_WARNING << "Couldn't save the minimap cache file: " << cache_filename << std::endl;
 
-    SDL_LockSurface(temp_surface);
-    //setup a temporary memory space to copy the SDL data into
-    vt_video::private_video::ImageMemory temp_data;
-    temp_data.rgb_format = false;
-    temp_data.width = temp_surface->w;
-    temp_data.height = temp_surface->h;
-    size_t len = temp_surface->h * temp_surface->w * ((unsigned short) (temp_surface->format->BitsPerPixel) / 8) ;
-    temp_data.pixels = malloc(len);
-    //copy the data
-    memcpy(temp_data.pixels, temp_surface->pixels, len);
-    SDL_UnlockSurface(temp_surface);
-    //at this point, the screen data is set up. We can get rid of unnecessary data here
-    SDL_FreeSurface(temp_surface);
     //do the image file creation
     std::string map_name_cmap = MapMode::CurrentInstance()->GetMapScriptFilename() + "_cmap";
-    vt_video::StillImage minimap_image = vt_video::VideoManager->CreateImage(&temp_data, map_name_cmap);
+    minimap_image = vt_video::VideoManager->CreateImage(&temp_data, map_name_cmap);
     free(temp_data.pixels);
+    temp_data.pixels = NULL;
 
 #ifdef DEBUG_FEATURES
     // Uncomment and compile this to generate XPM minimaps.
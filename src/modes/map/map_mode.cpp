@@ -18,6 +18,7 @@
 #include "utils/utils_pch.h"
 #include "modes/map/map_mode.h"
 
+#include "modes/map/map_data.h"
 #include "modes/map/map_dialogue.h"
 #include "modes/map/map_events.h"
 #include "modes/map/map_objects.h"
@@ -31,6 +32,7 @@
 
 #include "engine/audio/audio.h"
 #include "engine/input.h"
+#include "engine/profiler.h"
 
 #include "common/global/global.h"
 
@@ -58,10 +60,12 @@ MapMode *MapMode::_current_instance = NULL;
 // ********** MapMode Public Class Methods
 // ****************************************************************************
 
-MapMode::MapMode(const std::string& data_filename, const std::string& script_filename, uint32 stamina) :
+MapMode::MapMode(const std::string& data_filename, const std::string& script_filename, uint32 stamina,
+                 MapData *map_data) :
     GameMode(MODE_MANAGER_MAP_MODE),
     _activated(false),
     _map_data_filename(data_filename),
+    _preloaded_map_data(map_data),
     _map_script_filename(script_filename),
     _tile_supervisor(NULL),
     _object_supervisor(NULL),
@@ -356,6 +360,9 @@ void MapMode::Update()
 
 void MapMode::Draw()
 {
+    // Follow the camera drawing position, interpolated since the last update.
+    _UpdateMapFrame();
+
     VideoManager->SetStandardCoordSys();
     GetScriptSupervisor().DrawBackground();
 
@@ -626,42 +633,41 @@ uint16 MapMode::GetMapHeight() const
 
 bool MapMode::_Load()
 {
-    // Map data
-    // Clear out all old map data if existing.
-    ScriptManager->DropGlobalTable("map_data");
+    vt_system::TraceScope trace("MapMode::_Load");
 
-    // Open map script file and read in the basic map properties and tile definitions
-    if(!_map_script.OpenFile(_map_data_filename)) {
-        PRINT_ERROR << "Couldn't open map data file: "
-                    << _map_data_filename << std::endl;
-        return false;
-    }
-
-    if(!_map_script.OpenTable("map_data")) {
-        PRINT_ERROR << "Couldn't open table 'map_data' in: "
-                    << _map_data_filename << std::endl;
-        _map_script.CloseFile();
-        return false;
+    // Map data
+    // Read the dimensions, tile layers and collision grid, from the compiled map data when up to date.
+    // The map data may already have been preloaded during the previous map transition.
+    MapData loaded_map_data;
+    MapData *preloaded_map_data = _preloaded_map_data;
+    _preloaded_map_data = NULL;
+    if(!preloaded_map_data) {
+        bool map_data_loaded = loaded_map_data.Load(_map_data_filename);
+        loaded_map_data.PrintMessages();
+        if(!map_data_loaded) {
+            PRINT_ERROR << "Couldn't load the map data file: "
+                        << _map_data_filename << std::endl;
+            return false;
+        }
     }
+    MapData &map_data = preloaded_map_data ? *preloaded_map_data : loaded_map_data;
 
     // Loads the collision grid
-    if(!_object_supervisor->Load(_map_script)) {
+    if(!_object_supervisor->Load(map_data)) {
         PRINT_ERROR << "Failed to load the collision grid from: "
             << _map_data_filename << std::endl;
-        _map_script.CloseFile();
         return false;
     }
 
     // Instruct the supervisor classes to perform their portion of the load operation
-    if(!_tile_supervisor->Load(_map_script)) {
+    if(!_tile_supervisor->Load(map_data)) {
         PRINT_ERROR << "Failed to load the tile data from: "
             << _map_data_filename << std::endl;
-        _map_script.CloseFile();
         return false;
     }
 
-    _map_script.CloseAllTables();
-    _map_script.CloseFile(); // Free the map data file once everyhting is loaded
+    // Free the preloaded tileset images which weren't used, e.g. because already in texture memory.
+    TextureManager->ClearDecodedImages();
 
     // Map script
 
@@ -746,6 +752,9 @@ bool MapMode::_Load()
     _map_script.CloseAllTables();
     _map_script.CloseFile(); // Free the map script file once everything is loaded
 
+    // Sort the objects created by the map script, as the map may be drawn before its first update.
+    _object_supervisor->SortObjects();
+
     return true;
 } // bool MapMode::_Load()
 
@@ -873,8 +882,8 @@ void MapMode::_UpdateMapFrame()
 {
     // Determine the center position coordinates for the camera
     // Holds the final X, Y coordinates of the camera
-    float camera_x = _camera->GetXPosition();
-    float camera_y = _camera->GetYPosition();
+    float camera_x = _camera->GetDrawXPosition();
+    float camera_y = _camera->GetDrawYPosition();
 
     if(_camera_timer.IsRunning()) {
         camera_x += (1.0f - _camera_timer.PercentComplete()) * _delta_x;
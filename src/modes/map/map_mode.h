@@ -57,6 +57,7 @@ const uint32 STAMINA_FULL = 10000;
 //! An internal namespace to be used only within the map code. Don't use this namespace anywhere else!
 namespace private_map
 {
+class MapData;
 class MapDialogueSupervisor;
 class EventSupervisor;
 class Light;
@@ -113,8 +114,10 @@ public:
     //! \param data_filename The name of the Lua file that retains all data about the map to create
     //! \param script_filename The name of the Lua file that retains all data about script to load
     //! \param stamina The amount of stamina the map character sprite will start with.
-    //! \note the last parameter is usually set to carry the current stamina value from one map to another.
-    MapMode(const std::string &data_filename, const std::string& script_filename, uint32 stamina = STAMINA_FULL);
+    //! \param map_data The map data already loaded from the data file, or NULL to load it.
+    //! \note the stamina parameter is usually set to carry the current stamina value from one map to another.
+    MapMode(const std::string &data_filename, const std::string& script_filename, uint32 stamina = STAMINA_FULL,
+            private_map::MapData *map_data = NULL);
 
     ~MapMode();
 
@@ -238,6 +241,10 @@ public:
         return _map_script_filename;
     }
 
+    const std::string& GetMapDataFilename() const {
+        return _map_data_filename;
+    }
+
     private_map::TileSupervisor* GetTileSupervisor() const {
         return _tile_supervisor;
     }
@@ -454,6 +461,9 @@ private:
     **/
     std::string _map_data_tablespace;
 
+    //! \brief The map data preloaded before the map mode creation, or NULL. Only valid while loading.
+    private_map::MapData *_preloaded_map_data;
+
     //! \brief The name of the Lua file that contains the map script
     std::string _map_script_filename;
 
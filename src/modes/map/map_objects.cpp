@@ -21,11 +21,13 @@
 #include "modes/map/map_mode.h"
 #include "modes/map/map_sprites.h"
 #include "modes/map/map_events.h"
+#include "modes/map/map_data.h"
 
 #include "common/global/global.h"
 
 #include "engine/video/particle_effect.h"
 #include "engine/audio/audio.h"
+#include "engine/profiler.h"
 
 #include "utils/utils_random.h"
 
@@ -58,32 +60,68 @@ MapObject::MapObject() :
     sky_object(false),
     draw_on_second_pass(false),
     _object_type(OBJECT_TYPE),
+    _previous_position_step(0),
     _emote_animation(0),
     _emote_offset_x(0.0f),
     _emote_offset_y(0.0f),
-    _emote_time(0)
+    _emote_time(0),
+    _object_grid(NULL),
+    _grid_cell_left(0),
+    _grid_cell_right(0),
+    _grid_cell_top(0),
+    _grid_cell_bottom(0)
 {}
 
-bool MapObject::ShouldDraw()
+bool MapObject::ShouldDraw(float top_margin)
 {
-    if(!visible)
+    // Determine if the sprite is off-screen and if so, don't draw it.
+    if(!IsVisibleOnScreen(top_margin))
         return false;
 
     MapMode* MM = MapMode::CurrentInstance();
 
-    // Determine if the sprite is off-screen and if so, don't draw it.
-    if(!MapRectangle::CheckIntersection(GetImageRectangle(), MM->GetMapFrame().screen_edges))
-        return false;
-
     // Move the drawing cursor to the appropriate coordinates for this sprite
     // NOTE: We round the value to a multiple of the current pixel size.
     // See MapMode::_UpdateMapFrame() for a better explanation.
-    VideoManager->Move(FloorToFloatMultiple(GetXPosition() - MM->GetMapFrame().screen_edges.left, MM->GetMapPixelXLength()),
-                       FloorToFloatMultiple(GetYPosition() - MM->GetMapFrame().screen_edges.top, MM->GetMapPixelYLength()));
+    VideoManager->Move(FloorToFloatMultiple(GetDrawXPosition() - MM->GetMapFrame().screen_edges.left, MM->GetMapPixelXLength()),
+                       FloorToFloatMultiple(GetDrawYPosition() - MM->GetMapFrame().screen_edges.top, MM->GetMapPixelYLength()));
 
     return true;
 } // bool MapObject::ShouldDraw()
 
+float MapObject::GetDrawXPosition() const
+{
+    // Objects which didn't move on the last update step, or were teleported, are drawn where they are.
+    if(_previous_position_step != SystemManager->GetUpdateStepCount())
+        return position.x;
+
+    return _previous_position.x + (position.x - _previous_position.x) * SystemManager->GetUpdateInterpolation();
+}
+
+float MapObject::GetDrawYPosition() const
+{
+    if(_previous_position_step != SystemManager->GetUpdateStepCount())
+        return position.y;
+
+    return _previous_position.y + (position.y - _previous_position.y) * SystemManager->GetUpdateInterpolation();
+}
+
+void MapObject::_KeepPreviousPosition()
+{
+    _previous_position = position;
+    _previous_position_step = SystemManager->GetUpdateStepCount();
+}
+
+bool MapObject::IsVisibleOnScreen(float top_margin) const
+{
+    if(!visible)
+        return false;
+
+    MapRectangle rect = GetImageRectangle();
+    rect.top -= top_margin;
+    return MapRectangle::CheckIntersection(rect, MapMode::CurrentInstance()->GetMapFrame().screen_edges);
+}
+
 MapRectangle MapObject::GetCollisionRectangle() const
 {
     MapRectangle rect;
@@ -133,6 +171,8 @@ void MapObject::Emote(const std::string &emote_name, vt_map::private_map::ANIM_D
 
     _emote_animation->ResetAnimation();
     _emote_time = _emote_animation->GetAnimationLength();
+
+    MapMode::CurrentInstance()->GetObjectSupervisor()->UpdateEmoteMaxHeight(_GetEmoteHeight());
 }
 
 void MapObject::_UpdateEmote()
@@ -162,6 +202,21 @@ void MapObject::_DrawEmote()
     _emote_animation->Draw();
 }
 
+float MapObject::_GetEmoteHeight() const
+{
+    if(!_emote_animation)
+        return 0.0f;
+
+    // The emote is drawn bottom aligned from the image top, moved by its offset.
+    return std::max(_emote_animation->GetHeight() - _emote_offset_y, 0.0f);
+}
+
+void MapObject::_UpdateObjectGrid()
+{
+    if(_object_grid)
+        _object_grid->UpdateObject(this);
+}
+
 bool MapObject::IsColliding(float x, float y)
 {
     ObjectSupervisor* obj_sup = MapMode::CurrentInstance()->GetObjectSupervisor();
@@ -204,8 +259,14 @@ PhysicalObject::~PhysicalObject()
 
 void PhysicalObject::Update()
 {
-    if(!animations.empty() && updatable)
+    if(animations.empty() || !updatable)
+        return;
+
+    // The off-screen animations only record the elapsed time, and catch up with it once visible.
+    if(IsVisibleOnScreen())
         animations[_current_animation_id].Update();
+    else
+        animations[_current_animation_id].SkipUpdate();
 }
 
 void PhysicalObject::Draw()
@@ -394,8 +455,13 @@ void SavePoint::Update()
     if(!_animations || !updatable)
         return;
 
-    for(uint32 i = 0; i < _animations->size(); ++i)
-        _animations->at(i).Update();
+    bool visible = IsVisibleOnScreen();
+    for(uint32 i = 0; i < _animations->size(); ++i) {
+        if(visible)
+            _animations->at(i).Update();
+        else
+            _animations->at(i).SkipUpdate();
+    }
 }
 
 
@@ -450,8 +516,13 @@ Halo::Halo(const std::string &filename, float x, float y, const Color &color):
 
 void Halo::Update()
 {
-    if(updatable)
+    if(!updatable)
+        return;
+
+    if(IsVisibleOnScreen())
         _animation.Update();
+    else
+        _animation.SkipUpdate();
 }
 
 
@@ -461,6 +532,20 @@ void Halo::Draw()
         VideoManager->DrawHalo(*_animation.GetCurrentFrame(), _color);
 }
 
+void Halo::AddToLightBatch(ImageBatch &batch) const
+{
+    StillImage *image = _animation.GetCurrentFrame();
+    if(!image || !IsVisibleOnScreen())
+        return;
+
+    // Same position as set by ShouldDraw(), the halo being centered horizontally and bottom aligned.
+    MapMode *mm = MapMode::CurrentInstance();
+    const MapFrame &frame = mm->GetMapFrame();
+    float x = FloorToFloatMultiple(position.x - frame.screen_edges.left, mm->GetMapPixelXLength());
+    float y = FloorToFloatMultiple(position.y - frame.screen_edges.top, mm->GetMapPixelYLength());
+    batch.AddImage(*image, x - image->GetWidth() / 2.0f, y - image->GetHeight(), _color);
+}
+
 // Light objects
 Light::Light(const std::string &main_flare_filename,
              const std::string &secondary_flare_filename,
@@ -562,8 +647,13 @@ void Light::Update()
     if(!updatable)
         return;
 
-    _main_animation.Update();
-    _secondary_animation.Update();
+    if(IsVisibleOnScreen()) {
+        _main_animation.Update();
+        _secondary_animation.Update();
+    } else {
+        _main_animation.SkipUpdate();
+        _secondary_animation.SkipUpdate();
+    }
     _UpdateLightAngle();
 }
 
@@ -613,6 +703,35 @@ void Light::Draw()
     VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
 }
 
+void Light::AddToLightBatch(ImageBatch &batch) const
+{
+    StillImage *main_image = _main_animation.GetCurrentFrame();
+    if(!main_image || !IsVisibleOnScreen())
+        return;
+
+    // The flares are centered on their position.
+    MapMode *mm = MapMode::CurrentInstance();
+    const MapFrame &frame = mm->GetMapFrame();
+    float x = FloorToFloatMultiple(position.x - frame.screen_edges.left, mm->GetMapPixelXLength());
+    float y = FloorToFloatMultiple(position.y - frame.screen_edges.top, mm->GetMapPixelYLength());
+    batch.AddImage(*main_image, x - main_image->GetWidth() / 2.0f, y - main_image->GetHeight() / 2.0f, _main_color_alpha);
+
+    StillImage *secondary_image = _secondary_animation.GetCurrentFrame();
+    if(!secondary_image)
+        return;
+
+    // The secondary flares are spread on the line going through the light and the camera viewpoint.
+    const float distance_factors[] = { -_distance_factor_1, -_distance_factor_2, _distance_factor_3, _distance_factor_4 };
+    for(uint32 i = 0; i < 4; ++i) {
+        float next_pos_x = position.x + _distance / distance_factors[i];
+        float next_pos_y = _a * next_pos_x + _b;
+        batch.AddImage(*secondary_image,
+                       next_pos_x - frame.screen_edges.left - secondary_image->GetWidth() / 2.0f,
+                       next_pos_y - frame.screen_edges.top - secondary_image->GetHeight() / 2.0f,
+                       _secondary_color_alpha);
+    }
+}
+
 SoundObject::SoundObject(const std::string& sound_filename, float x, float y, float strength):
     MapObject(),
     _max_sound_volume(1.0f),
@@ -880,6 +999,7 @@ TriggerObject::TriggerObject(const std::string &trigger_name,
     _object_type = TRIGGER_TYPE;
 
     _trigger_name = trigger_name;
+    _trigger_handle = vt_utils::InternString(trigger_name);
 
     _off_event = off_event_id;
     _on_event = on_event_id;
@@ -929,13 +1049,20 @@ void TriggerObject::Update() {
 
 }
 
+//! \brief Returns the handle of the event group storing the triggers state
+static vt_utils::StringId GetTriggersGroupHandle()
+{
+    static vt_utils::StringId triggers_group = vt_utils::InternString("triggers");
+    return triggers_group;
+}
+
 void TriggerObject::_LoadState()
 {
     if(_trigger_name.empty())
         return;
 
     // If the event value is equal to 1, the trigger has been triggered.
-    if(GlobalManager->GetEventValue("triggers", _trigger_name) == 1) {
+    if(GlobalManager->GetEventValue(GetTriggersGroupHandle(), _trigger_handle) == 1) {
         SetCurrentAnimation(TRIGGER_ON_ANIM);
         _trigger_state = true;
     }
@@ -957,13 +1084,161 @@ void TriggerObject::SetState(bool state)
         SetCurrentAnimation(TRIGGER_ON_ANIM);
         if (!_on_event.empty())
             MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(_on_event);
-        GlobalManager->SetEventValue("triggers", _trigger_name, 1);
+        GlobalManager->SetEventValue(GetTriggersGroupHandle(), _trigger_handle, 1);
     }
     else {
         SetCurrentAnimation(TRIGGER_OFF_ANIM);
         if (!_off_event.empty())
             MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(_off_event);
-        GlobalManager->SetEventValue("triggers", _trigger_name, 0);
+        GlobalManager->SetEventValue(GetTriggersGroupHandle(), _trigger_handle, 0);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ---------- ObjectGrid Class Functions
+// ----------------------------------------------------------------------------
+
+ObjectGrid::ObjectGrid() :
+    _num_cells_x(0),
+    _num_cells_y(0)
+{}
+
+void ObjectGrid::Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis)
+{
+    // Forget about the objects still referenced
+    for(uint32 i = 0; i < _cells.size(); ++i) {
+        for(uint32 j = 0; j < _cells[i].size(); ++j)
+            _cells[i][j]->_object_grid = NULL;
+    }
+    _cells.clear();
+
+    // Always keep at least one cell so that objects can be registered in any case.
+    _num_cells_x = std::max(1, (num_grid_x_axis + OBJECT_GRID_CELL_LENGTH - 1) / OBJECT_GRID_CELL_LENGTH);
+    _num_cells_y = std::max(1, (num_grid_y_axis + OBJECT_GRID_CELL_LENGTH - 1) / OBJECT_GRID_CELL_LENGTH);
+    _cells.resize(_num_cells_x * _num_cells_y);
+}
+
+void ObjectGrid::AddObject(MapObject* object)
+{
+    if(!object)
+        return;
+
+    if(_cells.empty())
+        Initialize(0, 0);
+
+    // Never register an object twice
+    if(object->_object_grid)
+        object->_object_grid->RemoveObject(object);
+
+    _GetCellRange(object->GetCollisionRectangle(), object->_grid_cell_left, object->_grid_cell_right,
+                  object->_grid_cell_top, object->_grid_cell_bottom);
+    _InsertInCells(object, object->_grid_cell_left, object->_grid_cell_right,
+                   object->_grid_cell_top, object->_grid_cell_bottom);
+    object->_object_grid = this;
+}
+
+void ObjectGrid::RemoveObject(MapObject* object)
+{
+    if(!object || object->_object_grid != this)
+        return;
+
+    _RemoveFromCells(object, object->_grid_cell_left, object->_grid_cell_right,
+                     object->_grid_cell_top, object->_grid_cell_bottom);
+    object->_object_grid = NULL;
+}
+
+void ObjectGrid::UpdateObject(MapObject* object)
+{
+    if(!object || object->_object_grid != this)
+        return;
+
+    uint16 left, right, top, bottom;
+    _GetCellRange(object->GetCollisionRectangle(), left, right, top, bottom);
+
+    // Most of the moves are done within the same cells.
+    if(left == object->_grid_cell_left && right == object->_grid_cell_right &&
+            top == object->_grid_cell_top && bottom == object->_grid_cell_bottom)
+        return;
+
+    _RemoveFromCells(object, object->_grid_cell_left, object->_grid_cell_right,
+                     object->_grid_cell_top, object->_grid_cell_bottom);
+    _InsertInCells(object, left, right, top, bottom);
+    object->_grid_cell_left = left;
+    object->_grid_cell_right = right;
+    object->_grid_cell_top = top;
+    object->_grid_cell_bottom = bottom;
+}
+
+void ObjectGrid::GetObjectsInRectangle(const MapRectangle& rect, std::vector<MapObject*>& objects) const
+{
+    if(_cells.empty())
+        return;
+
+    uint16 left, right, top, bottom;
+    _GetCellRange(rect, left, right, top, bottom);
+
+    size_t first_found = objects.size();
+    for(uint16 y = top; y <= bottom; ++y) {
+        for(uint16 x = left; x <= right; ++x) {
+            const std::vector<MapObject*>& cell = _cells[y * _num_cells_x + x];
+            for(uint32 i = 0; i < cell.size(); ++i) {
+                MapObject* object = cell[i];
+                // An object spanning several cells is only reported by the first cell
+                // both shared by the object and the requested area, so that it is added once.
+                if(x != std::max(left, object->_grid_cell_left) ||
+                        y != std::max(top, object->_grid_cell_top))
+                    continue;
+                objects.push_back(object);
+            }
+        }
+    }
+
+    // Keep the same order the object layers use, so that the results don't depend
+    // on the cells layout when several objects are found.
+    std::sort(objects.begin() + first_found, objects.end(), MapObject_Ptr_Less());
+}
+
+void ObjectGrid::GetObjectsAtPosition(float x, float y, std::vector<MapObject*>& objects) const
+{
+    MapRectangle rect;
+    rect.left = rect.right = x;
+    rect.top = rect.bottom = y;
+    GetObjectsInRectangle(rect, objects);
+}
+
+void ObjectGrid::_GetCellRange(const MapRectangle& rect, uint16& left, uint16& right, uint16& top, uint16& bottom) const
+{
+    const float cell_length = static_cast<float>(OBJECT_GRID_CELL_LENGTH);
+    const float max_x = static_cast<float>(_num_cells_x - 1);
+    const float max_y = static_cast<float>(_num_cells_y - 1);
+
+    // Objects partially out of the map are registered in the border cells.
+    left = static_cast<uint16>(std::min(max_x, std::max(0.0f, floorf(rect.left / cell_length))));
+    right = static_cast<uint16>(std::min(max_x, std::max(0.0f, floorf(rect.right / cell_length))));
+    top = static_cast<uint16>(std::min(max_y, std::max(0.0f, floorf(rect.top / cell_length))));
+    bottom = static_cast<uint16>(std::min(max_y, std::max(0.0f, floorf(rect.bottom / cell_length))));
+}
+
+void ObjectGrid::_InsertInCells(MapObject* object, uint16 left, uint16 right, uint16 top, uint16 bottom)
+{
+    for(uint16 y = top; y <= bottom; ++y) {
+        for(uint16 x = left; x <= right; ++x)
+            _cells[y * _num_cells_x + x].push_back(object);
+    }
+}
+
+void ObjectGrid::_RemoveFromCells(MapObject* object, uint16 left, uint16 right, uint16 top, uint16 bottom)
+{
+    for(uint16 y = top; y <= bottom; ++y) {
+        for(uint16 x = left; x <= right; ++x) {
+            std::vector<MapObject*>& cell = _cells[y * _num_cells_x + x];
+            std::vector<MapObject*>::iterator it = std::find(cell.begin(), cell.end(), object);
+            if(it != cell.end()) {
+                // The order within a cell doesn't matter, so avoid moving the whole cell content.
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
     }
 }
 
@@ -975,7 +1250,12 @@ ObjectSupervisor::ObjectSupervisor() :
     _num_grid_x_axis(0),
     _num_grid_y_axis(0),
     _last_id(1), //! Every object Id must be > 0 since 0 is reserved for speakerless dialogues.
-    _visible_party_member(0)
+    _visible_party_member(0),
+    _flat_ground_objects_max_height(0.0f),
+    _ground_objects_max_height(0.0f),
+    _pass_objects_max_height(0.0f),
+    _sky_objects_max_height(0.0f),
+    _emote_max_height(0.0f)
 {
     _virtual_focus = new VirtualSprite();
     _virtual_focus->SetPosition(0.0f, 0.0f);
@@ -1077,6 +1357,7 @@ void ObjectSupervisor::AddGroundObject(MapObject* object)
         return;
     }
     _ground_objects.push_back(object);
+    _ground_object_grid.AddObject(object);
     _AddObject(object);
 }
 
@@ -1095,6 +1376,7 @@ void ObjectSupervisor::RemoveGroundObject(MapObject* object)
             break;
         }
     }
+    _ground_object_grid.RemoveObject(object);
     _RemoveObject(object);
     delete object;
 }
@@ -1135,6 +1417,7 @@ void ObjectSupervisor::AddSkyObject(MapObject* object)
         return;
     }
     _sky_objects.push_back(object);
+    _sky_object_grid.AddObject(object);
     _AddObject(object);
 }
 
@@ -1153,6 +1436,7 @@ void ObjectSupervisor::RemoveSkyObject(MapObject* object)
             break;
         }
     }
+    _sky_object_grid.RemoveObject(object);
     _RemoveObject(object);
     delete object;
 }
@@ -1186,35 +1470,92 @@ void ObjectSupervisor::_RemoveObject(MapObject* object)
     }
 }
 
+//! \brief Sorts the objects in draw order with an insertion sort, and returns their tallest image height.
+//! As only a few objects move between two frames, the objects are nearly sorted and the cost stays
+//! close to one comparison per object. The sort is also stable, so objects on the same line
+//! don't swap their draw order from one frame to the next.
+static float sortObjects(std::vector<MapObject *>& objects)
+{
+    float max_height = 0.0f;
+    MapObject_Ptr_Less less;
+
+    for(uint32 i = 0; i < objects.size(); ++i) {
+        MapObject *object = objects[i];
+        if(object->img_height > max_height)
+            max_height = object->img_height;
+
+        // Shift the object back to its place among the already sorted ones.
+        uint32 j = i;
+        while(j > 0 && less(object, objects[j - 1])) {
+            objects[j] = objects[j - 1];
+            --j;
+        }
+        objects[j] = object;
+    }
+    return max_height;
+}
+
 void ObjectSupervisor::SortObjects()
 {
-    std::sort(_flat_ground_objects.begin(), _flat_ground_objects.end(), MapObject_Ptr_Less());
-    std::sort(_ground_objects.begin(), _ground_objects.end(), MapObject_Ptr_Less());
-    std::sort(_pass_objects.begin(), _pass_objects.end(), MapObject_Ptr_Less());
-    std::sort(_sky_objects.begin(), _sky_objects.end(), MapObject_Ptr_Less());
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_SORT_OBJECTS);
+
+    _flat_ground_objects_max_height = sortObjects(_flat_ground_objects);
+    _ground_objects_max_height = sortObjects(_ground_objects);
+    _pass_objects_max_height = sortObjects(_pass_objects);
+    _sky_objects_max_height = sortObjects(_sky_objects);
 }
 
-bool ObjectSupervisor::Load(ReadScriptDescriptor &map_file)
+void ObjectSupervisor::_GetVisibleObjectRange(const std::vector<MapObject *>& objects, float max_height, float top_margin,
+                                              uint32& first, uint32& end) const
 {
-    if(!map_file.DoesTableExist("map_grid")) {
-        PRINT_ERROR << "No map grid found in map file: " << map_file.GetFilename() << std::endl;
-        return false;
+    // The objects are sorted by their image bottom: only the ones between the screen top
+    // and the screen bottom plus the tallest image height, and what is drawn above it, may overlap the screen.
+    const MapRectangle &screen_edges = MapMode::CurrentInstance()->GetMapFrame().screen_edges;
+    float bottom_limit = screen_edges.bottom + max_height + top_margin;
+
+    uint32 low = 0;
+    uint32 high = objects.size();
+    while(low < high) {
+        uint32 middle = (low + high) / 2;
+        if(objects[middle]->position.y < screen_edges.top)
+            low = middle + 1;
+        else
+            high = middle;
     }
 
+    first = low;
+    end = low;
+    while(end < objects.size() && objects[end]->position.y <= bottom_limit)
+        ++end;
+}
+
+bool ObjectSupervisor::Load(const MapData &map_data)
+{
     // Construct the collision grid
-    map_file.OpenTable("map_grid");
-    _num_grid_y_axis = map_file.GetTableSize();
-    for(uint16 y = 0; y < _num_grid_y_axis; ++y) {
-        _collision_grid.push_back(std::vector<uint32>());
-        map_file.ReadUIntVector(y, _collision_grid.back());
-    }
-    map_file.CloseTable();
-    _num_grid_x_axis = _collision_grid[0].size();
+    _num_grid_x_axis = map_data.num_grid_x_axis;
+    _num_grid_y_axis = map_data.num_grid_y_axis;
+    _collision_grid = map_data.collision_grid;
+
+    // Set up the collision broadphases now that the map size is known,
+    // and register back the objects that may have been added beforehand.
+    _ground_object_grid.Initialize(_num_grid_x_axis, _num_grid_y_axis);
+    for(uint32 i = 0; i < _ground_objects.size(); ++i)
+        _ground_object_grid.AddObject(_ground_objects[i]);
+    _sky_object_grid.Initialize(_num_grid_x_axis, _num_grid_y_axis);
+    for(uint32 i = 0; i < _sky_objects.size(); ++i)
+        _sky_object_grid.AddObject(_sky_objects[i]);
+
+    _path_abstract_graph.Initialize(_collision_grid);
+    _path_finder.Initialize(_num_grid_x_axis, _num_grid_y_axis, &_path_abstract_graph);
+    _path_finding_service.Initialize(_collision_grid, &_path_abstract_graph);
+    _camera_flow_field.Initialize(_collision_grid);
     return true;
 }
 
 void ObjectSupervisor::Update()
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_OBJECT_UPDATE);
+
     for(uint32 i = 0; i < _flat_ground_objects.size(); ++i)
         _flat_ground_objects[i]->Update();
     for(uint32 i = 0; i < _ground_objects.size(); ++i)
@@ -1233,6 +1574,9 @@ void ObjectSupervisor::Update()
         _zones[i]->Update();
 
     _UpdateAmbientSounds();
+
+    // Hand the path requests submitted by sprites over to the path finding thread.
+    _UpdatePathFindingSnapshot();
 }
 
 void ObjectSupervisor::DrawSavePoints()
@@ -1244,14 +1588,18 @@ void ObjectSupervisor::DrawSavePoints()
 
 void ObjectSupervisor::DrawFlatGroundObjects()
 {
-    for(uint32 i = 0; i < _flat_ground_objects.size(); ++i) {
+    uint32 first, end;
+    _GetVisibleObjectRange(_flat_ground_objects, _flat_ground_objects_max_height, _emote_max_height, first, end);
+    for(uint32 i = first; i < end; ++i) {
         _flat_ground_objects[i]->Draw();
     }
 }
 
 void ObjectSupervisor::DrawGroundObjects(const bool second_pass)
 {
-    for(uint32 i = 0; i < _ground_objects.size(); i++) {
+    uint32 first, end;
+    _GetVisibleObjectRange(_ground_objects, _ground_objects_max_height, _emote_max_height, first, end);
+    for(uint32 i = first; i < end; i++) {
         if(_ground_objects[i]->draw_on_second_pass == second_pass) {
             _ground_objects[i]->Draw();
         }
@@ -1260,30 +1608,48 @@ void ObjectSupervisor::DrawGroundObjects(const bool second_pass)
 
 void ObjectSupervisor::DrawPassObjects()
 {
-    for(uint32 i = 0; i < _pass_objects.size(); i++) {
+    uint32 first, end;
+    _GetVisibleObjectRange(_pass_objects, _pass_objects_max_height, _emote_max_height, first, end);
+    for(uint32 i = first; i < end; i++) {
         _pass_objects[i]->Draw();
     }
 }
 
 void ObjectSupervisor::DrawSkyObjects()
 {
-    for(uint32 i = 0; i < _sky_objects.size(); i++) {
+    uint32 first, end;
+    _GetVisibleObjectRange(_sky_objects, _sky_objects_max_height, _emote_max_height, first, end);
+    for(uint32 i = first; i < end; i++) {
         _sky_objects[i]->Draw();
     }
 }
 
 void ObjectSupervisor::DrawLights()
 {
+    // Gather the visible halos and light flares, as they are all drawn using additive blending.
+    _light_batch.Clear();
     for(uint32 i = 0; i < _halos.size(); ++i)
-        _halos[i]->Draw();
+        _halos[i]->AddToLightBatch(_light_batch);
     for(uint32 i = 0; i < _lights.size(); ++i)
-        _lights[i]->Draw();
+        _lights[i]->AddToLightBatch(_light_batch);
+
+    if(_light_batch.IsEmpty())
+        return;
+
+    int32 previous_blend = VideoManager->GetBlendFlag();
+    VideoManager->Move(0.0f, 0.0f);
+    VideoManager->SetDrawFlags(VIDEO_BLEND_ADD, 0);
+    _light_batch.Draw();
+    VideoManager->SetDrawFlags(previous_blend, 0);
 }
 
 void ObjectSupervisor::DrawDialogIcons()
 {
     MapSprite *mapSprite;
-    for(uint32 i = 0; i < _ground_objects.size(); i++) {
+    uint32 first, end;
+    float icon_height = MapMode::CurrentInstance()->GetDialogueIcon().GetHeight();
+    _GetVisibleObjectRange(_ground_objects, _ground_objects_max_height, icon_height, first, end);
+    for(uint32 i = first; i < end; i++) {
         if(_ground_objects[i]->GetObjectType() == SPRITE_TYPE) {
             mapSprite = static_cast<MapSprite *>(_ground_objects[i]);
             mapSprite->DrawDialog();
@@ -1368,21 +1734,21 @@ MapObject *ObjectSupervisor::FindNearestInteractionObject(const VirtualSprite *s
         return NULL;
     }
 
-    // Go through all objects and determine which (if any) lie within the search area
+    // Go through the objects near the search area and determine which (if any) lie within it
 
     // A vector to hold objects which are inside the search area (either partially or fully)
     std::vector<MapObject *> valid_objects;
-    // A pointer to the vector of objects to search
-    std::vector<MapObject *>* search_vector = NULL;
+    // The objects whose object grid cells overlap the search area
+    std::vector<MapObject *> search_vector;
 
     // Only search the object layer that the sprite resides on.
     // Note that we do not consider searching the pass layer.
     if(sprite->sky_object)
-        search_vector = &_sky_objects;
+        _sky_object_grid.GetObjectsInRectangle(search_area, search_vector);
     else
-        search_vector = &_ground_objects;
+        _ground_object_grid.GetObjectsInRectangle(search_area, search_vector);
 
-    for(std::vector<MapObject *>::iterator it = (*search_vector).begin(); it != (*search_vector).end(); ++it) {
+    for(std::vector<MapObject *>::iterator it = search_vector.begin(); it != search_vector.end(); ++it) {
         if(*it == sprite)  // Don't allow the sprite itself to be considered in the search
             continue;
 
@@ -1521,21 +1887,21 @@ COLLISION_TYPE ObjectSupervisor::DetectCollision(MapObject* object,
     if(!object->sky_object && object->collision_mask & WALL_COLLISION) {
         // Determine if the object's collision rectangle overlaps any unwalkable tiles
         // Note that because the sprite's collision rectangle was previously determined to be within the map bounds,
-        // the map grid tile indeces referenced in this loop are all valid entries and do not need to be checked for out-of-bounds conditions
-        for(uint32 y = static_cast<uint32>(sprite_rect.top); y <= static_cast<uint32>(sprite_rect.bottom); ++y) {
-            for(uint32 x = static_cast<uint32>(sprite_rect.left); x <= static_cast<uint32>(sprite_rect.right); ++x) {
-                // Checks the collision grid at the row-column at the object's current context
-                if(_collision_grid[y][x] > 0)
-                    return WALL_COLLISION;
-            }
-        }
+        // the map grid elements tested here are all valid entries and do not need to be checked for out-of-bounds conditions
+        if(_collision_grid.IsWallInRectangle(static_cast<uint32>(sprite_rect.left), static_cast<uint32>(sprite_rect.top),
+                                             static_cast<uint32>(sprite_rect.right), static_cast<uint32>(sprite_rect.bottom)))
+            return WALL_COLLISION;
     }
 
-    std::vector<MapObject *>* objects = object->sky_object ?
-                                        &_sky_objects : &_ground_objects;
+    // Only test the objects registered near the collision rectangle.
+    _nearby_objects.clear();
+    if(object->sky_object)
+        _sky_object_grid.GetObjectsInRectangle(sprite_rect, _nearby_objects);
+    else
+        _ground_object_grid.GetObjectsInRectangle(sprite_rect, _nearby_objects);
 
     std::vector<vt_map::private_map::MapObject *>::const_iterator it, it_end;
-    for(it = objects->begin(), it_end = objects->end(); it != it_end; ++it) {
+    for(it = _nearby_objects.begin(), it_end = _nearby_objects.end(); it != it_end; ++it) {
         MapObject *collision_object = *it;
         // Check if the object exists and has the no_collision property enabled
         if(!collision_object || collision_object->collision_mask == NO_COLLISION)
@@ -1565,183 +1931,141 @@ COLLISION_TYPE ObjectSupervisor::DetectCollision(MapObject* object,
     return NO_COLLISION;
 } // bool ObjectSupervisor::DetectCollision(VirtualSprite* sprite, float x, float y, MapObject** collision_object_ptr)
 
-Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const MapPosition &destination, uint32 max_cost)
+/** \brief Detects the path finding collisions of a sprite with the map walls and objects.
+*** Used by ObjectSupervisor::FindPath() to search paths on the current map state.
+**/
+class SpriteCollisionDetector : public PathCollisionDetector
 {
-    // NOTE: Refer to the implementation of the A* algorithm to understand
-    // what all these lists and score values are for.
-    static const uint32 basic_gcost = 10;
+public:
+    SpriteCollisionDetector(ObjectSupervisor *object_supervisor, VirtualSprite *sprite) :
+        _object_supervisor(object_supervisor),
+        _sprite(sprite)
+    {}
+
+    COLLISION_TYPE DetectCollision(float x, float y) {
+        return _object_supervisor->DetectCollision(_sprite, x, y);
+    }
 
+    bool IsStoppedByWalls() const {
+        return !_sprite->sky_object && (_sprite->collision_mask & WALL_COLLISION);
+    }
+
+private:
+    ObjectSupervisor *_object_supervisor;
+    VirtualSprite *_sprite;
+}; // class SpriteCollisionDetector
+
+Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const MapPosition &destination, uint32 max_cost)
+{
     // NOTE(bis): On the outer scope, we'll use float based positions,
     // but we still use integer positions for path finding.
     Path path;
 
-    if(!MapMode::CurrentInstance()->GetObjectSupervisor()->IsWithinMapBounds(sprite)) {
-        IF_PRINT_WARNING(MAP_DEBUG) << "Sprite position is invalid" << std::endl;
+    if(!_IsValidPathRequest(sprite, destination))
         return path;
-    }
 
     // Return when the destination is unreachable
     if(DetectCollision(sprite, destination.x, destination.y) == WALL_COLLISION)
         return path;
 
-    if(!MapMode::CurrentInstance()->GetObjectSupervisor()->IsWithinMapBounds(destination.x, destination.y)) {
-        IF_PRINT_WARNING(MAP_DEBUG) << "Invalid destination coordinates" << std::endl;
-        return path;
-    }
-
     // The starting node of this path discovery
     PathNode source_node(static_cast<int16>(sprite->GetXPosition()), static_cast<int16>(sprite->GetYPosition()));
-    // The ending node.
-    PathNode dest(static_cast<int16>(destination.x), static_cast<int16>(destination.y));
-
-    // Check that the source node is not the same as the destination node
-    if(source_node == dest) {
-        PRINT_ERROR << "source node coordinates are the same as the destination" << std::endl;
-        // return an empty path.
-        return path;
-    }
-
-    std::vector<PathNode> open_list;
-    std::vector<PathNode> closed_list;
 
-    // The current "best node"
-    PathNode best_node;
-    // Used to hold the eight adjacent nodes
-    PathNode nodes[8];
+    SpriteCollisionDetector collision_detector(this, sprite);
+    path = _path_finder.FindPath(source_node, destination, max_cost, collision_detector);
 
-    // Temporary delta variables used in calculation of a node's heuristic (h score)
-    uint32 x_delta, y_delta;
-    // The number to add to a node's g_score, depending on whether it is a lateral or diagonal movement
-    int16 g_add;
+    std::string messages = _path_finder.TakeMessages();
+    if(!messages.empty())
+        IF_PRINT_WARNING(MAP_DEBUG) << messages;
+    return path;
+} // Path ObjectSupervisor::FindPath(const VirtualSprite* sprite, const MapPosition& destination)
 
-    open_list.push_back(source_node);
+uint32 ObjectSupervisor::RequestPath(VirtualSprite *sprite, const MapPosition &destination, uint32 max_cost)
+{
+    if(!_IsValidPathRequest(sprite, destination))
+        return 0;
 
-    // We will try to keep the original offset all along.
-    float offset_x = GetFloatFraction(destination.x);
-    float offset_y = GetFloatFraction(destination.y);
+    return _path_finding_service.RequestPath(sprite->GetXPosition(), sprite->GetYPosition(), destination, max_cost,
+                                             sprite->GetCollHalfWidth(), sprite->GetCollHeight(),
+                                             sprite->GetCollisionMask(), sprite->GetObjectID());
+}
 
-    while(open_list.empty() == false) {
-        sort(open_list.begin(), open_list.end());
-        best_node = open_list.back();
-        open_list.pop_back();
-        closed_list.push_back(best_node);
+bool ObjectSupervisor::RetrievePath(uint32 request_id, Path &path)
+{
+    return _path_finding_service.RetrievePath(request_id, path);
+}
 
-        // Check if destination has been reached, and break out of the loop if so
-        if(best_node == dest)
-            break;
+void ObjectSupervisor::CancelPathRequest(uint32 request_id)
+{
+    _path_finding_service.CancelRequest(request_id);
+}
 
-        // Setup the coordinates of the 8 adjacent nodes to the best node
-        nodes[0].tile_x = best_node.tile_x - 1;
-        nodes[0].tile_y = best_node.tile_y;
-        nodes[1].tile_x = best_node.tile_x + 1;
-        nodes[1].tile_y = best_node.tile_y;
-        nodes[2].tile_x = best_node.tile_x;
-        nodes[2].tile_y = best_node.tile_y - 1;
-        nodes[3].tile_x = best_node.tile_x;
-        nodes[3].tile_y = best_node.tile_y + 1;
-        nodes[4].tile_x = best_node.tile_x - 1;
-        nodes[4].tile_y = best_node.tile_y - 1;
-        nodes[5].tile_x = best_node.tile_x - 1;
-        nodes[5].tile_y = best_node.tile_y + 1;
-        nodes[6].tile_x = best_node.tile_x + 1;
-        nodes[6].tile_y = best_node.tile_y - 1;
-        nodes[7].tile_x = best_node.tile_x + 1;
-        nodes[7].tile_y = best_node.tile_y + 1;
-
-        // Check the eight adjacent nodes
-        for(uint8 i = 0; i < 8; ++i) {
-            // ---------- (A): Check if all tiles are walkable
-            // Don't use 0.0f here for both since errors at the border between
-            // two positions may occure, especially when running.
-            COLLISION_TYPE collision_type = DetectCollision(sprite,
-                                            ((float)nodes[i].tile_x) + offset_x,
-                                            ((float)nodes[i].tile_y) + offset_y);
-
-            // Can't go through walls.
-            if(collision_type == WALL_COLLISION)
-                continue;
+bool ObjectSupervisor::GetCameraPursuitPosition(VirtualSprite *sprite, MapPosition &position)
+{
+    VirtualSprite *camera = MapMode::CurrentInstance()->GetCamera();
+    if(!sprite || !camera)
+        return false;
 
-            // ---------- (B): If this point has been reached, the node is valid for the sprite to move to
-            // If this is a lateral adjacent node, g_score is +10, otherwise diagonal adjacent node is +14
-            if(i < 4)
-                g_add = basic_gcost;
-            else
-                g_add = basic_gcost + 4;
+    // The field is only computed again once the camera sprite reached another grid element.
+    int16 root_x = static_cast<int16>(camera->GetXPosition());
+    int16 root_y = static_cast<int16>(camera->GetYPosition());
+    if(!_camera_flow_field.IsRootedAt(root_x, root_y))
+        _camera_flow_field.Update(root_x, root_y);
 
-            // Add some g cost when there is another sprite there,
-            // so the NPC try to get around when possible,
-            // but will still go through it when there are no other choices.
-            if(collision_type == CHARACTER_COLLISION
-                    || collision_type == ENEMY_COLLISION)
-                g_add += basic_gcost * 2;
+    int16 next_x, next_y;
+    if(!_camera_flow_field.GetNextNode(static_cast<int16>(sprite->GetXPosition()),
+                                       static_cast<int16>(sprite->GetYPosition()), next_x, next_y))
+        return false;
 
-            // If the path has reached the maximum length requested, we abort the path
-            if (max_cost > 0 && (uint32)(best_node.g_score + g_add) >= max_cost * basic_gcost)
-                return path;
+    position.x = static_cast<float>(next_x) + 0.5f;
+    position.y = static_cast<float>(next_y) + 0.5f;
+    return true;
+}
 
-            // ---------- (C): Check if the node is already in the closed list
-            if(find(closed_list.begin(), closed_list.end(), nodes[i]) != closed_list.end())
-                continue;
+bool ObjectSupervisor::_IsValidPathRequest(VirtualSprite *sprite, const MapPosition &destination) const
+{
+    if(!sprite || !IsWithinMapBounds(sprite)) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "Sprite position is invalid" << std::endl;
+        return false;
+    }
 
-            // Set the node's parent and calculate its g_score
-            nodes[i].parent_x = best_node.tile_x;
-            nodes[i].parent_y = best_node.tile_y;
-            nodes[i].g_score = best_node.g_score + g_add;
-
-            // ---------- (D): Check to see if the node is already on the open list and update it if necessary
-            std::vector<PathNode>::iterator iter = std::find(open_list.begin(), open_list.end(), nodes[i]);
-            if(iter != open_list.end()) {
-                // If its G is higher, it means that the path we are on is better, so switch the parent
-                if(iter->g_score > nodes[i].g_score) {
-                    iter->g_score = nodes[i].g_score;
-                    iter->f_score = nodes[i].g_score + iter->h_score;
-                    iter->parent_x = nodes[i].parent_x;
-                    iter->parent_y = nodes[i].parent_y;
-                }
-            }
-            // ---------- (E): Add the new node to the open list
-            else {
-                // Calculate the H and F score of the new node (the heuristic used is diagonal)
-                x_delta = abs(dest.tile_x - nodes[i].tile_x);
-                y_delta = abs(dest.tile_y - nodes[i].tile_y);
-                if(x_delta > y_delta)
-                    nodes[i].h_score = 14 * y_delta + 10 * (x_delta - y_delta);
-                else
-                    nodes[i].h_score = 14 * x_delta + 10 * (y_delta - x_delta);
-
-                nodes[i].f_score = nodes[i].g_score + nodes[i].h_score;
-                open_list.push_back(nodes[i]);
-            }
-        } // for (uint8 i = 0; i < 8; ++i)
-    } // while (open_list.empty() == false)
+    if(!IsWithinMapBounds(destination.x, destination.y)) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "Invalid destination coordinates" << std::endl;
+        return false;
+    }
 
-    if(open_list.empty() == true) {
-        IF_PRINT_WARNING(MAP_DEBUG) << "could not find path to destination" << std::endl;
-        return path;
+    // Check that the source node is not the same as the destination node
+    if(static_cast<int16>(sprite->GetXPosition()) == static_cast<int16>(destination.x) &&
+            static_cast<int16>(sprite->GetYPosition()) == static_cast<int16>(destination.y)) {
+        PRINT_ERROR << "source node coordinates are the same as the destination" << std::endl;
+        return false;
     }
 
-    // Add the destination node to the vector.
-    path.push_back(destination);
+    return true;
+}
 
-    // Retain the last node parent, and remove it from the closed list
-    int16 parent_x = best_node.parent_x;
-    int16 parent_y = best_node.parent_y;
-    closed_list.pop_back();
+void ObjectSupervisor::_UpdatePathFindingSnapshot()
+{
+    if(!_path_finding_service.IsSnapshotNeeded())
+        return;
 
-    // Go backwards through the closed list following the parent nodes to construct the path
-    for(std::vector<PathNode>::iterator iter = closed_list.end() - 1; iter != closed_list.begin(); --iter) {
-        if(iter->tile_y == parent_y && iter->tile_x == parent_x) {
-            MapPosition next_pos(((float)iter->tile_x) + offset_x, ((float)iter->tile_y) + offset_y);
-            path.push_back(next_pos);
+    _path_finding_service.StartSnapshot();
 
-            parent_x = iter->parent_x;
-            parent_y = iter->parent_y;
-        }
+    // The objects acting as walls are merged into the walls grid, while the
+    // sprites keep their rectangle, as a given search may ignore them.
+    for(uint32 i = 0; i < _ground_objects.size(); ++i) {
+        MapObject *object = _ground_objects[i];
+        if(object->collision_mask == NO_COLLISION)
+            continue;
+        COLLISION_TYPE collision = GetCollisionFromObjectType(object);
+        if(collision == WALL_COLLISION)
+            _path_finding_service.AddSnapshotWall(object->GetCollisionRectangle());
+        else if(collision != NO_COLLISION)
+            _path_finding_service.AddSnapshotSprite(object->GetCollisionRectangle(), collision, object->GetObjectID());
     }
-    std::reverse(path.begin(), path.end());
 
-    return path;
-} // Path ObjectSupervisor::FindPath(const VirtualSprite* sprite, const MapPosition& destination)
+    _path_finding_service.PublishSnapshot();
+}
 
 void ObjectSupervisor::ReloadVisiblePartyMember()
 {
@@ -1789,7 +2113,7 @@ void ObjectSupervisor::DrawCollisionArea(const MapFrame *frame)
                 x < static_cast<uint32>((frame->tile_x_start + frame->num_draw_x_axis) * 2); ++x) {
 
             // Draw the collision rectangle
-            if(_collision_grid[y][x] > 0)
+            if(_collision_grid.IsWall(x, y))
                 VideoManager->DrawRectangle(1.0f, 1.0f, Color(1.0f, 0.0f, 0.0f, 0.6f));
 
             VideoManager->MoveRelative(1.0f, 0.0f);
@@ -1807,8 +2131,12 @@ bool ObjectSupervisor::IsStaticCollision(float x, float y)
     if (IsMapCollision(static_cast<uint32>(x), static_cast<uint32>(y)))
         return true;
 
+    // Only test the objects registered around the position.
+    _nearby_objects.clear();
+    _ground_object_grid.GetObjectsAtPosition(x, y, _nearby_objects);
+
     std::vector<vt_map::private_map::MapObject *>::const_iterator it, it_end;
-    for(it = _ground_objects.begin(), it_end = _ground_objects.end(); it != it_end; ++it) {
+    for(it = _nearby_objects.begin(), it_end = _nearby_objects.end(); it != it_end; ++it) {
         MapObject *collision_object = *it;
         // Check if the object exists and has the no_collision property enabled
         if(!collision_object || collision_object->collision_mask == NO_COLLISION)
@@ -18,8 +18,13 @@
 #ifndef __MAP_OBJECTS_HEADER__
 #define __MAP_OBJECTS_HEADER__
 
+#include "modes/map/map_path_finding.h"
 #include "modes/map/map_treasure.h"
 
+#include "engine/video/image_batch.h"
+
+#include "utils/utils_strings.h"
+
 namespace vt_script {
 class ReadScriptDescriptor;
 }
@@ -41,8 +46,10 @@ namespace private_map
 {
 
 class ContextZone;
+class MapData;
 class MapSprite;
 class MapZone;
+class ObjectGrid;
 class VirtualSprite;
 
 /** ****************************************************************************
@@ -77,6 +84,8 @@ class VirtualSprite;
 *** ***************************************************************************/
 class MapObject
 {
+    friend class ObjectGrid;
+
 public:
     MapObject();
 
@@ -175,11 +184,18 @@ public:
     *** \return True if the object should be drawn.
     *** \note This function also moves the draw cursor to the proper position if the object should be drawn
     ***
+    *** \param top_margin The height drawn above the object image, such as an emote or a dialogue icon.
+    ***
     *** This method performs the common drawing operations of identifying whether or not the object
     *** is visible on the screen and moving the drawing cursor to its location. The children classes
     *** of this class may choose to make use of it (or not).
     **/
-    bool ShouldDraw();
+    bool ShouldDraw(float top_margin = 0.0f);
+
+    /** \brief Tells whether the object is visible and its image intersects the screen, without moving the draw cursor.
+    *** \param top_margin The height drawn above the object image, such as an emote or a dialogue icon.
+    **/
+    bool IsVisibleOnScreen(float top_margin = 0.0f) const;
     //@}
 
     //! \brief Retrieves the object type identifier
@@ -234,14 +250,17 @@ public:
     void SetPosition(float x, float y) {
         position.x = x;
         position.y = y;
+        _UpdateObjectGrid();
     }
 
     void SetXPosition(float x) {
         position.x = x;
+        _UpdateObjectGrid();
     }
 
     void SetYPosition(float y) {
         position.y = y;
+        _UpdateObjectGrid();
     }
 
     void SetImgHalfWidth(float width) {
@@ -254,10 +273,12 @@ public:
 
     void SetCollHalfWidth(float collision) {
         coll_half_width = collision;
+        _UpdateObjectGrid();
     }
 
     void SetCollHeight(float collision) {
         coll_height = collision;
+        _UpdateObjectGrid();
     }
 
     void SetUpdatable(bool update) {
@@ -293,6 +314,15 @@ public:
         return position.y;
     }
 
+    /** \brief Returns the position the object is drawn at
+    *** When the object moved on the last update step, its position is interpolated from
+    *** the previous one, so that the movement stays smooth whatever the frame rate.
+    **/
+    //@{
+    float GetDrawXPosition() const;
+    float GetDrawYPosition() const;
+    //@}
+
     float GetImgHalfWidth() const {
         return img_half_width;
     }
@@ -344,6 +374,10 @@ protected:
     //! \brief This is used to identify the type of map object for inheriting classes.
     MAP_OBJECT_TYPE _object_type;
 
+    //! \brief The position before the last move, and the update step the object moved on.
+    MapPosition _previous_position;
+    uint32 _previous_position_step;
+
     //! \brief the emote animation to play
     vt_video::AnimatedImage* _emote_animation;
 
@@ -359,6 +393,26 @@ protected:
 
     //! \brief Takes care of drawing the emote animation.
     void _DrawEmote();
+
+    //! \brief Returns the height the current emote reaches above the object image, or 0 when none.
+    float _GetEmoteHeight() const;
+
+    //! \brief Keeps the current position to interpolate the drawing from, before moving the object.
+    void _KeepPreviousPosition();
+
+    /** \brief Tells the object grid the object is registered in that its collision rectangle changed.
+    *** Called by the position and collision size setters so that the collision broadphase
+    *** always reflects where the object actually is.
+    **/
+    void _UpdateObjectGrid();
+
+private:
+    //! \brief The object grid the object is currently registered in, or NULL if none.
+    ObjectGrid* _object_grid;
+
+    //! \brief The range of object grid cells the object is registered in (inclusive).
+    //! Only meaningful when _object_grid is not NULL.
+    uint16 _grid_cell_left, _grid_cell_right, _grid_cell_top, _grid_cell_bottom;
 }; // class MapObject
 
 
@@ -559,6 +613,10 @@ public:
     //! \note the actual image resources is handled by the main map object.
     void Draw();
 
+    /** \brief Adds the halo current frame to the batch of the map lights, if it is visible.
+    *** \param batch The light batch, whose origin is the top left corner of the screen.
+    **/
+    void AddToLightBatch(vt_video::ImageBatch &batch) const;
 
 private:
     //! \brief A reference to the current map save animation.
@@ -598,6 +656,11 @@ public:
     *** \param rect A MapRectangle object storing the image rectangle data
     **/
     MapRectangle GetImageRectangle() const;
+
+    /** \brief Adds the light main flare and secondary flares to the batch of the map lights, if visible.
+    *** \param batch The light batch, whose origin is the top left corner of the screen.
+    **/
+    void AddToLightBatch(vt_video::ImageBatch &batch) const;
 private:
     //! Updates the angle and distance from the camera viewpoint
     void _UpdateLightAngle();
@@ -860,6 +923,9 @@ private:
     //! \brief The treasure object name
     std::string _trigger_name;
 
+    //! \brief The handle of the trigger name, used to look its state up in the 'triggers' event group
+    vt_utils::StringId _trigger_handle;
+
     //! The trigger state (false == off)
     bool _trigger_state;
 
@@ -878,6 +944,72 @@ private:
     void _LoadState();
 }; // class TreasureObject : public PhysicalObject
 
+/** ****************************************************************************
+*** \brief A uniform grid used as a broadphase for object collision queries
+***
+*** The map is divided into square cells of OBJECT_GRID_CELL_LENGTH collision
+*** grid elements, and every registered object is referenced by each cell its
+*** collision rectangle overlaps. Area queries then only have to consider the
+*** objects stored in the few cells they touch, making their cost depend on the
+*** local object density rather than on the total number of objects on the map.
+***
+*** Objects keep track of the cells they are registered in, and tell the grid
+*** about any position or collision size change through their setters.
+***
+*** \note The grid doesn't own the objects. They must be removed from it before
+*** being deleted.
+*** ***************************************************************************/
+class ObjectGrid
+{
+public:
+    ObjectGrid();
+
+    /** \brief Sets up the grid cells for the given map dimensions, clearing any previous content.
+    *** \param num_grid_x_axis The number of collision grid columns of the map.
+    *** \param num_grid_y_axis The number of collision grid rows of the map.
+    **/
+    void Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis);
+
+    //! \brief Registers the object in every cell its collision rectangle overlaps.
+    void AddObject(MapObject* object);
+
+    //! \brief Unregisters the object from the grid.
+    void RemoveObject(MapObject* object);
+
+    //! \brief Moves the object to its new cells if its collision rectangle changed of cells.
+    void UpdateObject(MapObject* object);
+
+    /** \brief Gets the objects whose cells overlap the given rectangle.
+    *** \param rect The map area to query.
+    *** \param objects The vector the found objects are appended to. Each object is added only once,
+    *** and the vector is sorted in draw order, as the object layers are.
+    *** \note This is only a broadphase test: the found objects' collision rectangles
+    *** still have to be tested against the area.
+    **/
+    void GetObjectsInRectangle(const MapRectangle& rect, std::vector<MapObject*>& objects) const;
+
+    /** \brief Gets the objects whose cells contain the given position.
+    *** \see GetObjectsInRectangle()
+    **/
+    void GetObjectsAtPosition(float x, float y, std::vector<MapObject*>& objects) const;
+
+private:
+    //! \brief The number of cell columns and rows of the grid.
+    uint16 _num_cells_x, _num_cells_y;
+
+    /** \brief The objects referenced in each cell.
+    *** \Note A cell is stored like this: _cells[y * _num_cells_x + x]
+    **/
+    std::vector<std::vector<MapObject*> > _cells;
+
+    //! \brief Computes the range of cells overlapped by the given rectangle, clamped to the grid.
+    void _GetCellRange(const MapRectangle& rect, uint16& left, uint16& right, uint16& top, uint16& bottom) const;
+
+    //! \brief Adds/Removes an object reference in the given range of cells.
+    void _InsertInCells(MapObject* object, uint16 left, uint16 right, uint16 top, uint16 bottom);
+    void _RemoveFromCells(MapObject* object, uint16 left, uint16 right, uint16 top, uint16 bottom);
+}; // class ObjectGrid
+
 /** ****************************************************************************
 *** \brief A helper class to MapMode responsible for management of all object and sprite data
 ***
@@ -933,18 +1065,25 @@ public:
     void AddSkyObject(MapObject* object);
     void RemoveSkyObject(MapObject* object);
 
-    //! \brief Sorts objects on all three layers according to their draw order
+    /** \brief Sorts objects on all the layers according to their draw order
+    *** The layers stay sorted from one frame to the next, so only the objects
+    *** that moved get shifted to their new place.
+    **/
     void SortObjects();
 
+    /** \brief Makes the layers drawing take an emote shown above an object image into account.
+    *** \param height The height the emote reaches above the object image.
+    **/
+    void UpdateEmoteMaxHeight(float height) {
+        if(height > _emote_max_height)
+            _emote_max_height = height;
+    }
+
     /** \brief Loads the collision grid data and saved state of all map objects
-    *** \param map_file A reference to the open map script file
+    *** \param map_data The loaded map data
     *** \return Whether the collision data loading was successful.
-    ***
-    *** The file must be open prior to making this call and additionally must
-    *** be at the highest level scope (i.e., there are no actively open tables
-    *** in the script descriptor object).
     **/
-    bool Load(vt_script::ReadScriptDescriptor &map_file);
+    bool Load(const MapData &map_data);
 
     //! \brief Updates the state of all map zones and objects
     void Update();
@@ -1033,9 +1172,45 @@ public:
     *** which map grid elements are walkable.
     ***
     *** \note If an error is detected or a path could not be found, the function will empty the path vector before returning
+    *** \note Among several paths of the same cost, the one returned may differ from the former
+    *** implementation, see PathFinder::FindPath().
+    *** \note On long distances, the search goes through the abstract graph first. When objects block
+    *** the way or the destination, it falls back to a whole grid search, costing more than before.
     **/
     Path FindPath(private_map::VirtualSprite *sprite, const MapPosition &destination, uint32 max_cost = 0);
 
+    /** \brief Submits a path request computed asynchronously
+    *** \param sprite A pointer of the sprite to find the path for
+    *** \param destination The destination coordinates
+    *** \param max_cost Tells how far a path node can be computed agains the starting path node.
+    *** If this param is equal to 0, there is no limitation.
+    *** \return The request id to give to RetrievePath(), or 0 if the request is invalid.
+    ***
+    *** Unlike FindPath(), the path is computed in a worker thread and only takes
+    *** the walls and static objects into account.
+    *** \see PathFindingService
+    **/
+    uint32 RequestPath(private_map::VirtualSprite *sprite, const MapPosition &destination, uint32 max_cost = 0);
+
+    /** \brief Retrieves the result of a path request
+    *** \param request_id The request id given by RequestPath()
+    *** \param path Receives the path found, or an empty path if none could be found.
+    *** \return false while the path is still being computed.
+    **/
+    bool RetrievePath(uint32 request_id, Path &path);
+
+    //! \brief Cancels a path request. Its id must not be used afterwards.
+    void CancelPathRequest(uint32 request_id);
+
+    /** \brief Gets the position a sprite should walk to in order to reach the camera sprite
+    *** \param sprite The sprite chasing the camera sprite.
+    *** \param position Receives the center of the next grid element to walk to.
+    *** \return false if the sprite should rather walk straight to the camera sprite:
+    *** when next to it, off screen or when walls separate them.
+    *** \see PathFlowField
+    **/
+    bool GetCameraPursuitPosition(private_map::VirtualSprite *sprite, MapPosition &position);
+
     /** \brief Returns the pointer to the virtual focus.
     **/
     private_map::VirtualSprite *VirtualFocus() {
@@ -1093,7 +1268,7 @@ public:
     //! \brief checks if the location on the grid has a simple map collision. This is different from
     //! IsStaticCollision, in that it DOES NOT check static objects, but only the collision value for the map
     bool IsMapCollision(uint32 x, uint32 y)
-    { return (_collision_grid[y][x] > 0); }
+    { return _collision_grid.IsWall(x, y); }
 
     //! \brief returns a const reference to the ground objects in
     const std::vector<MapObject *>& GetGroundObjects() const
@@ -1120,6 +1295,22 @@ private:
     //! \brief Debug: Draws the map zones in orange
     void _DrawMapZones();
 
+    //! \brief Tells whether a path can be searched for the sprite to the given destination.
+    bool _IsValidPathRequest(VirtualSprite *sprite, const MapPosition &destination) const;
+
+    //! \brief Builds and publishes the path finding snapshot when sprites submitted path requests.
+    void _UpdatePathFindingSnapshot();
+
+    /** \brief Finds the objects of a sorted layer which may be visible in the current map frame.
+    *** \param objects The layer objects, sorted in draw order.
+    *** \param max_height The tallest image height of the layer objects.
+    *** \param top_margin The height drawn above the object images, such as the emotes or dialogue icons.
+    *** \param first, end Set to the range of objects which may be visible: [first, end[
+    *** The objects within the range still have to check whether they are visible when drawn.
+    **/
+    void _GetVisibleObjectRange(const std::vector<MapObject *>& objects, float max_height, float top_margin,
+                                uint32& first, uint32& end) const;
+
     //! \brief Wrapper to add an object in the all objects vector.
     //! This should only be called by corresponding public Add*Object() functions.
     void _AddObject(MapObject* object);
@@ -1154,13 +1345,8 @@ private:
     **/
     private_map::MapSprite *_visible_party_member;
 
-    /** \brief A 2D vector indicating which grid element on the map sprites may be occupied by objects.
-    *** Each bit of each element in this grid corresponds to a context. So all together this entire grid
-    *** stores the collision information for all 32 possible map contexts.
-    *** \Note A position in this member is stored like this:
-    *** _collision_grid[y][x]
-    **/
-    std::vector<std::vector<uint32> > _collision_grid;
+    //! \brief Indicates which grid elements of the map are walls, that sprites can't walk on.
+    private_map::CollisionGrid _collision_grid;
 
     /** \brief A map containing pointers to all of the sprites on a map.
     *** This map does not include a pointer to the _virtual_focus object. The
@@ -1197,6 +1383,19 @@ private:
     **/
     std::vector<MapObject *> _sky_objects;
 
+    /** \brief The tallest image height of the objects in each layer, computed when sorting them.
+    *** Used to find which objects of a layer may be visible without testing all of them.
+    **/
+    //@{
+    float _flat_ground_objects_max_height;
+    float _ground_objects_max_height;
+    float _pass_objects_max_height;
+    float _sky_objects_max_height;
+    //@}
+
+    //! \brief The tallest height an emote reached above its object image, so that it isn't culled with it.
+    float _emote_max_height;
+
     //! \brief Ambient sound objects, that plays a sound with a volume according
     //! to the distance with the camera.
     //! \note sound objects are not registered in _all_objects.
@@ -1210,8 +1409,36 @@ private:
     std::vector<Halo *> _halos;
     std::vector<Light *> _lights;
 
+    //! \brief The visible halos and light flares, gathered every frame to be drawn
+    //! with one additive draw call per texture sheet.
+    vt_video::ImageBatch _light_batch;
+
     //! \brief Container for all zones used in this map
     std::vector<MapZone *> _zones;
+
+    /** \brief The collision broadphases of the ground and sky object layers.
+    *** They are used to only test the objects near a given map area when detecting collisions
+    *** or searching for objects, instead of going through the whole object layer.
+    **/
+    ObjectGrid _ground_object_grid;
+    ObjectGrid _sky_object_grid;
+
+    //! \brief The cluster entrances graph built from the collision grid, used for long distance paths.
+    //! Declared before the path finders, as it must outlive the path finding thread.
+    PathAbstractGraph _path_abstract_graph;
+
+    //! \brief The path finder used by FindPath(), reusing its node data across searches.
+    PathFinder _path_finder;
+
+    //! \brief Computes the paths requested through RequestPath() in a worker thread.
+    PathFindingService _path_finding_service;
+
+    //! \brief The walking costs to the camera sprite, shared by all the sprites chasing it.
+    PathFlowField _camera_flow_field;
+
+    //! \brief Objects found in the object grids by the collision functions.
+    //! Kept as a member to avoid reallocating it at each collision test.
+    std::vector<MapObject *> _nearby_objects;
 }; // class ObjectSupervisor
 
 } // namespace private_map
@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_benchmark.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the map path finding benchmark
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "modes/map/map_path_benchmark.h"
+
+#include "modes/map/map_data.h"
+#include "modes/map/map_path_finding.h"
+
+#include "engine/profiler.h"
+
+#include "utils/utils_numeric.h"
+
+using namespace vt_utils;
+using namespace vt_system;
+using namespace vt_map::private_map;
+
+namespace vt_map
+{
+
+//! \brief The collision rectangle of the common characters, in collision grid elements.
+static const float BENCHMARK_COLL_HALF_WIDTH = 0.95f;
+static const float BENCHMARK_COLL_HEIGHT = 1.9f;
+
+//! \brief The max cost given by the enemies to their path searches.
+static const uint32 BENCHMARK_MAX_COST = 20;
+
+//! \brief The seed of the source and destination pairs, fixed so that the runs can be compared.
+static const uint32 BENCHMARK_SEED = 12345;
+
+/** \brief Detects the collisions of a common character with the collision grid walls only
+*** This is what the path searches cost on an empty map.
+**/
+class GridCollisionDetector : public PathCollisionDetector
+{
+public:
+    explicit GridCollisionDetector(const CollisionGrid &collision_grid) :
+        _collision_grid(collision_grid),
+        _num_tests(0)
+    {}
+
+    COLLISION_TYPE DetectCollision(float x, float y) {
+        ++_num_tests;
+        MapRectangle rect(x - BENCHMARK_COLL_HALF_WIDTH, x + BENCHMARK_COLL_HALF_WIDTH, y - BENCHMARK_COLL_HEIGHT, y);
+        if(rect.left < 0.0f || rect.right >= static_cast<float>(_collision_grid.GetNumGridXAxis()) ||
+                rect.top < 0.0f || rect.bottom >= static_cast<float>(_collision_grid.GetNumGridYAxis()))
+            return WALL_COLLISION;
+
+        if(_collision_grid.IsWallInRectangle(static_cast<uint32>(rect.left), static_cast<uint32>(rect.top),
+                                             static_cast<uint32>(rect.right), static_cast<uint32>(rect.bottom)))
+            return WALL_COLLISION;
+        return NO_COLLISION;
+    }
+
+    bool IsStoppedByWalls() const {
+        return true;
+    }
+
+    //! \brief Gives the number of collision tests done since the last call, and resets it.
+    uint32 TakeNumTests() {
+        uint32 num_tests = _num_tests;
+        _num_tests = 0;
+        return num_tests;
+    }
+
+private:
+    const CollisionGrid &_collision_grid;
+
+    uint32 _num_tests;
+}; // class GridCollisionDetector
+
+//! \brief Orders the former open list so that the lowest f score is at its back, as PathNode::operator< used to.
+static bool CompareFormerOpenNodes(const PathNode &node, const PathNode &other)
+{
+    return node.f_score > other.f_score;
+}
+
+/** \brief The path search used before the path finder, kept as a reference
+*** The open list is sorted on every iteration, and the open and closed lists are searched linearly.
+**/
+static Path FindFormerPath(const PathNode &source_node, const MapPosition &destination, uint32 max_cost,
+                           PathCollisionDetector &collision_detector)
+{
+    static const uint32 basic_gcost = 10;
+
+    Path path;
+    PathNode dest(static_cast<int16>(destination.x), static_cast<int16>(destination.y));
+
+    std::vector<PathNode> open_list;
+    std::vector<PathNode> closed_list;
+    PathNode best_node;
+    PathNode nodes[8];
+    uint32 x_delta, y_delta;
+    int16 g_add;
+
+    open_list.push_back(source_node);
+
+    float offset_x = GetFloatFraction(destination.x);
+    float offset_y = GetFloatFraction(destination.y);
+
+    while(open_list.empty() == false) {
+        std::sort(open_list.begin(), open_list.end(), CompareFormerOpenNodes);
+        best_node = open_list.back();
+        open_list.pop_back();
+        closed_list.push_back(best_node);
+
+        if(best_node == dest)
+            break;
+
+        nodes[0].tile_x = best_node.tile_x - 1;
+        nodes[0].tile_y = best_node.tile_y;
+        nodes[1].tile_x = best_node.tile_x + 1;
+        nodes[1].tile_y = best_node.tile_y;
+        nodes[2].tile_x = best_node.tile_x;
+        nodes[2].tile_y = best_node.tile_y - 1;
+        nodes[3].tile_x = best_node.tile_x;
+        nodes[3].tile_y = best_node.tile_y + 1;
+        nodes[4].tile_x = best_node.tile_x - 1;
+        nodes[4].tile_y = best_node.tile_y - 1;
+        nodes[5].tile_x = best_node.tile_x - 1;
+        nodes[5].tile_y = best_node.tile_y + 1;
+        nodes[6].tile_x = best_node.tile_x + 1;
+        nodes[6].tile_y = best_node.tile_y - 1;
+        nodes[7].tile_x = best_node.tile_x + 1;
+        nodes[7].tile_y = best_node.tile_y + 1;
+
+        for(uint8 i = 0; i < 8; ++i) {
+            COLLISION_TYPE collision_type = collision_detector.DetectCollision(((float)nodes[i].tile_x) + offset_x,
+                                                                               ((float)nodes[i].tile_y) + offset_y);
+            if(collision_type == WALL_COLLISION)
+                continue;
+
+            if(i < 4)
+                g_add = basic_gcost;
+            else
+                g_add = basic_gcost + 4;
+
+            if(collision_type == CHARACTER_COLLISION
+                    || collision_type == ENEMY_COLLISION)
+                g_add += basic_gcost * 2;
+
+            if(max_cost > 0 && (uint32)(best_node.g_score + g_add) >= max_cost * basic_gcost)
+                return path;
+
+            if(std::find(closed_list.begin(), closed_list.end(), nodes[i]) != closed_list.end())
+                continue;
+
+            nodes[i].parent_x = best_node.tile_x;
+            nodes[i].parent_y = best_node.tile_y;
+            nodes[i].g_score = best_node.g_score + g_add;
+
+            std::vector<PathNode>::iterator iter = std::find(open_list.begin(), open_list.end(), nodes[i]);
+            if(iter != open_list.end()) {
+                if(iter->g_score > nodes[i].g_score) {
+                    iter->g_score = nodes[i].g_score;
+                    iter->f_score = nodes[i].g_score + iter->h_score;
+                    iter->parent_x = nodes[i].parent_x;
+                    iter->parent_y = nodes[i].parent_y;
+                }
+            } else {
+                x_delta = abs(dest.tile_x - nodes[i].tile_x);
+                y_delta = abs(dest.tile_y - nodes[i].tile_y);
+                if(x_delta > y_delta)
+                    nodes[i].h_score = 14 * y_delta + 10 * (x_delta - y_delta);
+                else
+                    nodes[i].h_score = 14 * x_delta + 10 * (y_delta - x_delta);
+
+                nodes[i].f_score = nodes[i].g_score + nodes[i].h_score;
+                open_list.push_back(nodes[i]);
+            }
+        }
+    }
+
+    if(open_list.empty() == true)
+        return path;
+
+    path.push_back(destination);
+
+    int16 parent_x = best_node.parent_x;
+    int16 parent_y = best_node.parent_y;
+    closed_list.pop_back();
+
+    for(std::vector<PathNode>::iterator iter = closed_list.end() - 1; iter != closed_list.begin(); --iter) {
+        if(iter->tile_y == parent_y && iter->tile_x == parent_x) {
+            MapPosition next_pos(((float)iter->tile_x) + offset_x, ((float)iter->tile_y) + offset_y);
+            path.push_back(next_pos);
+
+            parent_x = iter->parent_x;
+            parent_y = iter->parent_y;
+        }
+    }
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
+
+//! \brief Returns the walking cost of a path from the source node, or 0 for an empty path.
+static uint32 getPathCost(const PathNode &source_node, const Path &path)
+{
+    uint32 cost = 0;
+    int16 x = source_node.tile_x;
+    int16 y = source_node.tile_y;
+    for(uint32 i = 0; i < path.size(); ++i) {
+        int16 next_x = static_cast<int16>(path[i].x);
+        int16 next_y = static_cast<int16>(path[i].y);
+        cost += (next_x != x && next_y != y) ? 14 : 10;
+        x = next_x;
+        y = next_y;
+    }
+    return cost;
+}
+
+//! \brief Tells whether both paths go through the same positions.
+static bool isSamePath(const Path &path, const Path &other)
+{
+    if(path.size() != other.size())
+        return false;
+    for(uint32 i = 0; i < path.size(); ++i) {
+        if(path[i].x != other[i].x || path[i].y != other[i].y)
+            return false;
+    }
+    return true;
+}
+
+//! \brief Returns the next value of a linear congruential generator, portable unlike rand().
+static uint32 getNextRandom(uint32 &seed)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7FFF;
+}
+
+//! \brief The results of a path search method over all the searches.
+struct BenchmarkResults {
+    BenchmarkResults() :
+        time(0),
+        num_tests(0),
+        num_found(0)
+    {}
+
+    //! \brief The time spent searching, in microseconds.
+    uint32 time;
+
+    //! \brief The number of collision tests done.
+    uint32 num_tests;
+
+    //! \brief The number of searches which found a path.
+    uint32 num_found;
+};
+
+//! \brief Prints the results of a path search method.
+static void printResults(const char *name, const BenchmarkResults &results, uint32 num_searches)
+{
+    printf("  %-26s %10.2f ms %12u tests %6u/%u paths found\n", name,
+           static_cast<float>(results.time) / 1000.0f, results.num_tests, results.num_found, num_searches);
+}
+
+bool BenchmarkPathFinding(const std::string &filename, uint32 num_searches)
+{
+    MapData map_data;
+    bool loaded = map_data.Load(filename);
+    map_data.PrintMessages();
+    if(!loaded) {
+        PRINT_ERROR << "Couldn't load the map data: " << filename << std::endl;
+        return false;
+    }
+
+    const CollisionGrid &collision_grid = map_data.collision_grid;
+    GridCollisionDetector collision_detector(collision_grid);
+
+    // Gather the grid elements a common character can stand on.
+    std::vector<PathNode> walkable_nodes;
+    for(uint16 y = 0; y < collision_grid.GetNumGridYAxis(); ++y) {
+        for(uint16 x = 0; x < collision_grid.GetNumGridXAxis(); ++x) {
+            if(collision_detector.DetectCollision(x + 0.5f, y + 0.5f) == NO_COLLISION)
+                walkable_nodes.push_back(PathNode(x, y));
+        }
+    }
+    if(walkable_nodes.size() < 2) {
+        PRINT_ERROR << "The map has no walkable grid elements: " << filename << std::endl;
+        return false;
+    }
+
+    uint32 start_time = GetProfilerTime();
+    PathAbstractGraph abstract_graph;
+    abstract_graph.Initialize(collision_grid);
+    uint32 graph_time = GetProfilerTime() - start_time;
+
+    PathFinder grid_finder;
+    grid_finder.Initialize(collision_grid.GetNumGridXAxis(), collision_grid.GetNumGridYAxis());
+    PathFinder abstract_finder;
+    abstract_finder.Initialize(collision_grid.GetNumGridXAxis(), collision_grid.GetNumGridYAxis(), &abstract_graph);
+
+    printf("\n===== Path finding benchmark: %s\n", filename.c_str());
+    printf("Collision grid: %ux%u elements, %u walkable. Abstract graph built in %.2f ms.\n",
+           collision_grid.GetNumGridXAxis(), collision_grid.GetNumGridYAxis(),
+           static_cast<uint32>(walkable_nodes.size()), static_cast<float>(graph_time) / 1000.0f);
+
+    // Unlimited searches, then searches limited to the enemies max cost.
+    const uint32 max_costs[2] = { 0, BENCHMARK_MAX_COST };
+    for(uint32 pass = 0; pass < 2; ++pass) {
+        uint32 max_cost = max_costs[pass];
+        uint32 seed = BENCHMARK_SEED;
+
+        BenchmarkResults former_results, grid_results, abstract_results;
+        uint32 num_grid_differences = 0;
+        uint32 num_grid_identical_paths = 0;
+        uint32 num_abstract_differences = 0;
+        uint32 grid_cost = 0;
+        uint32 abstract_cost = 0;
+        uint32 num_abstract_searches = abstract_finder.GetNumAbstractSearches();
+        uint32 num_fallbacks = abstract_finder.GetNumFallbacks();
+
+        for(uint32 i = 0; i < num_searches; ++i) {
+            const PathNode &source_node = walkable_nodes[getNextRandom(seed) % walkable_nodes.size()];
+            const PathNode &dest_node = walkable_nodes[getNextRandom(seed) % walkable_nodes.size()];
+            if(source_node == dest_node)
+                continue;
+            MapPosition destination(dest_node.tile_x + 0.5f, dest_node.tile_y + 0.5f);
+
+            start_time = GetProfilerTime();
+            Path former_path = FindFormerPath(source_node, destination, max_cost, collision_detector);
+            former_results.time += GetProfilerTime() - start_time;
+            former_results.num_tests += collision_detector.TakeNumTests();
+
+            start_time = GetProfilerTime();
+            Path grid_path = grid_finder.FindPath(source_node, destination, max_cost, collision_detector);
+            grid_results.time += GetProfilerTime() - start_time;
+            grid_results.num_tests += collision_detector.TakeNumTests();
+
+            start_time = GetProfilerTime();
+            Path abstract_path = abstract_finder.FindPath(source_node, destination, max_cost, collision_detector);
+            abstract_results.time += GetProfilerTime() - start_time;
+            abstract_results.num_tests += collision_detector.TakeNumTests();
+
+            grid_finder.TakeMessages();
+            abstract_finder.TakeMessages();
+
+            if(!former_path.empty())
+                ++former_results.num_found;
+            if(!grid_path.empty())
+                ++grid_results.num_found;
+            if(!abstract_path.empty())
+                ++abstract_results.num_found;
+
+            // Both paths are either missing, or found with the same cost.
+            if(getPathCost(source_node, former_path) != getPathCost(source_node, grid_path))
+                ++num_grid_differences;
+            else if(isSamePath(former_path, grid_path))
+                ++num_grid_identical_paths;
+
+            if(grid_path.empty() != abstract_path.empty()) {
+                ++num_abstract_differences;
+            } else {
+                grid_cost += getPathCost(source_node, grid_path);
+                abstract_cost += getPathCost(source_node, abstract_path);
+            }
+        }
+
+        if(max_cost == 0)
+            printf("\n%u searches without cost limit:\n", num_searches);
+        else
+            printf("\n%u searches with a max cost of %u:\n", num_searches, max_cost);
+        printResults("Former sorted list A*", former_results, num_searches);
+        printResults("Path finder, whole grid", grid_results, num_searches);
+        printResults("Path finder, abstract graph", abstract_results, num_searches);
+
+        printf("Former and whole grid searches: %u results with a different cost, %u identical paths.\n",
+               num_grid_differences, num_grid_identical_paths);
+        printf("Abstract graph searches: %u whole grid fallbacks out of %u, %u results found by only one of the searches,\n"
+               "path costs %.2f%% over the whole grid ones.\n",
+               abstract_finder.GetNumFallbacks() - num_fallbacks, abstract_finder.GetNumAbstractSearches() - num_abstract_searches,
+               num_abstract_differences,
+               grid_cost > 0 ? (static_cast<float>(abstract_cost) - static_cast<float>(grid_cost)) * 100.0f / static_cast<float>(grid_cost) : 0.0f);
+    }
+
+    return true;
+} // bool BenchmarkPathFinding(const std::string &filename, uint32 num_searches)
+
+} // namespace vt_map
@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_benchmark.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the map path finding benchmark
+***
+*** The benchmark replays the same random searches on the collision grid of a
+*** map with the former sorted open list A*, kept here as a reference, with the
+*** path finder on the whole grid, and with the path finder using the abstract
+*** graph. It prints their durations and compares the path costs found.
+***
+*** It is run with the --benchmark-paths program option, and doesn't need any
+*** engine but the map data loading.
+*** ***************************************************************************/
+
+#ifndef __MAP_PATH_BENCHMARK_HEADER__
+#define __MAP_PATH_BENCHMARK_HEADER__
+
+namespace vt_map
+{
+
+/** \brief Replays random path searches on the collision grid of a map and prints the results
+*** \param filename The map data Lua filename (e.g. "dat/maps/layna_forest/layna_forest_north_east_map.lua")
+*** \param num_searches The number of source and destination pairs searched.
+*** \return False if the map data couldn't be loaded.
+***
+*** Each pair is searched without cost limit, then with the max cost used by
+*** the enemies, so that the max cost aborts can be compared as well.
+*** The pairs only depend on the map grid, so the runs can be compared.
+**/
+bool BenchmarkPathFinding(const std::string &filename, uint32 num_searches = 200);
+
+} // namespace vt_map
+
+#endif // __MAP_PATH_BENCHMARK_HEADER__
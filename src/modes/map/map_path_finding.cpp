@@ -0,0 +1,1196 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2004-2011 by The Allacrost Project
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_finding.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for map mode path finding.
+*** ***************************************************************************/
+
+#include "utils/utils_pch.h"
+#include "modes/map/map_path_finding.h"
+
+#include "engine/system.h"
+
+#include "utils/utils_numeric.h"
+
+#include <functional>
+#include <queue>
+
+using namespace vt_utils;
+using namespace vt_system;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+// ----------------------------------------------------------------------------
+// ---------- PathAbstractGraph Class Functions
+// ----------------------------------------------------------------------------
+
+//! \brief The cost given to the grid elements that can't be reached.
+static const uint32 PATH_NO_COST = 0xFFFFFFFF;
+
+//! \brief The g costs of the lateral and diagonal moves between two grid elements.
+static const uint32 PATH_LATERAL_COST = 10;
+static const uint32 PATH_DIAGONAL_COST = 14;
+
+//! \brief A walkable span gets one more entrance for each such number of grid elements.
+static const uint16 PATH_ENTRANCE_SPACING = 8;
+
+//! \brief Returns the diagonal distance heuristic between two grid elements.
+static uint32 _GetDiagonalDistance(int16 x1, int16 y1, int16 x2, int16 y2)
+{
+    uint32 x_delta = abs(x1 - x2);
+    uint32 y_delta = abs(y1 - y2);
+    if(x_delta > y_delta)
+        return PATH_DIAGONAL_COST * y_delta + PATH_LATERAL_COST * (x_delta - y_delta);
+    else
+        return PATH_DIAGONAL_COST * x_delta + PATH_LATERAL_COST * (y_delta - x_delta);
+}
+
+//! \brief The open list entries of the abstract graph searches: (f or g score, node index).
+typedef std::pair<uint32, uint32> AbstractOpenEntry;
+typedef std::priority_queue<AbstractOpenEntry, std::vector<AbstractOpenEntry>, std::greater<AbstractOpenEntry> > AbstractOpenList;
+
+PathAbstractGraph::PathAbstractGraph() :
+    _num_grid_x_axis(0),
+    _num_grid_y_axis(0),
+    _num_clusters_x(0),
+    _num_clusters_y(0)
+{}
+
+void PathAbstractGraph::Initialize(const CollisionGrid& collision_grid)
+{
+    uint32 start_time = SDL_GetTicks();
+
+    _nodes.clear();
+    _cluster_nodes.clear();
+
+    _num_grid_x_axis = collision_grid.GetNumGridXAxis();
+    _num_grid_y_axis = collision_grid.GetNumGridYAxis();
+    uint32 num_cells = _num_grid_x_axis * _num_grid_y_axis;
+
+    std::vector<uint8> walls(num_cells, 0);
+    for(uint32 y = 0; y < _num_grid_y_axis; ++y) {
+        for(uint32 x = 0; x < _num_grid_x_axis; ++x)
+            walls[y * _num_grid_x_axis + x] = collision_grid.IsWall(x, y) ? 1 : 0;
+    }
+
+    // Label the walkable areas, each path node being a walkable grid element.
+    _components.assign(num_cells, 0);
+    uint32 num_components = 0;
+    std::vector<uint32> cells_to_visit;
+    for(uint32 cell = 0; cell < num_cells; ++cell) {
+        if(walls[cell] || _components[cell])
+            continue;
+
+        _components[cell] = ++num_components;
+        cells_to_visit.push_back(cell);
+        while(!cells_to_visit.empty()) {
+            int16 x = cells_to_visit.back() % _num_grid_x_axis;
+            int16 y = cells_to_visit.back() / _num_grid_x_axis;
+            cells_to_visit.pop_back();
+
+            for(int16 j = y - 1; j <= y + 1; ++j) {
+                for(int16 i = x - 1; i <= x + 1; ++i) {
+                    if(i < 0 || j < 0 || i >= _num_grid_x_axis || j >= _num_grid_y_axis)
+                        continue;
+                    uint32 neighbour = j * _num_grid_x_axis + i;
+                    if(walls[neighbour] || _components[neighbour])
+                        continue;
+                    _components[neighbour] = num_components;
+                    cells_to_visit.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    // Block the grid elements where the common character collision rectangle
+    // would hit a wall, so that the abstract paths stay walkable by them.
+    // That rectangle, about 2x2 elements standing on the element, overlaps
+    // the three columns around it and the two rows above it.
+    _blocked.assign(num_cells, 0);
+    for(int16 y = 0; y < _num_grid_y_axis; ++y) {
+        for(int16 x = 0; x < _num_grid_x_axis; ++x) {
+            for(int16 j = y - 2; j <= y && !_blocked[y * _num_grid_x_axis + x]; ++j) {
+                for(int16 i = x - 1; i <= x + 1; ++i) {
+                    if(i < 0 || j < 0 || i >= _num_grid_x_axis || walls[j * _num_grid_x_axis + i]) {
+                        _blocked[y * _num_grid_x_axis + x] = 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    _num_clusters_x = (_num_grid_x_axis + PATH_CLUSTER_LENGTH - 1) / PATH_CLUSTER_LENGTH;
+    _num_clusters_y = (_num_grid_y_axis + PATH_CLUSTER_LENGTH - 1) / PATH_CLUSTER_LENGTH;
+    _cluster_nodes.resize(_num_clusters_x * _num_clusters_y);
+
+    std::map<uint32, uint32> cell_nodes;
+
+    // Add the entrances of the borders between horizontally and vertically adjacent clusters.
+    for(uint16 cluster_y = 0; cluster_y < _num_clusters_y; ++cluster_y) {
+        for(uint16 cluster_x = 0; cluster_x < _num_clusters_x; ++cluster_x) {
+            int16 left = cluster_x * PATH_CLUSTER_LENGTH;
+            int16 top = cluster_y * PATH_CLUSTER_LENGTH;
+            uint16 width = std::min<uint16>(PATH_CLUSTER_LENGTH, _num_grid_x_axis - left);
+            uint16 height = std::min<uint16>(PATH_CLUSTER_LENGTH, _num_grid_y_axis - top);
+
+            if(cluster_x + 1 < _num_clusters_x)
+                _AddEntrances(left + PATH_CLUSTER_LENGTH - 1, top, 0, 1, 1, 0, height, cell_nodes);
+            if(cluster_y + 1 < _num_clusters_y)
+                _AddEntrances(left, top + PATH_CLUSTER_LENGTH - 1, 1, 0, 0, 1, width, cell_nodes);
+        }
+    }
+
+    // Link the nodes of each cluster with their walking cost.
+    std::vector<uint32> costs;
+    uint32 num_edges = 0;
+    for(uint32 cluster = 0; cluster < _cluster_nodes.size(); ++cluster) {
+        const std::vector<uint32>& nodes = _cluster_nodes[cluster];
+        for(uint32 i = 0; i < nodes.size(); ++i) {
+            AbstractNode& node = _nodes[nodes[i]];
+            _ComputeClusterCosts(node.x, node.y, costs);
+
+            for(uint32 j = 0; j < nodes.size(); ++j) {
+                if(i == j)
+                    continue;
+                const AbstractNode& other = _nodes[nodes[j]];
+                uint32 cost = costs[_GetClusterIndex(other.x, other.y)];
+                if(cost == PATH_NO_COST)
+                    continue;
+                node.edges.push_back(AbstractEdge(nodes[j], cost));
+                ++num_edges;
+            }
+        }
+    }
+
+    IF_PRINT_DEBUG(MAP_DEBUG) << "Path finding graph built in " << SDL_GetTicks() - start_time << " ms. Nodes: "
+                              << _nodes.size() << ", cluster edges: " << num_edges << ", walkable areas: "
+                              << num_components << std::endl;
+}
+
+void PathAbstractGraph::_AddEntrances(int16 x, int16 y, int16 step_x, int16 step_y, int16 across_x, int16 across_y,
+                                      uint16 length, std::map<uint32, uint32>& cell_nodes)
+{
+    uint16 span_start = 0;
+    bool in_span = false;
+
+    // The extra iteration closes the span ending at the border end.
+    for(uint16 i = 0; i <= length; ++i) {
+        int16 cell_x = x + i * step_x;
+        int16 cell_y = y + i * step_y;
+        bool walkable = (i < length) && !_IsBlocked(cell_x, cell_y) && !_IsBlocked(cell_x + across_x, cell_y + across_y);
+
+        if(walkable) {
+            if(!in_span) {
+                span_start = i;
+                in_span = true;
+            }
+            continue;
+        }
+
+        if(!in_span)
+            continue;
+        in_span = false;
+
+        // Spread the entrances evenly along the walkable span, so that the ones of
+        // short spans stay in the middle, away from the walls.
+        uint16 span_length = i - span_start;
+        uint16 num_entrances = 1 + span_length / PATH_ENTRANCE_SPACING;
+        for(uint16 j = 0; j < num_entrances; ++j) {
+            uint16 position = span_start + (2 * j + 1) * span_length / (2 * num_entrances);
+            int16 entrance_x = x + position * step_x;
+            int16 entrance_y = y + position * step_y;
+
+            uint32 first_node = _GetNode(entrance_x, entrance_y, cell_nodes);
+            uint32 second_node = _GetNode(entrance_x + across_x, entrance_y + across_y, cell_nodes);
+            _nodes[first_node].edges.push_back(AbstractEdge(second_node, PATH_LATERAL_COST));
+            _nodes[second_node].edges.push_back(AbstractEdge(first_node, PATH_LATERAL_COST));
+        }
+    }
+}
+
+uint32 PathAbstractGraph::_GetNode(int16 x, int16 y, std::map<uint32, uint32>& cell_nodes)
+{
+    uint32 cell = y * _num_grid_x_axis + x;
+    std::map<uint32, uint32>::iterator it = cell_nodes.find(cell);
+    if(it != cell_nodes.end())
+        return it->second;
+
+    uint32 index = _nodes.size();
+    _nodes.push_back(AbstractNode());
+    _nodes.back().x = x;
+    _nodes.back().y = y;
+    _nodes.back().cluster = GetCluster(x, y);
+    _cluster_nodes[_nodes.back().cluster].push_back(index);
+    cell_nodes[cell] = index;
+    return index;
+}
+
+void PathAbstractGraph::_ComputeClusterCosts(int16 x, int16 y, std::vector<uint32>& costs) const
+{
+    // The coordinates offsets of the eight adjacent grid elements: lateral ones first, then diagonal ones.
+    static const int16 adjacent_x[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static const int16 adjacent_y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+    int16 left, top, right, bottom;
+    _GetClusterArea(x, y, left, top, right, bottom);
+
+    costs.assign(PATH_CLUSTER_LENGTH * PATH_CLUSTER_LENGTH, PATH_NO_COST);
+
+    // A Dijkstra search, as the costs to every grid element are needed.
+    AbstractOpenList open_list;
+    costs[_GetClusterIndex(x, y)] = 0;
+    open_list.push(AbstractOpenEntry(0, _GetClusterIndex(x, y)));
+
+    while(!open_list.empty()) {
+        AbstractOpenEntry best = open_list.top();
+        open_list.pop();
+        if(best.first != costs[best.second])
+            continue;
+
+        int16 best_x = left + best.second % PATH_CLUSTER_LENGTH;
+        int16 best_y = top + best.second / PATH_CLUSTER_LENGTH;
+
+        for(uint8 i = 0; i < 8; ++i) {
+            int16 node_x = best_x + adjacent_x[i];
+            int16 node_y = best_y + adjacent_y[i];
+            if(node_x < left || node_x > right || node_y < top || node_y > bottom || _IsBlocked(node_x, node_y))
+                continue;
+
+            uint32 cost = best.first + (i < 4 ? PATH_LATERAL_COST : PATH_DIAGONAL_COST);
+            uint32 index = _GetClusterIndex(node_x, node_y);
+            if(cost >= costs[index])
+                continue;
+
+            costs[index] = cost;
+            open_list.push(AbstractOpenEntry(cost, index));
+        }
+    }
+}
+
+void PathAbstractGraph::_GetClusterArea(int16 x, int16 y, int16& left, int16& top, int16& right, int16& bottom) const
+{
+    left = (x / PATH_CLUSTER_LENGTH) * PATH_CLUSTER_LENGTH;
+    top = (y / PATH_CLUSTER_LENGTH) * PATH_CLUSTER_LENGTH;
+    right = std::min<int16>(left + PATH_CLUSTER_LENGTH, _num_grid_x_axis) - 1;
+    bottom = std::min<int16>(top + PATH_CLUSTER_LENGTH, _num_grid_y_axis) - 1;
+}
+
+bool PathAbstractGraph::IsReachable(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y) const
+{
+    if(source_x < 0 || source_y < 0 || source_x >= _num_grid_x_axis || source_y >= _num_grid_y_axis ||
+            dest_x < 0 || dest_y < 0 || dest_x >= _num_grid_x_axis || dest_y >= _num_grid_y_axis)
+        return false;
+
+    // A sprite stuck in a wall has no walkable area, so let the path finder decide.
+    uint32 source_component = _components[source_y * _num_grid_x_axis + source_x];
+    if(source_component == 0)
+        return true;
+
+    return source_component == _components[dest_y * _num_grid_x_axis + dest_x];
+}
+
+bool PathAbstractGraph::IsLongDistance(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y) const
+{
+    if(_nodes.empty())
+        return false;
+
+    return abs(source_x / PATH_CLUSTER_LENGTH - dest_x / PATH_CLUSTER_LENGTH) > 1 ||
+           abs(source_y / PATH_CLUSTER_LENGTH - dest_y / PATH_CLUSTER_LENGTH) > 1;
+}
+
+bool PathAbstractGraph::FindAbstractPath(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y,
+                                         std::vector<PathNode>& waypoints) const
+{
+    waypoints.clear();
+
+    // The source and destination are linked to the nodes of their clusters for this search only.
+    std::vector<uint32> source_costs;
+    std::vector<uint32> dest_costs;
+    _ComputeClusterCosts(source_x, source_y, source_costs);
+    _ComputeClusterCosts(dest_x, dest_y, dest_costs);
+    uint32 source_cluster = GetCluster(source_x, source_y);
+    uint32 dest_cluster = GetCluster(dest_x, dest_y);
+
+    // The source and destination node indices follow the graph ones.
+    uint32 source_index = _nodes.size();
+    uint32 dest_index = source_index + 1;
+
+    // Local to the search, so that several threads can search the graph.
+    std::vector<uint32> g_scores(_nodes.size() + 2, PATH_NO_COST);
+    std::vector<uint32> parents(_nodes.size() + 2, 0);
+    std::vector<bool> closed_nodes(_nodes.size() + 2, false);
+    AbstractOpenList open_list;
+
+    g_scores[source_index] = 0;
+    open_list.push(AbstractOpenEntry(_GetDiagonalDistance(source_x, source_y, dest_x, dest_y), source_index));
+
+    // The edges of the node being expanded, set up for the source and destination ones.
+    std::vector<AbstractEdge> edges;
+
+    while(!open_list.empty()) {
+        uint32 best_index = open_list.top().second;
+        open_list.pop();
+        if(closed_nodes[best_index])
+            continue;
+        closed_nodes[best_index] = true;
+
+        if(best_index == dest_index)
+            break;
+
+        edges.clear();
+        if(best_index == source_index) {
+            const std::vector<uint32>& nodes = _cluster_nodes[source_cluster];
+            for(uint32 i = 0; i < nodes.size(); ++i) {
+                uint32 cost = source_costs[_GetClusterIndex(_nodes[nodes[i]].x, _nodes[nodes[i]].y)];
+                if(cost != PATH_NO_COST)
+                    edges.push_back(AbstractEdge(nodes[i], cost));
+            }
+        }
+        else {
+            const AbstractNode& best_node = _nodes[best_index];
+            edges = best_node.edges;
+            if(best_node.cluster == dest_cluster) {
+                uint32 cost = dest_costs[_GetClusterIndex(best_node.x, best_node.y)];
+                if(cost != PATH_NO_COST)
+                    edges.push_back(AbstractEdge(dest_index, cost));
+            }
+        }
+
+        for(uint32 i = 0; i < edges.size(); ++i) {
+            uint32 index = edges[i].node;
+            uint32 g_score = g_scores[best_index] + edges[i].cost;
+            if(closed_nodes[index] || g_score >= g_scores[index])
+                continue;
+
+            g_scores[index] = g_score;
+            parents[index] = best_index;
+
+            uint32 h_score = 0;
+            if(index != dest_index)
+                h_score = _GetDiagonalDistance(_nodes[index].x, _nodes[index].y, dest_x, dest_y);
+            open_list.push(AbstractOpenEntry(g_score + h_score, index));
+        }
+    }
+
+    if(!closed_nodes[dest_index])
+        return false;
+
+    for(uint32 index = parents[dest_index]; index != source_index; index = parents[index])
+        waypoints.push_back(PathNode(_nodes[index].x, _nodes[index].y));
+    std::reverse(waypoints.begin(), waypoints.end());
+    return true;
+} // bool PathAbstractGraph::FindAbstractPath(...)
+
+// ----------------------------------------------------------------------------
+// ---------- PathFinder Class Functions
+// ----------------------------------------------------------------------------
+
+PathFinder::PathFinder() :
+    _num_grid_x_axis(0),
+    _num_grid_y_axis(0),
+    _abstract_graph(NULL),
+    _num_abstract_searches(0),
+    _num_fallbacks(0)
+{}
+
+void PathFinder::Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis, const PathAbstractGraph *abstract_graph)
+{
+    _num_grid_x_axis = num_grid_x_axis;
+    _num_grid_y_axis = num_grid_y_axis;
+    _abstract_graph = abstract_graph;
+    _num_abstract_searches = 0;
+    _num_fallbacks = 0;
+
+    uint32 num_nodes = _num_grid_x_axis * _num_grid_y_axis;
+    uint32 num_bitset_words = (num_nodes + 31) / 32;
+
+    _closed_nodes.assign(num_bitset_words, 0);
+    _opened_nodes.assign(num_bitset_words, 0);
+    _g_scores.assign(num_nodes, 0);
+    _parents.assign(num_nodes, 0);
+    _opening_orders.assign(num_nodes, 0);
+    _open_list.clear();
+}
+
+Path PathFinder::FindPath(const PathNode &source_node, const MapPosition &destination, uint32 max_cost,
+                          PathCollisionDetector &collision_detector)
+{
+    Path path;
+
+    // The ending node.
+    PathNode dest(static_cast<int16>(destination.x), static_cast<int16>(destination.y));
+
+    if(source_node.tile_x < 0 || source_node.tile_y < 0 ||
+            source_node.tile_x >= _num_grid_x_axis || source_node.tile_y >= _num_grid_y_axis) {
+        if(MAP_DEBUG)
+            _messages << "Source node is outside of the collision grid" << std::endl;
+        return path;
+    }
+
+    // No path can be shorter than the straight distance to the destination.
+    if(max_cost > 0 && _GetDiagonalDistance(source_node.tile_x, source_node.tile_y, dest.tile_x, dest.tile_y)
+            >= max_cost * PATH_LATERAL_COST)
+        return path;
+
+    uint32 start_time = SDL_GetTicks();
+
+    bool use_abstract_graph = _abstract_graph && collision_detector.IsStoppedByWalls();
+
+    // The graph knows all the collision grid walls, so there is no need
+    // to flood the whole grid when they separate the source from the destination.
+    if(use_abstract_graph &&
+            !_abstract_graph->IsReachable(source_node.tile_x, source_node.tile_y, dest.tile_x, dest.tile_y)) {
+        if(MAP_DEBUG)
+            _messages << "could not find path to destination" << std::endl;
+        return path;
+    }
+
+    // Search the abstract graph first on long distances.
+    if(use_abstract_graph &&
+            _abstract_graph->IsLongDistance(source_node.tile_x, source_node.tile_y, dest.tile_x, dest.tile_y)) {
+        ++_num_abstract_searches;
+        bool abstract_path_found = _abstract_graph->FindAbstractPath(source_node.tile_x, source_node.tile_y,
+                                                                     dest.tile_x, dest.tile_y, _waypoints);
+        if(abstract_path_found) {
+            _SetCorridor(source_node, dest);
+            if(_SearchPath(source_node, destination, max_cost, true, collision_detector, path)) {
+                if(MAP_DEBUG)
+                    _messages << "Path of " << path.size() << " nodes found in "
+                              << SDL_GetTicks() - start_time << " ms using the abstract graph." << std::endl;
+                return path;
+            }
+        }
+
+        // The sprite may be smaller or larger than the common characters, or objects
+        // may block the way: let the whole grid search have the last word.
+        // The time already spent is lost, so the fallbacks are counted and logged.
+        ++_num_fallbacks;
+        if(MAP_DEBUG)
+            _messages << "Falling back to the whole grid search after " << SDL_GetTicks() - start_time
+                      << " ms: " << (abstract_path_found ? "the clusters crossed by the abstract path couldn't be walked"
+                                                         : "the abstract graph has no path")
+                      << " from (" << source_node.tile_x << ", " << source_node.tile_y
+                      << ") to (" << dest.tile_x << ", " << dest.tile_y << "). Fallbacks: " << _num_fallbacks
+                      << " out of " << _num_abstract_searches << " abstract graph searches." << std::endl;
+    }
+
+    if(!_SearchPath(source_node, destination, max_cost, false, collision_detector, path)) {
+        if(MAP_DEBUG)
+            _messages << "could not find path to destination" << std::endl;
+        return path;
+    }
+
+    if(MAP_DEBUG)
+        _messages << "Path of " << path.size() << " nodes found in " << SDL_GetTicks() - start_time
+                  << " ms." << std::endl;
+
+    return path;
+} // Path PathFinder::FindPath(const PathNode& source_node, const MapPosition& destination, ...)
+
+std::string PathFinder::TakeMessages()
+{
+    std::string messages = _messages.str();
+    _messages.str(std::string());
+    return messages;
+}
+
+void PathFinder::_SetCorridor(const PathNode &source_node, const PathNode &dest)
+{
+    _corridor.assign(_abstract_graph->GetNumClusters(), 0);
+    _corridor[_abstract_graph->GetCluster(source_node.tile_x, source_node.tile_y)] = 1;
+    _corridor[_abstract_graph->GetCluster(dest.tile_x, dest.tile_y)] = 1;
+    for(uint32 i = 0; i < _waypoints.size(); ++i)
+        _corridor[_abstract_graph->GetCluster(_waypoints[i].tile_x, _waypoints[i].tile_y)] = 1;
+}
+
+bool PathFinder::_SearchPath(const PathNode &source_node, const MapPosition &destination, uint32 max_cost,
+                             bool corridor, PathCollisionDetector &collision_detector, Path &path)
+{
+    // NOTE: Refer to the implementation of the A* algorithm to understand
+    // what all these lists and score values are for.
+    static const uint32 basic_gcost = PATH_LATERAL_COST;
+
+    // The coordinates offsets of the eight adjacent nodes: lateral ones first, then diagonal ones.
+    static const int16 adjacent_x[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static const int16 adjacent_y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+    path.clear();
+
+    // The ending node.
+    PathNode dest(static_cast<int16>(destination.x), static_cast<int16>(destination.y));
+
+    // Reset the node states left by the previous search. The scores and parents
+    // are only read for opened nodes, so only the bitsets need to be cleared.
+    std::fill(_closed_nodes.begin(), _closed_nodes.end(), 0);
+    std::fill(_opened_nodes.begin(), _opened_nodes.end(), 0);
+    _open_list.clear();
+
+    // The current "best node"
+    PathNode best_node;
+    uint32 best_index = 0;
+
+    // Whether the destination was reached
+    bool dest_reached = false;
+    // The number of nodes opened so far
+    uint32 opening_order = 0;
+
+    // Temporary delta variables used in calculation of a node's heuristic (h score)
+    uint32 x_delta, y_delta;
+    // The number to add to a node's g_score, depending on whether it is a lateral or diagonal movement
+    int16 g_add;
+
+    uint32 source_index = _GetNodeIndex(source_node.tile_x, source_node.tile_y);
+    _SetNodeBit(_opened_nodes, source_index);
+    _g_scores[source_index] = 0;
+    _opening_orders[source_index] = 0;
+    _open_list.push_back(PathNode(source_node.tile_x, source_node.tile_y));
+
+    // We will try to keep the original offset all along.
+    float offset_x = GetFloatFraction(destination.x);
+    float offset_y = GetFloatFraction(destination.y);
+
+    while(_open_list.empty() == false) {
+        std::pop_heap(_open_list.begin(), _open_list.end());
+        best_node = _open_list.back();
+        _open_list.pop_back();
+
+        // A node whose score got improved is pushed again in the heap rather than moved,
+        // so skip the outdated entries.
+        best_index = _GetNodeIndex(best_node.tile_x, best_node.tile_y);
+        if(_IsNodeBitSet(_closed_nodes, best_index) || best_node.g_score != _g_scores[best_index])
+            continue;
+
+        _SetNodeBit(_closed_nodes, best_index);
+
+        // Check if destination has been reached, and break out of the loop if so
+        if(best_node == dest) {
+            dest_reached = true;
+            break;
+        }
+
+        // Check the eight adjacent nodes
+        for(uint8 i = 0; i < 8; ++i) {
+            PathNode node(best_node.tile_x + adjacent_x[i], best_node.tile_y + adjacent_y[i]);
+
+            // Nodes outside of the collision grid are always walls.
+            if(node.tile_x < 0 || node.tile_y < 0 ||
+                    node.tile_x >= _num_grid_x_axis || node.tile_y >= _num_grid_y_axis)
+                continue;
+
+            // Nodes outside of the clusters crossed by the abstract path are ignored.
+            if(corridor && !_corridor[_abstract_graph->GetCluster(node.tile_x, node.tile_y)])
+                continue;
+
+            // ---------- (A): Check if all tiles are walkable
+            // Don't use 0.0f here for both since errors at the border between
+            // two positions may occure, especially when running.
+            COLLISION_TYPE collision_type = collision_detector.DetectCollision(((float)node.tile_x) + offset_x,
+                                                                               ((float)node.tile_y) + offset_y);
+
+            // Can't go through walls.
+            if(collision_type == WALL_COLLISION)
+                continue;
+
+            // ---------- (B): If this point has been reached, the node is valid for the sprite to move to
+            // If this is a lateral adjacent node, g_score is +10, otherwise diagonal adjacent node is +14
+            if(i < 4)
+                g_add = basic_gcost;
+            else
+                g_add = basic_gcost + 4;
+
+            // Add some g cost when there is another sprite there,
+            // so the NPC try to get around when possible,
+            // but will still go through it when there are no other choices.
+            if(collision_type == CHARACTER_COLLISION
+                    || collision_type == ENEMY_COLLISION)
+                g_add += basic_gcost * 2;
+
+            // If the path has reached the maximum length requested, we abort the path
+            if (max_cost > 0 && (uint32)(best_node.g_score + g_add) >= max_cost * basic_gcost)
+                return false;
+
+            // ---------- (C): Check if the node is already in the closed list
+            uint32 index = _GetNodeIndex(node.tile_x, node.tile_y);
+            if(_IsNodeBitSet(_closed_nodes, index))
+                continue;
+
+            // Set the node's parent and calculate its g_score
+            node.parent_x = best_node.tile_x;
+            node.parent_y = best_node.tile_y;
+            node.g_score = best_node.g_score + g_add;
+
+            // Calculate the H and F score of the node (the heuristic used is diagonal)
+            x_delta = abs(dest.tile_x - node.tile_x);
+            y_delta = abs(dest.tile_y - node.tile_y);
+            if(x_delta > y_delta)
+                node.h_score = 14 * y_delta + 10 * (x_delta - y_delta);
+            else
+                node.h_score = 14 * x_delta + 10 * (y_delta - x_delta);
+            node.f_score = node.g_score + node.h_score;
+
+            // ---------- (D): Check to see if the node is already on the open list and update it if necessary
+            if(_IsNodeBitSet(_opened_nodes, index)) {
+                // If its G is higher, it means that the path we are on is better, so switch the parent
+                if(_g_scores[index] <= node.g_score)
+                    continue;
+                node.opening_order = _opening_orders[index];
+            }
+            // ---------- (E): Add the new node to the open list
+            else {
+                _SetNodeBit(_opened_nodes, index);
+                node.opening_order = ++opening_order;
+                _opening_orders[index] = node.opening_order;
+            }
+
+            _g_scores[index] = node.g_score;
+            _parents[index] = best_index;
+            _open_list.push_back(node);
+            std::push_heap(_open_list.begin(), _open_list.end());
+        } // for (uint8 i = 0; i < 8; ++i)
+    } // while (_open_list.empty() == false)
+
+    if(!dest_reached)
+        return false;
+
+    // Add the destination node to the vector.
+    path.push_back(destination);
+
+    // Go backwards from the destination parent following the parent nodes to construct the path
+    for(uint32 index = _parents[best_index]; index != source_index; index = _parents[index]) {
+        MapPosition next_pos(((float)(index % _num_grid_x_axis)) + offset_x,
+                             ((float)(index / _num_grid_x_axis)) + offset_y);
+        path.push_back(next_pos);
+    }
+    std::reverse(path.begin(), path.end());
+
+    return true;
+} // bool PathFinder::_SearchPath(...)
+
+// ----------------------------------------------------------------------------
+// ---------- PathFlowField Class Functions
+// ----------------------------------------------------------------------------
+
+//! \brief The number of grid elements the flow field area extends past the screen size.
+static const int16 FLOW_FIELD_MARGIN = 8;
+
+PathFlowField::PathFlowField() :
+    _num_grid_x_axis(0),
+    _num_grid_y_axis(0),
+    _root_x(-1),
+    _root_y(-1),
+    _left(0),
+    _top(0),
+    _right(-1),
+    _bottom(-1)
+{}
+
+void PathFlowField::Initialize(const CollisionGrid& collision_grid)
+{
+    _num_grid_x_axis = collision_grid.GetNumGridXAxis();
+    _num_grid_y_axis = collision_grid.GetNumGridYAxis();
+    _root_x = -1;
+    _root_y = -1;
+    _costs.clear();
+
+    // The grid elements next to a wall cost twice as much to walk on.
+    _node_costs.assign(_num_grid_x_axis * _num_grid_y_axis, 0);
+    for(int16 y = 0; y < _num_grid_y_axis; ++y) {
+        for(int16 x = 0; x < _num_grid_x_axis; ++x) {
+            if(collision_grid.IsWall(x, y))
+                continue;
+
+            uint8 cost = 1;
+            for(int16 j = y - 1; j <= y + 1 && cost == 1; ++j) {
+                for(int16 i = x - 1; i <= x + 1; ++i) {
+                    if(i < 0 || j < 0 || i >= _num_grid_x_axis || j >= _num_grid_y_axis ||
+                            collision_grid.IsWall(i, j)) {
+                        cost = 2;
+                        break;
+                    }
+                }
+            }
+            _node_costs[y * _num_grid_x_axis + x] = cost;
+        }
+    }
+}
+
+void PathFlowField::Update(int16 root_x, int16 root_y)
+{
+    // The coordinates offsets of the eight adjacent grid elements: lateral ones first, then diagonal ones.
+    static const int16 adjacent_x[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static const int16 adjacent_y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+    _root_x = root_x;
+    _root_y = root_y;
+
+    // The enemies are only updated when on screen, so the field doesn't need to cover more.
+    _left = std::max<int16>(0, root_x - static_cast<int16>(SCREEN_GRID_X_LENGTH) - FLOW_FIELD_MARGIN);
+    _top = std::max<int16>(0, root_y - static_cast<int16>(SCREEN_GRID_Y_LENGTH) - FLOW_FIELD_MARGIN);
+    _right = std::min<int16>(_num_grid_x_axis - 1, root_x + static_cast<int16>(SCREEN_GRID_X_LENGTH) + FLOW_FIELD_MARGIN);
+    _bottom = std::min<int16>(_num_grid_y_axis - 1, root_y + static_cast<int16>(SCREEN_GRID_Y_LENGTH) + FLOW_FIELD_MARGIN);
+
+    if(_left > _right || _top > _bottom) {
+        _costs.clear();
+        return;
+    }
+
+    uint32 width = _right - _left + 1;
+    _costs.assign(width * (_bottom - _top + 1), PATH_NO_COST);
+
+    if(root_x < _left || root_x > _right || root_y < _top || root_y > _bottom)
+        return;
+
+    AbstractOpenList open_list;
+    uint32 root_index = (root_y - _top) * width + (root_x - _left);
+    _costs[root_index] = 0;
+    open_list.push(AbstractOpenEntry(0, root_index));
+
+    while(!open_list.empty()) {
+        AbstractOpenEntry best = open_list.top();
+        open_list.pop();
+        if(best.first != _costs[best.second])
+            continue;
+
+        int16 best_x = _left + best.second % width;
+        int16 best_y = _top + best.second / width;
+
+        // The costs are the ones to walk from each adjacent grid element to this one.
+        for(uint8 i = 0; i < 8; ++i) {
+            int16 node_x = best_x + adjacent_x[i];
+            int16 node_y = best_y + adjacent_y[i];
+            if(node_x < _left || node_x > _right || node_y < _top || node_y > _bottom)
+                continue;
+            if(_node_costs[node_y * _num_grid_x_axis + node_x] == 0 ||
+                    !_IsWalkable(node_x, node_y, -adjacent_x[i], -adjacent_y[i]))
+                continue;
+
+            uint32 cost = best.first + _node_costs[best_y * _num_grid_x_axis + best_x] *
+                          (i < 4 ? PATH_LATERAL_COST : PATH_DIAGONAL_COST);
+            uint32 index = (node_y - _top) * width + (node_x - _left);
+            if(cost >= _costs[index])
+                continue;
+
+            _costs[index] = cost;
+            open_list.push(AbstractOpenEntry(cost, index));
+        }
+    }
+}
+
+bool PathFlowField::GetNextNode(int16 x, int16 y, int16& next_x, int16& next_y) const
+{
+    // The coordinates offsets of the eight adjacent grid elements: lateral ones first, then diagonal ones.
+    static const int16 adjacent_x[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static const int16 adjacent_y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+    uint32 best_cost = _GetCost(x, y);
+    if(best_cost == 0 || best_cost == PATH_NO_COST)
+        return false;
+
+    bool found = false;
+    for(uint8 i = 0; i < 8; ++i) {
+        if(!_IsWalkable(x, y, adjacent_x[i], adjacent_y[i]))
+            continue;
+
+        uint32 cost = _GetCost(x + adjacent_x[i], y + adjacent_y[i]);
+        if(cost >= best_cost)
+            continue;
+
+        best_cost = cost;
+        next_x = x + adjacent_x[i];
+        next_y = y + adjacent_y[i];
+        found = true;
+    }
+    return found;
+}
+
+uint32 PathFlowField::_GetCost(int16 x, int16 y) const
+{
+    if(_costs.empty() || x < _left || x > _right || y < _top || y > _bottom)
+        return PATH_NO_COST;
+    return _costs[(y - _top) * (_right - _left + 1) + (x - _left)];
+}
+
+bool PathFlowField::_IsWalkable(int16 x, int16 y, int16 offset_x, int16 offset_y) const
+{
+    int16 node_x = x + offset_x;
+    int16 node_y = y + offset_y;
+    if(node_x < 0 || node_y < 0 || node_x >= _num_grid_x_axis || node_y >= _num_grid_y_axis)
+        return false;
+    if(_node_costs[node_y * _num_grid_x_axis + node_x] == 0)
+        return false;
+
+    // Don't cut the wall corners when moving diagonally.
+    if(offset_x != 0 && offset_y != 0) {
+        if(_node_costs[y * _num_grid_x_axis + node_x] == 0 || _node_costs[node_y * _num_grid_x_axis + x] == 0)
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// ---------- PathFindingService Class Functions
+// ----------------------------------------------------------------------------
+
+/** \brief Detects the collisions of a path finding snapshot for a given collision rectangle.
+*** This mimics ObjectSupervisor::DetectCollision() with the snapshot walls and sprites.
+**/
+class SnapshotCollisionDetector : public PathCollisionDetector
+{
+public:
+    SnapshotCollisionDetector(const PathSnapshot& snapshot, uint16 num_grid_x_axis, uint16 num_grid_y_axis,
+                              float coll_half_width, float coll_height, uint32 collision_mask, int16 object_id) :
+        _walls(snapshot.walls),
+        _sprites(snapshot.sprites),
+        _num_grid_x_axis(num_grid_x_axis),
+        _num_grid_y_axis(num_grid_y_axis),
+        _coll_half_width(coll_half_width),
+        _coll_height(coll_height),
+        _collision_mask(collision_mask),
+        _object_id(object_id)
+    {}
+
+    COLLISION_TYPE DetectCollision(float x, float y) {
+        MapRectangle rect(x - _coll_half_width, x + _coll_half_width, y - _coll_height, y);
+
+        // Check if any part of the collision rectangle is outside of the map boundary
+        if(rect.left < 0.0f || rect.right >= static_cast<float>(_num_grid_x_axis) ||
+                rect.top < 0.0f || rect.bottom >= static_cast<float>(_num_grid_y_axis))
+            return WALL_COLLISION;
+
+        if(_collision_mask == NO_COLLISION)
+            return NO_COLLISION;
+
+        if(_collision_mask & WALL_COLLISION) {
+            for(uint32 y = static_cast<uint32>(rect.top); y <= static_cast<uint32>(rect.bottom); ++y) {
+                for(uint32 x = static_cast<uint32>(rect.left); x <= static_cast<uint32>(rect.right); ++x) {
+                    if(_walls[y * _num_grid_x_axis + x])
+                        return WALL_COLLISION;
+                }
+            }
+        }
+
+        for(uint32 i = 0; i < _sprites.size(); ++i) {
+            const PathSnapshot::Sprite &sprite = _sprites[i];
+            if(sprite.object_id == _object_id || !(_collision_mask & sprite.collision))
+                continue;
+            if(MapRectangle::CheckIntersection(rect, sprite.rect))
+                return sprite.collision;
+        }
+        return NO_COLLISION;
+    }
+
+    bool IsStoppedByWalls() const {
+        return (_collision_mask & WALL_COLLISION);
+    }
+
+private:
+    const std::vector<uint8>& _walls;
+    const std::vector<PathSnapshot::Sprite>& _sprites;
+    uint16 _num_grid_x_axis, _num_grid_y_axis;
+    float _coll_half_width, _coll_height;
+    uint32 _collision_mask;
+    int16 _object_id;
+}; // class SnapshotCollisionDetector
+
+PathFindingService::PathFindingService() :
+    _num_grid_x_axis(0),
+    _num_grid_y_axis(0),
+    _snapshot_published(false),
+    _snapshot_needed(false),
+    _last_request_id(0),
+    _thread(NULL),
+    _lock(NULL),
+    _requests_available(NULL),
+    _exit_thread(false)
+{}
+
+PathFindingService::~PathFindingService()
+{
+    if(_thread) {
+        SystemManager->LockThread(_lock);
+        _exit_thread = true;
+        SystemManager->UnlockThread(_lock);
+        // Wake the worker thread up so that it sees it has to exit.
+        SystemManager->UnlockThread(_requests_available);
+        SystemManager->WaitForThread(_thread);
+    }
+
+    if(_lock)
+        SystemManager->DestroySemaphore(_lock);
+    if(_requests_available)
+        SystemManager->DestroySemaphore(_requests_available);
+
+    // Delete the requests never retrieved.
+    for(std::map<uint32, PathRequest *>::iterator it = _requests.begin(); it != _requests.end(); ++it)
+        delete it->second;
+}
+
+void PathFindingService::Initialize(const CollisionGrid& collision_grid, const PathAbstractGraph *abstract_graph)
+{
+    if(_thread) {
+        PRINT_WARNING << "The path finding service was already initialized." << std::endl;
+        return;
+    }
+
+    _num_grid_x_axis = collision_grid.GetNumGridXAxis();
+    _num_grid_y_axis = collision_grid.GetNumGridYAxis();
+
+    _grid_walls.assign(_num_grid_x_axis * _num_grid_y_axis, 0);
+    for(uint32 y = 0; y < _num_grid_y_axis; ++y) {
+        for(uint32 x = 0; x < _num_grid_x_axis; ++x)
+            _grid_walls[y * _num_grid_x_axis + x] = collision_grid.IsWall(x, y) ? 1 : 0;
+    }
+    _path_finder.Initialize(_num_grid_x_axis, _num_grid_y_axis, abstract_graph);
+
+#if (THREAD_TYPE == SDL_THREADS)
+    _lock = SystemManager->CreateSemaphore(1);
+    _requests_available = SystemManager->CreateSemaphore(0);
+    if(_lock && _requests_available)
+        _thread = SDL_CreateThread(_WorkerThread, this);
+
+    // The requests will then be computed synchronously.
+    if(!_thread)
+        PRINT_WARNING << "Unable to create the path finding thread: " << SDL_GetError() << std::endl;
+#endif
+}
+
+void PathFindingService::StartSnapshot()
+{
+    _next_snapshot.walls = _grid_walls;
+    _next_snapshot.sprites.clear();
+}
+
+void PathFindingService::AddSnapshotWall(const MapRectangle& rect)
+{
+    if(_next_snapshot.walls.empty())
+        return;
+
+    // Only keep the part of the rectangle inside of the map.
+    if(rect.right < 0.0f || rect.bottom < 0.0f)
+        return;
+    uint32 left = static_cast<uint32>(std::max(0.0f, rect.left));
+    uint32 right = std::min(static_cast<uint32>(rect.right), static_cast<uint32>(_num_grid_x_axis - 1));
+    uint32 top = static_cast<uint32>(std::max(0.0f, rect.top));
+    uint32 bottom = std::min(static_cast<uint32>(rect.bottom), static_cast<uint32>(_num_grid_y_axis - 1));
+
+    for(uint32 y = top; y <= bottom; ++y) {
+        for(uint32 x = left; x <= right; ++x)
+            _next_snapshot.walls[y * _num_grid_x_axis + x] = 1;
+    }
+}
+
+void PathFindingService::AddSnapshotSprite(const MapRectangle& rect, COLLISION_TYPE collision, int16 object_id)
+{
+    PathSnapshot::Sprite sprite;
+    sprite.rect = rect;
+    sprite.collision = collision;
+    sprite.object_id = object_id;
+    _next_snapshot.sprites.push_back(sprite);
+}
+
+void PathFindingService::PublishSnapshot()
+{
+    _snapshot_needed = false;
+
+    if(!_thread) {
+        _worker_snapshot.Swap(_next_snapshot);
+        _pending_requests.insert(_pending_requests.end(), _new_requests.begin(), _new_requests.end());
+        _new_requests.clear();
+        _ComputePendingRequests();
+        return;
+    }
+
+    SystemManager->LockThread(_lock);
+    _published_snapshot.Swap(_next_snapshot);
+    _snapshot_published = true;
+    _pending_requests.insert(_pending_requests.end(), _new_requests.begin(), _new_requests.end());
+    SystemManager->UnlockThread(_lock);
+
+    // Wake the worker thread up once per new request.
+    for(uint32 i = 0; i < _new_requests.size(); ++i)
+        SystemManager->UnlockThread(_requests_available);
+    _new_requests.clear();
+}
+
+uint32 PathFindingService::RequestPath(float source_x, float source_y, const MapPosition& destination, uint32 max_cost,
+                                       float coll_half_width, float coll_height, uint32 collision_mask, int16 object_id)
+{
+    if(_grid_walls.empty()) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "The path finding service isn't initialized" << std::endl;
+        return 0;
+    }
+
+    PathRequest *request = new PathRequest();
+    request->source_x = source_x;
+    request->source_y = source_y;
+    request->destination = destination;
+    request->max_cost = max_cost;
+    request->coll_half_width = coll_half_width;
+    request->coll_height = coll_height;
+    request->collision_mask = collision_mask;
+    request->object_id = object_id;
+    request->processing = false;
+    request->finished = false;
+    request->cancelled = false;
+
+    // Never give the 0 id, used for invalid requests.
+    if(++_last_request_id == 0)
+        ++_last_request_id;
+
+    if(_thread)
+        SystemManager->LockThread(_lock);
+    _requests[_last_request_id] = request;
+    if(_thread)
+        SystemManager->UnlockThread(_lock);
+
+    _new_requests.push_back(_last_request_id);
+    _snapshot_needed = true;
+    return _last_request_id;
+}
+
+bool PathFindingService::RetrievePath(uint32 request_id, Path& path)
+{
+    bool retrieved = false;
+
+    if(_thread)
+        SystemManager->LockThread(_lock);
+
+    std::string messages;
+    std::map<uint32, PathRequest *>::iterator it = _requests.find(request_id);
+    if(it == _requests.end()) {
+        messages = "Unknown path request\n";
+        path.clear();
+        retrieved = true;
+    }
+    else if(it->second->finished) {
+        path.swap(it->second->path);
+        messages.swap(it->second->messages);
+        delete it->second;
+        _requests.erase(it);
+        retrieved = true;
+    }
+
+    if(_thread)
+        SystemManager->UnlockThread(_lock);
+
+    // The messages of the worker thread are printed here, by the main thread.
+    if(!messages.empty())
+        IF_PRINT_WARNING(MAP_DEBUG) << "Path request " << request_id << ": " << messages;
+
+    return retrieved;
+}
+
+void PathFindingService::CancelRequest(uint32 request_id)
+{
+    if(_thread)
+        SystemManager->LockThread(_lock);
+
+    std::map<uint32, PathRequest *>::iterator it = _requests.find(request_id);
+    if(it != _requests.end()) {
+        // The worker thread deletes the request it is computing once done.
+        if(it->second->processing)
+            it->second->cancelled = true;
+        else
+            delete it->second;
+        _requests.erase(it);
+    }
+
+    if(_thread)
+        SystemManager->UnlockThread(_lock);
+}
+
+int PathFindingService::_WorkerThread(void *service_ptr)
+{
+    PathFindingService *service = static_cast<PathFindingService *>(service_ptr);
+
+    while(true) {
+        SystemManager->LockThread(service->_requests_available);
+
+        SystemManager->LockThread(service->_lock);
+        if(service->_exit_thread) {
+            SystemManager->UnlockThread(service->_lock);
+            break;
+        }
+
+        // Take the latest snapshot, published along with the pending requests.
+        if(service->_snapshot_published) {
+            service->_worker_snapshot.Swap(service->_published_snapshot);
+            service->_snapshot_published = false;
+        }
+
+        PathRequest *request = NULL;
+        if(!service->_pending_requests.empty()) {
+            std::map<uint32, PathRequest *>::iterator it = service->_requests.find(service->_pending_requests.front());
+            service->_pending_requests.pop_front();
+            // Cancelled requests are already removed.
+            if(it != service->_requests.end()) {
+                request = it->second;
+                request->processing = true;
+            }
+        }
+        SystemManager->UnlockThread(service->_lock);
+
+        if(!request)
+            continue;
+
+        // The request parameters don't change once submitted, and the worker snapshot
+        // is only accessed by this thread, so the search can be done unlocked.
+        service->_ComputeRequest(request);
+
+        SystemManager->LockThread(service->_lock);
+        request->processing = false;
+        if(request->cancelled)
+            delete request;
+        else
+            request->finished = true;
+        SystemManager->UnlockThread(service->_lock);
+    }
+
+    return 0;
+}
+
+void PathFindingService::_ComputeRequest(PathRequest *request)
+{
+    SnapshotCollisionDetector collision_detector(_worker_snapshot, _num_grid_x_axis, _num_grid_y_axis,
+                                                 request->coll_half_width, request->coll_height,
+                                                 request->collision_mask, request->object_id);
+
+    // Return when the destination is unreachable
+    if(collision_detector.DetectCollision(request->destination.x, request->destination.y) == WALL_COLLISION)
+        return;
+
+    PathNode source_node(static_cast<int16>(request->source_x), static_cast<int16>(request->source_y));
+    request->path = _path_finder.FindPath(source_node, request->destination, request->max_cost, collision_detector);
+    request->messages = _path_finder.TakeMessages();
+}
+
+void PathFindingService::_ComputePendingRequests()
+{
+    while(!_pending_requests.empty()) {
+        std::map<uint32, PathRequest *>::iterator it = _requests.find(_pending_requests.front());
+        _pending_requests.pop_front();
+        if(it == _requests.end())
+            continue;
+
+        _ComputeRequest(it->second);
+        it->second->finished = true;
+    }
+}
+
+} // namespace private_map
+
+} // namespace vt_map
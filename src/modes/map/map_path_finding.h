@@ -0,0 +1,579 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2004-2011 by The Allacrost Project
+//            Copyright (C) 2012-2014 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_finding.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for map mode path finding.
+***
+*** This file contains the A* path finding algorithm used by map sprites, the
+*** abstract graph used to speed up long distance searches, the flow field
+*** shared by the sprites chasing the camera, along with the service computing
+*** paths asynchronously in a worker thread.
+*** *****************************************************************************/
+
+#ifndef __MAP_PATH_FINDING_HEADER__
+#define __MAP_PATH_FINDING_HEADER__
+
+#include "modes/map/map_utils.h"
+
+#include <deque>
+#include <map>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+/** ****************************************************************************
+*** \brief Abstract class telling the path finder what collides at a given node.
+***
+*** The path finder doesn't know about the map content: it only asks through
+*** this interface what the searching sprite would collide with at a position.
+*** ***************************************************************************/
+class PathCollisionDetector
+{
+public:
+    virtual ~PathCollisionDetector()
+    {}
+
+    /** \brief Tells the collision type of the searching sprite at the given position
+    *** \return The type of collision detected, which may include NO_COLLISION.
+    *** Walls are never crossed, while character and enemy collisions make the node costlier.
+    **/
+    virtual COLLISION_TYPE DetectCollision(float x, float y) = 0;
+
+    /** \brief Tells whether the searching sprite is stopped by the collision grid walls.
+    *** The abstract graph only knows about those walls, and is ignored otherwise.
+    **/
+    virtual bool IsStoppedByWalls() const = 0;
+}; // class PathCollisionDetector
+
+
+/** ****************************************************************************
+*** \brief The cluster entrances graph used for hierarchical path finding (HPA*).
+***
+*** The collision grid is cut into square clusters of PATH_CLUSTER_LENGTH
+*** elements. Along each border between two clusters, the walkable spans give
+*** the entrances, whose grid elements on both sides are the abstract nodes.
+*** The nodes of a cluster are linked with their walking cost inside of it.
+***
+*** The graph is built once when the map is loaded and only knows about the
+*** collision grid walls. It considers the collision rectangle of the common
+*** characters, so its paths are a hint rather than a proof: long distance
+*** searches are done on it first, and the path finder then only searches the
+*** clusters crossed by the abstract path with the actual sprite collisions.
+***
+*** The walkable areas of the grid are labelled as well, which tells at once
+*** whether a destination can be reached at all.
+***
+*** \note Once initialized, the graph is only read and can be shared by
+*** the path finders of several threads.
+*** ***************************************************************************/
+class PathAbstractGraph
+{
+public:
+    PathAbstractGraph();
+
+    //! \brief Builds the graph from the map collision grid.
+    void Initialize(const CollisionGrid& collision_grid);
+
+    /** \brief Tells whether the destination grid element may be reached from the source one.
+    *** This only returns false when the collision grid walls separate them.
+    **/
+    bool IsReachable(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y) const;
+
+    /** \brief Tells whether a search between the two given grid elements should use the graph.
+    *** This is the case when their clusters are neither the same nor adjacent ones.
+    **/
+    bool IsLongDistance(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y) const;
+
+    /** \brief Finds the abstract nodes to walk through from the source to the destination
+    *** \param waypoints Receives the grid elements of the abstract nodes, in walking order.
+    *** The source and the destination aren't part of them.
+    *** \return false if no abstract path was found.
+    **/
+    bool FindAbstractPath(int16 source_x, int16 source_y, int16 dest_x, int16 dest_y,
+                          std::vector<PathNode>& waypoints) const;
+
+    //! \brief Returns the number of clusters.
+    uint32 GetNumClusters() const {
+        return _cluster_nodes.size();
+    }
+
+    //! \brief Returns the index of the cluster containing the given grid element.
+    uint32 GetCluster(int16 x, int16 y) const {
+        return (y / PATH_CLUSTER_LENGTH) * _num_clusters_x + (x / PATH_CLUSTER_LENGTH);
+    }
+
+private:
+    //! \brief A link from an abstract node to another.
+    struct AbstractEdge {
+        AbstractEdge(uint32 node_, uint32 cost_) :
+            node(node_),
+            cost(cost_)
+        {}
+
+        //! \brief The index of the node the edge leads to.
+        uint32 node;
+
+        //! \brief The walking cost, using the path finding g costs.
+        uint32 cost;
+    };
+
+    //! \brief A cluster entrance side.
+    struct AbstractNode {
+        //! \brief The collision grid element of the node.
+        int16 x, y;
+
+        //! \brief The index of the cluster containing the node.
+        uint32 cluster;
+
+        std::vector<AbstractEdge> edges;
+    };
+
+    //! \brief The number of columns and rows of the collision grid.
+    uint16 _num_grid_x_axis, _num_grid_y_axis;
+
+    //! \brief The number of columns and rows of clusters.
+    uint16 _num_clusters_x, _num_clusters_y;
+
+    //! \brief Whether the common character collision rectangle hits a wall at each grid element.
+    std::vector<uint8> _blocked;
+
+    //! \brief The walkable area label of each grid element, or 0 for walls.
+    std::vector<uint32> _components;
+
+    //! \brief All the abstract nodes.
+    std::vector<AbstractNode> _nodes;
+
+    //! \brief The node indices of each cluster, indexed by [cluster_y * _num_clusters_x + cluster_x].
+    std::vector<std::vector<uint32> > _cluster_nodes;
+
+    //! \brief Tells whether the given grid element is blocked or outside of the grid.
+    bool _IsBlocked(int16 x, int16 y) const {
+        if(x < 0 || y < 0 || x >= _num_grid_x_axis || y >= _num_grid_y_axis)
+            return true;
+        return _blocked[y * _num_grid_x_axis + x] != 0;
+    }
+
+    //! \brief Returns the index of a grid element within its cluster.
+    static uint32 _GetClusterIndex(int16 x, int16 y) {
+        return (y % PATH_CLUSTER_LENGTH) * PATH_CLUSTER_LENGTH + (x % PATH_CLUSTER_LENGTH);
+    }
+
+    /** \brief Adds the entrances found along a cluster border.
+    *** \param x, y The first grid element of the border, on the first cluster side.
+    *** \param step_x, step_y The offset to the next grid element of the border.
+    *** \param across_x, across_y The offset to the facing grid element, on the other cluster side.
+    *** \param length The number of grid elements along the border.
+    *** \param cell_nodes The node index of each grid element already used by a node.
+    **/
+    void _AddEntrances(int16 x, int16 y, int16 step_x, int16 step_y, int16 across_x, int16 across_y,
+                       uint16 length, std::map<uint32, uint32>& cell_nodes);
+
+    //! \brief Returns the node of the given grid element, adding it when needed.
+    uint32 _GetNode(int16 x, int16 y, std::map<uint32, uint32>& cell_nodes);
+
+    /** \brief Gets the collision grid elements range of the cluster containing the given grid element.
+    *** The bounds are inclusive.
+    **/
+    void _GetClusterArea(int16 x, int16 y, int16& left, int16& top, int16& right, int16& bottom) const;
+
+    /** \brief Computes the walking costs from a grid element to every element of its cluster.
+    *** \param costs Receives the costs, indexed by _GetClusterIndex(). Unreachable elements are set to 0xFFFFFFFF.
+    *** Only the grid elements that aren't blocked are walked through.
+    **/
+    void _ComputeClusterCosts(int16 x, int16 y, std::vector<uint32>& costs) const;
+}; // class PathAbstractGraph
+
+
+/** ****************************************************************************
+*** \brief Finds paths on the collision grid using the A* algorithm.
+***
+*** The node data is kept in arrays sized to the collision grid and reused by
+*** every search, so that a search doesn't allocate nor scan lists.
+*** Long distance searches go through the abstract graph when there is one,
+*** and fall back to a search on the whole grid if the sprite can't walk
+*** through the clusters crossed by the abstract path.
+*** An instance must only be used by one thread at a time.
+*** ***************************************************************************/
+class PathFinder
+{
+public:
+    PathFinder();
+
+    /** \brief Sizes the node data to the collision grid of the map.
+    *** \param abstract_graph The graph used for long distance searches, or NULL.
+    *** It must outlive the path finder.
+    **/
+    void Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis, const PathAbstractGraph *abstract_graph = NULL);
+
+    /** \brief Finds a path from a source node to a destination
+    *** \param source_node The grid node the search starts from.
+    *** \param destination The destination coordinates. Its fractional part is kept for every path node.
+    *** \param max_cost Tells how far a path node can be computed against the starting path node.
+    *** If this param is equal to 0, there is no limitation.
+    *** \param collision_detector Tells what the searching sprite collides with at each node.
+    *** \return The path nodes, ending with the destination, or an empty path if none could be found.
+    ***
+    *** \note This doesn't always return the same path as the former sorted open list search.
+    *** The path costs are the same, but among several paths of the same cost, the nodes of equal
+    *** f scores are now expanded the most recently opened first, while the former order depended
+    *** on the std::sort implementation. For the same reason, a search whose cost is close to
+    *** max_cost may abort in one search and not in the other, as the abort happens as soon as
+    *** an expanded node has a neighbour beyond max_cost.
+    *** The --benchmark-paths program option compares both searches on the grid of a map.
+    ***
+    *** \note When the abstract graph is used and the sprite can't reach the destination through
+    *** the clusters crossed by the abstract path, e.g. as objects block the way or the destination,
+    *** or when max_cost is reached there, the whole grid is searched again. Such a search costs
+    *** the corridor search on top of the former whole grid one. These fallbacks are counted, and
+    *** logged when MAP_DEBUG is set.
+    **/
+    Path FindPath(const PathNode &source_node, const MapPosition &destination, uint32 max_cost,
+                  PathCollisionDetector &collision_detector);
+
+    //! \brief Returns the number of searches done using the abstract graph since the initialization.
+    uint32 GetNumAbstractSearches() const {
+        return _num_abstract_searches;
+    }
+
+    //! \brief Returns the number of abstract graph searches which fell back to a whole grid search.
+    uint32 GetNumFallbacks() const {
+        return _num_fallbacks;
+    }
+
+    /** \brief Gives the debug messages of the searches done since the last call, and forgets them.
+    *** They are kept rather than printed, as the searches may be done by a worker thread.
+    **/
+    std::string TakeMessages();
+
+private:
+    //! \brief The debug messages not taken yet, only written when MAP_DEBUG is set.
+    std::ostringstream _messages;
+
+    //! \brief The number of columns and rows of the collision grid.
+    uint16 _num_grid_x_axis, _num_grid_y_axis;
+
+    //! \brief The graph used for long distance searches, or NULL.
+    const PathAbstractGraph *_abstract_graph;
+
+    //! \brief The abstract path nodes of the current search.
+    std::vector<PathNode> _waypoints;
+
+    //! \brief Tells for each cluster of the abstract graph whether it is crossed by the abstract path.
+    std::vector<uint8> _corridor;
+
+    //! \brief The number of searches done using the abstract graph, and of those which fell back to the whole grid.
+    uint32 _num_abstract_searches;
+    uint32 _num_fallbacks;
+
+    /** \name Node Data
+    *** A node is indexed by its collision grid element: [y * _num_grid_x_axis + x].
+    **/
+    //@{
+    //! \brief Bitsets of the nodes closed and opened during the current search.
+    std::vector<uint32> _closed_nodes;
+    std::vector<uint32> _opened_nodes;
+
+    //! \brief The best known cost from the source to each opened node.
+    std::vector<int16> _g_scores;
+
+    //! \brief The index of the node each opened node is best reached from.
+    std::vector<uint32> _parents;
+
+    //! \brief The order in which each node was first opened.
+    std::vector<uint32> _opening_orders;
+
+    //! \brief The open list, kept as a binary heap.
+    std::vector<PathNode> _open_list;
+    //@}
+
+    //! \brief Sets the clusters crossed by the abstract path found from the source to the destination in _corridor.
+    void _SetCorridor(const PathNode &source_node, const PathNode &dest);
+
+    /** \brief Searches a path between two nodes with the A* algorithm
+    *** \param destination The destination coordinates. Its fractional part is kept for every path node.
+    *** \param max_cost The max path cost in basic node costs, or 0 if no limitations.
+    *** \param corridor Whether the path nodes must be within the clusters set in _corridor.
+    *** \param path Receives the path nodes, ending with the destination.
+    *** \return false if no path could be found.
+    **/
+    bool _SearchPath(const PathNode &source_node, const MapPosition &destination, uint32 max_cost,
+                     bool corridor, PathCollisionDetector &collision_detector, Path &path);
+
+    //! \brief Returns the node data index of the given collision grid element.
+    uint32 _GetNodeIndex(int16 x, int16 y) const
+    { return static_cast<uint32>(y) * _num_grid_x_axis + static_cast<uint32>(x); }
+
+    //! \brief Bitset helpers used for the node states.
+    static bool _IsNodeBitSet(const std::vector<uint32>& bitset, uint32 index)
+    { return (bitset[index >> 5] >> (index & 31)) & 1; }
+
+    static void _SetNodeBit(std::vector<uint32>& bitset, uint32 index)
+    { bitset[index >> 5] |= (1u << (index & 31)); }
+}; // class PathFinder
+
+
+/** ****************************************************************************
+*** \brief The walking costs to a root grid element from all the elements around it.
+***
+*** Instead of searching one path per sprite, a single Dijkstra pass computes
+*** the cost to reach the root from every grid element within a screen-sized
+*** area around it. Any sprite there then only has to walk to its cheapest
+*** adjacent grid element. This is used by the hostile enemies chasing the
+*** camera sprite, and the field is only recomputed when the root changes.
+***
+*** \note The field only knows about the collision grid walls. Diagonal moves
+*** never cut wall corners, and the grid elements next to walls cost more so
+*** that the sprites keep off them.
+*** ***************************************************************************/
+class PathFlowField
+{
+public:
+    PathFlowField();
+
+    //! \brief Reads the walls from the map collision grid.
+    void Initialize(const CollisionGrid& collision_grid);
+
+    //! \brief Tells whether the field was computed for the given root grid element.
+    bool IsRootedAt(int16 root_x, int16 root_y) const {
+        return _root_x == root_x && _root_y == root_y;
+    }
+
+    //! \brief Computes the walking costs to the given root grid element.
+    void Update(int16 root_x, int16 root_y);
+
+    /** \brief Gets the adjacent grid element to walk to in order to reach the root
+    *** \return false if the grid element given is the root, is outside of the field area,
+    *** or if the root can't be reached from it.
+    **/
+    bool GetNextNode(int16 x, int16 y, int16& next_x, int16& next_y) const;
+
+private:
+    //! \brief The number of columns and rows of the collision grid.
+    uint16 _num_grid_x_axis, _num_grid_y_axis;
+
+    //! \brief The walking cost of each grid element: 0 for walls, higher next to walls.
+    std::vector<uint8> _node_costs;
+
+    //! \brief The root grid element of the current field, or (-1, -1).
+    int16 _root_x, _root_y;
+
+    //! \brief The grid elements range covered by the current field. The bounds are inclusive.
+    int16 _left, _top, _right, _bottom;
+
+    //! \brief The cost to reach the root from each grid element of the field area.
+    std::vector<uint32> _costs;
+
+    //! \brief Returns the field cost of the given grid element, or 0xFFFFFFFF if it isn't reachable.
+    uint32 _GetCost(int16 x, int16 y) const;
+
+    //! \brief Tells whether the sprite can walk from a grid element to the adjacent one given by the offset.
+    bool _IsWalkable(int16 x, int16 y, int16 offset_x, int16 offset_y) const;
+}; // class PathFlowField
+
+
+/** ****************************************************************************
+*** \brief The map collisions the path finding worker thread searches paths on
+***
+*** It is taken by the main thread on the frames path requests are submitted.
+*** ***************************************************************************/
+struct PathSnapshot {
+    //! \brief The collision grid and static objects walls, one byte per grid element.
+    std::vector<uint8> walls;
+
+    //! \brief A sprite collision rectangle, with the collision type it causes.
+    struct Sprite {
+        MapRectangle rect;
+        COLLISION_TYPE collision;
+        int16 object_id;
+    };
+
+    //! \brief The sprites which may collide with the searching ones.
+    std::vector<Sprite> sprites;
+
+    void Swap(PathSnapshot &other) {
+        walls.swap(other.walls);
+        sprites.swap(other.sprites);
+    }
+}; // struct PathSnapshot
+
+
+/** ****************************************************************************
+*** \brief Computes sprites paths in a worker thread.
+***
+*** Sprites submit a path request and pick up the resulting path on a later
+*** frame, so that many sprites asking for paths at once never stall the map
+*** update. The worker thread never touches the map objects: it searches a
+*** snapshot of the walls (the collision grid and the static objects) and of
+*** the sprites collision rectangles, taken by the main thread on the frames
+*** requests are submitted.
+***
+*** \note The other sprites keep moving while a path is computed. Sprites still
+*** avoid each other when walking the path thanks to the normal collision
+*** handling.
+*** ***************************************************************************/
+class PathFindingService
+{
+public:
+    PathFindingService();
+
+    ~PathFindingService();
+
+    /** \brief Sizes the service to the map collision grid and starts the worker thread.
+    *** \param collision_grid The map collision grid, used to build the wall snapshots.
+    *** \param abstract_graph The graph used for long distance searches, or NULL.
+    *** It must outlive the service.
+    **/
+    void Initialize(const CollisionGrid& collision_grid, const PathAbstractGraph *abstract_graph = NULL);
+
+    /** \brief Marks the collision grid element range given as a wall in the next snapshot.
+    *** This is used by the object supervisor to add the static objects to the snapshot
+    *** before publishing it.
+    **/
+    void AddSnapshotWall(const MapRectangle& rect);
+
+    /** \brief Adds a sprite collision rectangle to the next snapshot.
+    *** \param collision The collision type the sprite causes, depending on its object type.
+    *** \param object_id The sprite object id, so that it is ignored by its own requests.
+    **/
+    void AddSnapshotSprite(const MapRectangle& rect, COLLISION_TYPE collision, int16 object_id);
+
+    /** \brief Submits a path request
+    *** \param source_x, source_y The position the sprite starts from.
+    *** \param destination The destination coordinates.
+    *** \param max_cost Tells how far a path node can be computed against the starting path node.
+    *** If this param is equal to 0, there is no limitation.
+    *** \param coll_half_width, coll_height The collision rectangle of the sprite.
+    *** \param collision_mask The collision mask of the sprite.
+    *** \param object_id The sprite object id.
+    *** \return The request id, used to retrieve the path later, or 0 if the request is invalid.
+    **/
+    uint32 RequestPath(float source_x, float source_y, const MapPosition& destination, uint32 max_cost,
+                       float coll_half_width, float coll_height, uint32 collision_mask, int16 object_id);
+
+    /** \brief Retrieves the result of a finished request
+    *** \param request_id The id returned by RequestPath().
+    *** \param path Receives the found path, or an empty one if no path could be found.
+    *** \return false if the request isn't finished yet. Once retrieved, the request id is no longer valid.
+    **/
+    bool RetrievePath(uint32 request_id, Path& path);
+
+    //! \brief Cancels a request. Its result will be discarded.
+    void CancelRequest(uint32 request_id);
+
+    /** \brief Tells whether a snapshot has to be built before the requests submitted this frame can be served.
+    *** When true, the caller adds the static objects walls and calls PublishSnapshot().
+    **/
+    bool IsSnapshotNeeded() const {
+        return _snapshot_needed;
+    }
+
+    /** \brief Resets the next snapshot to the collision grid walls.
+    *** Called before adding the static objects with AddSnapshotWall(), and the sprites with AddSnapshotSprite().
+    **/
+    void StartSnapshot();
+
+    //! \brief Hands the built snapshot and the requests submitted since the last one over to the worker thread.
+    void PublishSnapshot();
+
+private:
+    //! \brief A path request and its result.
+    struct PathRequest {
+        float source_x, source_y;
+        MapPosition destination;
+        uint32 max_cost;
+        float coll_half_width, coll_height;
+        uint32 collision_mask;
+        int16 object_id;
+
+        //! \brief Set while the worker thread computes the path.
+        bool processing;
+
+        //! \brief Set once the worker thread computed the path.
+        bool finished;
+
+        //! \brief Set when the request was cancelled while being computed.
+        //! The worker thread then deletes it once done.
+        bool cancelled;
+
+        Path path;
+
+        //! \brief The debug messages of the search, printed by the main thread.
+        std::string messages;
+    };
+
+    //! \brief The number of columns and rows of the collision grid.
+    uint16 _num_grid_x_axis, _num_grid_y_axis;
+
+    //! \brief The walls of the map collision grid, one byte per grid element.
+    std::vector<uint8> _grid_walls;
+
+    //! \brief The snapshot being built by the main thread.
+    PathSnapshot _next_snapshot;
+
+    //! \brief The latest snapshot handed to the worker thread, not taken by it yet.
+    PathSnapshot _published_snapshot;
+
+    //! \brief The snapshot searched by the worker thread.
+    PathSnapshot _worker_snapshot;
+
+    //! \brief Whether the published snapshot is newer than the worker one.
+    bool _snapshot_published;
+
+    //! \brief Whether requests were submitted since the last published snapshot.
+    bool _snapshot_needed;
+
+    //! \brief All the requests not retrieved yet, indexed by request id.
+    std::map<uint32, PathRequest *> _requests;
+
+    //! \brief The ids of the requests submitted since the last published snapshot.
+    //! They are handed to the worker thread along with the snapshot.
+    std::vector<uint32> _new_requests;
+
+    //! \brief The ids of the requests waiting for the worker thread.
+    std::deque<uint32> _pending_requests;
+
+    //! \brief The last request id given.
+    uint32 _last_request_id;
+
+    //! \brief The path finder only used by the worker thread.
+    PathFinder _path_finder;
+
+    //! \brief The worker thread, or NULL when threads aren't available.
+    Thread *_thread;
+
+    //! \brief Protects the requests, the published snapshot and the exit flag.
+    Semaphore *_lock;
+
+    //! \brief Counts the requests waiting for the worker thread, and wakes it up.
+    Semaphore *_requests_available;
+
+    //! \brief Tells the worker thread to exit.
+    bool _exit_thread;
+
+    //! \brief The worker thread main loop.
+    static int _WorkerThread(void *service);
+
+    //! \brief Computes the given request path using the worker snapshot.
+    void _ComputeRequest(PathRequest *request);
+
+    //! \brief Computes all the pending requests synchronously. Used when threads are disabled.
+    void _ComputePendingRequests();
+}; // class PathFindingService
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_PATH_FINDING_HEADER__
@@ -407,6 +407,7 @@ void VirtualSprite::_SetNextPosition()
     }
 
     // Make the sprite advance at the end
+    _KeepPreviousPosition();
     SetPosition(next_pos_x, next_pos_y);
     moved_position = true;
 }
@@ -1012,7 +1013,10 @@ void MapSprite::Update()
         } else {
             if (!_infinite_custom_animation)
                 _custom_animation_time -= SystemManager->GetUpdateTime();
-            _current_custom_animation->Update();
+            if(IsVisibleOnScreen())
+                _current_custom_animation->Update();
+            else
+                _current_custom_animation->SkipUpdate();
         }
 
         was_moved = moved_position;
@@ -1073,6 +1077,7 @@ void MapSprite::Update()
     // new animated image to reflect the old, so the walking _animations do not appear to
     // "start and stop" whenever the direction is changed.
     if(last_anim_direction != _current_anim_direction || last_animation != _animation) {
+        last_animation->at(last_anim_direction).UpdateSkippedTime();
         _animation->at(_current_anim_direction).SetTimeProgress(last_animation->at(last_anim_direction).GetTimeProgress());
         last_animation->at(last_anim_direction).ResetAnimation();
     }
@@ -1083,7 +1088,11 @@ void MapSprite::Update()
         elapsed_time = (uint32)(((float)vt_system::SystemManager->GetUpdateTime()) * NORMAL_SPEED / movement_speed);
     }
 
-    _animation->at(_current_anim_direction).Update(elapsed_time);
+    // The off-screen sprites only record the elapsed time, and catch up with it once visible.
+    if(IsVisibleOnScreen())
+        _animation->at(_current_anim_direction).Update(elapsed_time);
+    else
+        _animation->at(_current_anim_direction).SkipUpdate(elapsed_time);
 
     was_moved = moved_position;
 } // void MapSprite::Update()
@@ -1115,7 +1124,7 @@ void MapSprite::_DrawDebugInfo()
 
 void MapSprite::Draw()
 {
-    if(!MapObject::ShouldDraw())
+    if(!MapObject::ShouldDraw(_GetEmoteHeight()))
         return;
 
     if(_custom_animation_on && _current_custom_animation)
@@ -1134,10 +1143,10 @@ void MapSprite::DrawDialog()
     // Update the alpha of the dialogue icon according to it's distance from the player sprite
     const float DIALOGUE_ICON_VISIBLE_RANGE = 10.0f;
 
-    if(!MapObject::ShouldDraw())
+    MapMode *map_mode = MapMode::CurrentInstance();
+    if(!MapObject::ShouldDraw(map_mode->GetDialogueIcon().GetHeight()))
         return;
 
-    MapMode *map_mode = MapMode::CurrentInstance();
     // Don't show a dialogue bubble when not in exploration mode.
     if (map_mode->CurrentState() != STATE_EXPLORE)
         return;
@@ -1297,7 +1306,8 @@ EnemySprite::EnemySprite() :
     _time_to_spawn(STANDARD_ENEMY_FIRST_SPAWN_TIME),
     _time_to_respawn(STANDARD_ENEMY_SPAWN_TIME),
     _is_boss(false),
-    _use_path(false)
+    _use_path(false),
+    _path_request_id(0)
 {
     MapObject::_object_type = ENEMY_TYPE;
     moving = false;
@@ -1322,6 +1332,7 @@ void EnemySprite::Reset()
     _current_node_id = 0;
     _path.clear();
     _use_path = false;
+    _CancelPathRequest();
 
     // Reset the currently selected way point
     _current_way_point_id = 0;
@@ -1413,6 +1424,7 @@ void EnemySprite::_HandleHostileUpdate()
     // Handle chasing the character
     if (player_in_aggro_range && MapMode::CurrentInstance()->AttackAllowed()) {
         // We first cancel the potential previous path.
+        _CancelPathRequest();
         if (!_path.empty()) {
             // We cancel any previous path
             _path.clear();
@@ -1426,7 +1438,14 @@ void EnemySprite::_HandleHostileUpdate()
         if (this->IsCollidingWith(camera))
             _StartEnemyEncounter(this);
 
-        // Make the monster go toward the character
+        // Make the monster go around the walls toward the character,
+        // or straight to it once close enough.
+        MapPosition pursuit_position;
+        if (MapMode::CurrentInstance()->GetObjectSupervisor()->GetCameraPursuitPosition(this, pursuit_position)) {
+            xdelta = GetXPosition() - pursuit_position.x;
+            ydelta = GetYPosition() - pursuit_position.y;
+        }
+
         if(xdelta > -0.5 && xdelta < 0.5 && ydelta < 0)
             SetDirection(SOUTH);
         else if(xdelta > -0.5 && xdelta < 0.5 && ydelta > 0)
@@ -1451,11 +1470,14 @@ void EnemySprite::_HandleHostileUpdate()
     // Handle monsters with way points.
     if (!_way_points.empty()) {
 
+        // Pick up the path to the next way point once it has been computed.
+        _RetrieveRequestedPath();
+
         // Update the wait time until next path between two way points.
         if (!_use_path || !moving)
             _time_elapsed += SystemManager->GetUpdateTime();
 
-        if (_path.empty() && _time_elapsed >= _time_before_new_destination) {
+        if (_path.empty() && !_path_request_id && _time_elapsed >= _time_before_new_destination) {
             if (!_SetPathToNextWayPoint()) {
                 // Fall back to simple movement mode
                 SetRandomDirection();
@@ -1602,6 +1624,7 @@ void EnemySprite::_UpdatePath()
 
 bool EnemySprite::_SetDestination(float destination_x, float destination_y, uint32 max_cost)
 {
+    _CancelPathRequest();
     _path.clear();
     _use_path = false;
 
@@ -1617,11 +1640,33 @@ bool EnemySprite::_SetDestination(float destination_x, float destination_y, uint
     MapPosition dest(destination_x, destination_y);
     // We set the correct mask before finding the path
     collision_mask = WALL_COLLISION | CHARACTER_COLLISION;
-    _path = MapMode::CurrentInstance()->GetObjectSupervisor()->FindPath(this, dest, max_cost);
+    _path_request_id = MapMode::CurrentInstance()->GetObjectSupervisor()->RequestPath(this, dest, max_cost);
 
-    if (_path.empty())
+    if (!_path_request_id)
         return false;
 
+    _destination_x = destination_x;
+    _destination_y = destination_y;
+    return true;
+}
+
+void EnemySprite::_RetrieveRequestedPath()
+{
+    if (!_path_request_id)
+        return;
+
+    // The path is still being computed.
+    if (!MapMode::CurrentInstance()->GetObjectSupervisor()->RetrievePath(_path_request_id, _path))
+        return;
+    _path_request_id = 0;
+
+    if (_path.empty()) {
+        // Fall back to simple movement mode
+        SetRandomDirection();
+        moving = true;
+        return;
+    }
+
     // But remove wall collision afterward to avoid making it stuck in corners.
     // Note: this function is only called when hostile, son we don't deal with
     // the spawning collision mask.
@@ -1630,15 +1675,21 @@ bool EnemySprite::_SetDestination(float destination_x, float destination_y, uint
     _current_node_id = 0;
     _last_node_x_position = GetXPosition();
     _last_node_y_position = GetYPosition();
-    _destination_x = destination_x;
-    _destination_y = destination_y;
 
     _current_node_x = _path[_current_node_id].x;
     _current_node_y = _path[_current_node_id].y;
 
     moving = true;
     _use_path = true;
-    return true;
+}
+
+void EnemySprite::_CancelPathRequest()
+{
+    if (!_path_request_id)
+        return;
+
+    MapMode::CurrentInstance()->GetObjectSupervisor()->CancelPathRequest(_path_request_id);
+    _path_request_id = 0;
 }
 
 void EnemySprite::_SetSpritePathDirection()
@@ -751,6 +751,9 @@ private:
     //! \brief Holds the path needed to traverse from source to destination
     Path _path;
 
+    //! \brief The id of the path request being computed, or 0 if none.
+    uint32 _path_request_id;
+
     //! \brief Way points used by the enemy when not hostile
     std::vector<MapPosition> _way_points;
     uint32 _current_way_point_id;
@@ -761,8 +764,15 @@ private:
     //! \param max_cost More or less the path max length in nodes or 0 if no limitations.
     //! Use this to avoid heavy computations.
     //! \return whether it failed.
+    //! \note The path is computed asynchronously and picked up by _RetrieveRequestedPath().
     bool _SetDestination(float destination_x, float destination_y, uint32 max_cost = 20);
 
+    //! \brief Starts following the requested path once it has been computed.
+    void _RetrieveRequestedPath();
+
+    //! \brief Cancels the path request being computed, if any.
+    void _CancelPathRequest();
+
     //! \brief Set the actual sprite direction according to the current path node.
     void _SetSpritePathDirection();
 
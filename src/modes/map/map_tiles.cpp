@@ -19,8 +19,10 @@
 #include "modes/map/map_tiles.h"
 
 #include "modes/map/map_mode.h"
+#include "modes/map/map_data.h"
 
 #include "engine/video/video.h"
+#include "engine/profiler.h"
 
 using namespace vt_utils;
 using namespace vt_script;
@@ -32,9 +34,39 @@ namespace vt_map
 namespace private_map
 {
 
+void Layer::ComputeTileRuns()
+{
+    _runs.clear();
+
+    uint16 num_tile_on_y_axis = _row_runs.size() - 1;
+    for(uint16 y = 0; y < num_tile_on_y_axis; ++y) {
+        _row_runs[y] = _runs.size();
+
+        const int16 *row = &_tiles[y * _num_tile_on_x_axis];
+        uint16 x = 0;
+        while(x < _num_tile_on_x_axis) {
+            // Skip the empty tiles
+            while(x < _num_tile_on_x_axis && row[x] < 0)
+                ++x;
+            if(x == _num_tile_on_x_axis)
+                break;
+
+            TileRun run;
+            run.start = x;
+            while(x < _num_tile_on_x_axis && row[x] >= 0)
+                ++x;
+            run.end = x;
+            _runs.push_back(run);
+        }
+    }
+    _row_runs[num_tile_on_y_axis] = _runs.size();
+}
+
 TileSupervisor::TileSupervisor() :
     _num_tile_on_x_axis(0),
-    _num_tile_on_y_axis(0)
+    _num_tile_on_y_axis(0),
+    _num_chunks_on_x_axis(0),
+    _num_chunks_on_y_axis(0)
 {}
 
 TileSupervisor::~TileSupervisor()
@@ -44,36 +76,25 @@ TileSupervisor::~TileSupervisor()
     for(uint32 i = 0; i < _tile_images.size(); i++)
         delete(_tile_images[i]);
 
+    _tile_chunks.clear();
     _tile_grid.clear();
     _tile_images.clear();
     _animated_tile_images.clear();
 }
 
-static LAYER_TYPE getLayerType(const std::string &type)
-{
-    if(type == "ground")
-        return GROUND_LAYER;
-    else if(type == "sky")
-        return SKY_LAYER;
-    return INVALID_LAYER;
-}
-
-
-bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
+bool TileSupervisor::Load(MapData &map_data)
 {
-    // Load the map dimensions and do some basic sanity checks
-    _num_tile_on_y_axis = map_file.ReadInt("num_tile_rows");
-    _num_tile_on_x_axis = map_file.ReadInt("num_tile_cols");
+    // Load the map dimensions
+    _num_tile_on_y_axis = map_data.num_tile_on_y_axis;
+    _num_tile_on_x_axis = map_data.num_tile_on_x_axis;
 
     // Load all of the tileset images that are used by this map
 
     // Contains all of the tileset filenames used (string does not contain path information or file extensions)
-    std::vector<std::string> tileset_filenames;
+    const std::vector<std::string> &tileset_filenames = map_data.tileset_filenames;
     // Temporarily retains all tile images loaded for each tileset. Each inner vector contains 256 StillImage objects
     std::vector<std::vector<StillImage> > tileset_images;
 
-    map_file.ReadStringVector("tileset_filenames", tileset_filenames);
-
     for(uint32 i = 0; i < tileset_filenames.size(); i++) {
         std::string tileset_file = tileset_filenames[i];
 
@@ -107,81 +128,13 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
         }
     }
 
-    if(!map_file.DoesTableExist("layers")) {
-        PRINT_ERROR << "No 'layers' table in the map file." << std::endl;
-        return false;
-    }
-
-    // Read in the map tile indeces from all tile layers.
-    // The indeces stored for the map layers in this file directly correspond to a location within a tileset. Tilesets contain a total of 256 tiles
+    // Take the map tile indeces from all tile layers.
+    // The indeces stored for the map layers directly correspond to a location within a tileset. Tilesets contain a total of 256 tiles
     // each, so 0-255 correspond to the first tileset, 256-511 the second, etc. The tile location within the tileset is also determined by the index,
     // where the first 16 indeces in the tileset range are the tiles of the first row (left to right), and so on.
-
-    // Clears out the tiles grid
     _tile_grid.clear();
-
-    std::vector<int32> table_x_indeces; // Used to temporarily store a row of table indeces
-
-    map_file.OpenTable("layers");
-
-    uint32 layers_number = map_file.GetTableSize();
-
-    // layers[0]-[n]
-    for(uint32 layer_id = 0; layer_id < layers_number; ++layer_id) {
-        // Opens the sub-table: layers[layer_id]
-        if(!map_file.DoesTableExist(layer_id))
-            continue;
-
-        map_file.OpenTable(layer_id);
-
-        // Add a layer for the base context
-        _tile_grid.resize(layer_id + 1);
-
-        LAYER_TYPE layer_type = getLayerType(map_file.ReadString("type"));
-
-        if(layer_type == INVALID_LAYER) {
-            PRINT_WARNING << "Ignoring unexisting layer type: " << layer_type
-                          << " in file: " << map_file.GetFilename() << std::endl;
-            map_file.CloseTable(); // layers[i]
-            continue;
-        }
-
-        _tile_grid[layer_id].layer_type = layer_type;
-
-        // Add the new tile rows (y axis)
-        _tile_grid[layer_id].tiles.resize(_num_tile_on_y_axis);
-
-        // Read the tile data
-        for(uint32 y = 0; y < _num_tile_on_y_axis; ++y) {
-            table_x_indeces.clear();
-
-            // Check to make sure tables are of the proper size
-            if(!map_file.DoesTableExist(y)) {
-                PRINT_ERROR << "the layers[" << layer_id << "] table size was not equal to the number of tile rows specified by the map, "
-                            " first missing row: " << y << std::endl;
-                return false;
-            }
-
-            map_file.ReadIntVector(y, table_x_indeces);
-
-            // Check the number of columns
-            if(table_x_indeces.size() != _num_tile_on_x_axis) {
-                PRINT_ERROR << "the layers[" << layer_id << "][" << y << "] table size was not equal to the number of tile columns specified by the map, "
-                            "should have " << _num_tile_on_x_axis << " values." << std::endl;
-                return false;
-            }
-
-            // Prepare the columns (x axis)
-            _tile_grid[layer_id].tiles[y].resize(_num_tile_on_x_axis);
-
-            for(uint32 x = 0; x < _num_tile_on_x_axis; ++x) {
-                _tile_grid[layer_id].tiles[y][x] = table_x_indeces[x];
-            }
-        }
-        map_file.CloseTable(); // layers[layer_id]
-    }
-
-    map_file.CloseTable(); // layers
+    _tile_grid.swap(map_data.layers);
+    uint32 layers_number = _tile_grid.size();
 
     // Determine which tiles in each tileset are referenced in this map
 
@@ -193,11 +146,18 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     // For each layer
     for(uint32 layer_id = 0; layer_id < layers_number; ++layer_id) {
         // For each tile id
-        for(uint32 y = 0; y < _num_tile_on_y_axis; ++y) {
-            for(uint32 x = 0; x < _num_tile_on_x_axis; ++x) {
-                if(_tile_grid[layer_id].tiles[y][x] >= 0)
-                    tile_references[_tile_grid[layer_id].tiles[y][x] ] = 0;
+        std::vector<int16> &tiles = _tile_grid[layer_id].GetTiles();
+        for(uint32 i = 0; i < tiles.size(); ++i) {
+            if(tiles[i] < 0)
+                continue;
+
+            if(static_cast<uint32>(tiles[i]) >= tile_references.size()) {
+                IF_PRINT_WARNING(MAP_DEBUG) << "Ignoring the tile id " << tiles[i] << " of layer " << layer_id
+                                            << ", which isn't part of the map tilesets." << std::endl;
+                tiles[i] = -1;
+                continue;
             }
+            tile_references[tiles[i]] = 0;
         }
     }
 
@@ -221,12 +181,12 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     // For each layer
     for(uint32 layer_id = 0; layer_id < layers_number; ++layer_id) {
         // For each tile id
-        for(uint32 y = 0; y < _num_tile_on_y_axis; ++y) {
-            for(uint32 x = 0; x < _num_tile_on_x_axis; ++x) {
-                if(_tile_grid[layer_id].tiles[y][x] >= 0)
-                    _tile_grid[layer_id].tiles[y][x] = tile_references[_tile_grid[layer_id].tiles[y][x] ];
-            }
+        std::vector<int16> &tiles = _tile_grid[layer_id].GetTiles();
+        for(uint32 i = 0; i < tiles.size(); ++i) {
+            if(tiles[i] >= 0)
+                tiles[i] = tile_references[tiles[i]];
         }
+        _tile_grid[layer_id].ComputeTileRuns();
     }
 
     // Parse all of the tileset definition files and create any animated tile images that will be used
@@ -312,21 +272,75 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     // Remove all tileset images. Any tiles which were not added to _tile_images will no longer exist in memory
     tileset_images.clear();
 
+    _BuildTileChunks();
+
     return true;
-} // bool TileSupervisor::Load(ReadScriptDescriptor& map_file)
+} // bool TileSupervisor::Load(MapData& map_data)
 
 
 
 void TileSupervisor::Update()
 {
     for(uint32 i = 0; i < _animated_tile_images.size(); i++) {
-        _animated_tile_images[i]->Update();
+        _animated_tile_images[i]->SkipUpdate();
     }
 }
 
 
+void TileSupervisor::_BuildTileChunks()
+{
+    _num_chunks_on_x_axis = (_num_tile_on_x_axis + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+    _num_chunks_on_y_axis = (_num_tile_on_y_axis + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+
+    std::set<ImageDescriptor *> animated_images(_animated_tile_images.begin(), _animated_tile_images.end());
+
+    _tile_chunks.clear();
+    _tile_chunks.resize(_tile_grid.size());
+
+    for(uint32 layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        const Layer &layer = _tile_grid[layer_id];
+        if(layer.layer_type == INVALID_LAYER || layer.IsEmpty())
+            continue;
+
+        std::vector<TileChunk> &chunks = _tile_chunks[layer_id];
+        chunks.resize(_num_chunks_on_x_axis * _num_chunks_on_y_axis);
+
+        for(uint16 y = 0; y < _num_tile_on_y_axis; ++y) {
+            for(uint32 run_id = layer.GetRowRunsBegin(y); run_id < layer.GetRowRunsEnd(y); ++run_id) {
+                const TileRun &run = layer.GetTileRun(run_id);
+                for(uint16 x = run.start; x < run.end; ++x) {
+                    int16 tile_id = layer.GetTile(x, y);
+                    if(static_cast<uint32>(tile_id) >= _tile_images.size())
+                        continue;
+
+                    TileChunk &chunk = chunks[(y / TILE_CHUNK_LENGTH) * _num_chunks_on_x_axis + x / TILE_CHUNK_LENGTH];
+
+                    ImageDescriptor *image = _tile_images[tile_id];
+                    bool animated = (animated_images.find(image) != animated_images.end());
+                    if(!animated) {
+                        float chunk_x = static_cast<float>((x % TILE_CHUNK_LENGTH) * 2);
+                        float chunk_y = static_cast<float>((y % TILE_CHUNK_LENGTH) * 2);
+                        if(chunk.still_tiles.AddImage(*static_cast<StillImage *>(image), chunk_x, chunk_y))
+                            continue;
+                    }
+
+                    // Animated tiles, and still ones which couldn't be batched, are drawn separately.
+                    TileChunk::AnimatedTile animated_tile;
+                    animated_tile.x = x;
+                    animated_tile.y = y;
+                    animated_tile.tile_id = tile_id;
+                    animated_tile.animated = animated;
+                    chunk.animated_tiles.push_back(animated_tile);
+                }
+            } // run_id
+        } // y
+    } // layer_id
+}
+
 void TileSupervisor::DrawLayers(const MapFrame *frame, const LAYER_TYPE &layer_type)
 {
+    vt_system::ProfilerMarker marker(vt_system::PROFILE_TILE_DRAW);
+
     // We'll use the top-left positions to render the tiles.
     VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_LEFT, VIDEO_Y_TOP, 0);
 
@@ -334,6 +348,19 @@ void TileSupervisor::DrawLayers(const MapFrame *frame, const LAYER_TYPE &layer_t
     uint32 y_end = static_cast<uint32>(frame->tile_y_start + frame->num_draw_y_axis);
     uint32 x_end = static_cast<uint32>(frame->tile_x_start + frame->num_draw_x_axis);
 
+    // The chunks overlapping the map frame
+    uint32 chunk_x_start = static_cast<uint32>(frame->tile_x_start) / TILE_CHUNK_LENGTH;
+    uint32 chunk_y_start = static_cast<uint32>(frame->tile_y_start) / TILE_CHUNK_LENGTH;
+    uint32 chunk_x_end = std::min<uint32>((x_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH, _num_chunks_on_x_axis);
+    uint32 chunk_y_end = std::min<uint32>((y_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH, _num_chunks_on_y_axis);
+
+    // We substract 0.5 horizontally and 1.0 vertically here
+    // because the video engine will display the map tiles using their
+    // top left coordinates to avoid a position computation flaw when specifying the tile
+    // coordinates from the bottom center point, as the engine does for everything else.
+    float x_origin = frame->tile_x_offset - 1.0f - static_cast<float>(frame->tile_x_start * 2);
+    float y_origin = frame->tile_y_offset - 2.0f - static_cast<float>(frame->tile_y_start * 2);
+
     uint32 layer_number = _tile_grid.size();
     for(uint32 layer_id = 0; layer_id < layer_number; ++layer_id) {
 
@@ -341,22 +368,36 @@ void TileSupervisor::DrawLayers(const MapFrame *frame, const LAYER_TYPE &layer_t
         if(layer.layer_type != layer_type)
             continue;
 
-        // We substract 0.5 horizontally and 1.0 vertically here
-        // because the video engine will display the map tiles using their
-        // top left coordinates to avoid a position computation flaw when specifying the tile
-        // coordinates from the bottom center point, as the engine does for everything else.
-        VideoManager->Move(frame->tile_x_offset - 1.0f, frame->tile_y_offset - 2.0f);
-
-        for(uint32 y = static_cast<uint32>(frame->tile_y_start); y < y_end; ++y) {
-            for(uint32 x = static_cast<uint32>(frame->tile_x_start); x < x_end; ++x) {
-                // Draw a tile image if it exists at this location
-                if(layer.tiles[y][x] >= 0)
-                    _tile_images[ layer.tiles[y][x] ]->Draw();
-
-                VideoManager->MoveRelative(2.0f, 0.0f);
-            } // x
-            VideoManager->MoveRelative(-static_cast<float>(frame->num_draw_x_axis * 2), 2.0f);
-        } // y
+        const std::vector<TileChunk> &chunks = _tile_chunks[layer_id];
+        if(chunks.empty())
+            continue;
+
+        for(uint32 cy = chunk_y_start; cy < chunk_y_end; ++cy) {
+            for(uint32 cx = chunk_x_start; cx < chunk_x_end; ++cx) {
+                const TileChunk &chunk = chunks[cy * _num_chunks_on_x_axis + cx];
+
+                // Draw the still tiles in one go, from the chunk top left corner.
+                if(!chunk.still_tiles.IsEmpty()) {
+                    VideoManager->Move(x_origin + static_cast<float>(cx * TILE_CHUNK_LENGTH * 2),
+                                       y_origin + static_cast<float>(cy * TILE_CHUNK_LENGTH * 2));
+                    chunk.still_tiles.Draw();
+                }
+
+                // Then the visible animated tiles on top of them
+                for(uint32 i = 0; i < chunk.animated_tiles.size(); ++i) {
+                    const TileChunk::AnimatedTile &tile = chunk.animated_tiles[i];
+                    if(tile.x < frame->tile_x_start || tile.x >= x_end
+                            || tile.y < frame->tile_y_start || tile.y >= y_end)
+                        continue;
+
+                    VideoManager->Move(x_origin + static_cast<float>(tile.x * 2),
+                                       y_origin + static_cast<float>(tile.y * 2));
+                    if(tile.animated)
+                        static_cast<AnimatedImage *>(_tile_images[tile.tile_id])->UpdateSkippedTime();
+                    _tile_images[tile.tile_id]->Draw();
+                }
+            } // cx
+        } // cy
     } // layer_id
     // Restore the previous draw flags
     VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
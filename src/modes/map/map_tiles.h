@@ -24,6 +24,7 @@
 #include "modes/map/map_utils.h"
 
 #include "engine/script/script_read.h"
+#include "engine/video/image_batch.h"
 
 namespace vt_video {
 class ImageDescriptor;
@@ -38,6 +39,8 @@ class MapMode;
 namespace private_map
 {
 
+class MapData;
+
 //! \brief Layer types: Drawn before, along, or after the map objects according to their types.
 enum LAYER_TYPE {
     GROUND_LAYER = 0,
@@ -45,16 +48,115 @@ enum LAYER_TYPE {
     INVALID_LAYER = 2
 };
 
+//! \brief A run of consecutive non-empty tiles on a layer row: [start, end[
+struct TileRun {
+    uint16 start;
+    uint16 end;
+};
+
+/** ****************************************************************************
+*** \brief The tile ids of a map layer
+***
+*** The tiles are stored in a single row-major array, an empty location being
+*** represented by a negative id. Once the layer is filled, calling
+*** ComputeTileRuns() stores the non-empty runs of each row so that the empty
+*** locations can be skipped without testing each of them.
+*** ***************************************************************************/
 class Layer
 {
 public:
     LAYER_TYPE layer_type;
-    // Represents the tile indeces: i.e: tiles[y][x] = tile_id at (x,y)
-    std::vector< std::vector<int16> > tiles;
 
     Layer():
-        layer_type(GROUND_LAYER)
+        layer_type(GROUND_LAYER),
+        _num_tile_on_x_axis(0)
     {}
+
+    //! \brief Sizes the layer and makes all of its tiles empty.
+    void Resize(uint16 num_tile_on_x_axis, uint16 num_tile_on_y_axis) {
+        _num_tile_on_x_axis = num_tile_on_x_axis;
+        _tiles.assign(num_tile_on_x_axis * num_tile_on_y_axis, -1);
+        _row_runs.assign(num_tile_on_y_axis + 1, 0);
+        _runs.clear();
+    }
+
+    int16 GetTile(uint16 x, uint16 y) const {
+        return _tiles[y * _num_tile_on_x_axis + x];
+    }
+
+    void SetTile(uint16 x, uint16 y, int16 tile_id) {
+        _tiles[y * _num_tile_on_x_axis + x] = tile_id;
+    }
+
+    //! \brief Gives direct access to the row-major tile ids.
+    std::vector<int16>& GetTiles() {
+        return _tiles;
+    }
+
+    const std::vector<int16>& GetTiles() const {
+        return _tiles;
+    }
+
+    //! \brief Computes the non-empty tile runs of each row. To be called after modifying the tiles.
+    void ComputeTileRuns();
+
+    //! \brief Returns the index of the first run of a row, and the one after its last run.
+    //@{
+    uint32 GetRowRunsBegin(uint16 y) const {
+        return _row_runs[y];
+    }
+
+    uint32 GetRowRunsEnd(uint16 y) const {
+        return _row_runs[y + 1];
+    }
+    //@}
+
+    const TileRun& GetTileRun(uint32 index) const {
+        return _runs[index];
+    }
+
+    //! \brief Tells whether the layer doesn't have any tile.
+    bool IsEmpty() const {
+        return _runs.empty();
+    }
+
+private:
+    uint16 _num_tile_on_x_axis;
+
+    //! \brief The tile ids: _tiles[y * _num_tile_on_x_axis + x] = tile_id at (x,y)
+    std::vector<int16> _tiles;
+
+    //! \brief The non-empty tile runs of all the rows, in row order.
+    std::vector<TileRun> _runs;
+
+    //! \brief The runs of row y are _runs[_row_runs[y]] to _runs[_row_runs[y + 1] - 1].
+    std::vector<uint32> _row_runs;
+};
+
+/** ****************************************************************************
+*** \brief A square block of tiles of a layer, drawn all at once
+***
+*** The still tiles of the chunk are batched when the map is loaded, so that
+*** drawing them only costs one draw call per tileset texture sheet. Animated
+*** tiles change of frame over time and are drawn one by one on top of them.
+*** ***************************************************************************/
+class TileChunk
+{
+public:
+    //! \brief The still tiles, placed relatively to the chunk top left corner.
+    vt_video::ImageBatch still_tiles;
+
+    //! \brief The animated tiles map tile coordinates and ids.
+    struct AnimatedTile {
+        uint16 x;
+        uint16 y;
+        int16 tile_id;
+
+        //! \brief Whether the tile image is an animated image, rather than a still one which couldn't be batched.
+        bool animated;
+    };
+
+    std::vector<AnimatedTile> animated_tiles;
 };
 
 /** ****************************************************************************
@@ -76,13 +178,15 @@ public:
 
     ~TileSupervisor();
 
-    /** \brief Handles all operations on loading tilesets and tile images from the map data file
-    *** \param map_file A reference to the Lua file containing the map data
-    *** \note The map file should already be opened with no Lua tables open
+    /** \brief Handles all operations on loading tilesets and tile images from the map data
+    *** \param map_data The loaded map data. Its tile layers are taken by the supervisor.
     **/
-    bool Load(vt_script::ReadScriptDescriptor &map_file);
+    bool Load(MapData &map_data);
 
-    //! \brief Updates all animated tile images
+    /** \brief Updates all animated tile images
+    *** Only the elapsed time is recorded, the animated tile images catching up with it
+    *** when they are drawn, so that the tile animations off-screen cost nothing.
+    **/
     void Update();
 
     /** \brief Draws the various tile layers to the screen
@@ -121,6 +225,18 @@ private:
     *** _tile_images vector, which contains both still and animated images.
     **/
     std::vector<vt_video::AnimatedImage *> _animated_tile_images;
+
+    //! \brief The number of tile chunks on the x and y axis.
+    uint16 _num_chunks_on_x_axis;
+    uint16 _num_chunks_on_y_axis;
+
+    /** \brief The tile chunks of each layer: _tile_chunks[layer_id][y * _num_chunks_on_x_axis + x].
+    *** A layer without any tile gets no chunks.
+    **/
+    std::vector< std::vector<TileChunk> > _tile_chunks;
+
+    //! \brief Splits the tile layers into chunks and batches their still tiles.
+    void _BuildTileChunks();
 }; // class TileSupervisor
 
 } // namespace private_map
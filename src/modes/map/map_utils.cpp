@@ -37,6 +37,42 @@ bool MapRectangle::CheckIntersection(const MapRectangle &first, const MapRectang
         return true;
 }
 
+void CollisionGrid::Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis)
+{
+    _num_grid_x_axis = num_grid_x_axis;
+    _num_grid_y_axis = num_grid_y_axis;
+    _words_per_row = (num_grid_x_axis + 31) / 32;
+    _words.assign(_words_per_row * num_grid_y_axis, 0);
+}
+
+bool CollisionGrid::IsWallInRectangle(uint32 x_start, uint32 y_start, uint32 x_end, uint32 y_end) const
+{
+    uint32 first_word = x_start >> 5;
+    uint32 last_word = x_end >> 5;
+
+    // The bits of the rectangle columns in its first and last words
+    uint32 first_mask = 0xFFFFFFFFu << (x_start & 31);
+    uint32 last_mask = 0xFFFFFFFFu >> (31 - (x_end & 31));
+    if(first_word == last_word) {
+        first_mask &= last_mask;
+        last_mask = first_mask;
+    }
+
+    for(uint32 y = y_start; y <= y_end; ++y) {
+        const uint32 *row = &_words[y * _words_per_row];
+
+        if(row[first_word] & first_mask)
+            return true;
+        for(uint32 i = first_word + 1; i < last_word; ++i) {
+            if(row[i])
+                return true;
+        }
+        if(row[last_word] & last_mask)
+            return true;
+    }
+    return false;
+}
+
 } // namespace private_map
 
 } // namespace vt_map
@@ -55,6 +55,25 @@ const uint16 GRID_LENGTH = 32; // Length of a grid element in pixels
 const uint16 TILE_LENGTH = GRID_LENGTH * 2; // Length of a tile in pixels
 //@}
 
+//! \brief The length of an object grid cell, in collision grid elements (2x2 tiles).
+//! \see ObjectGrid
+const uint16 OBJECT_GRID_CELL_LENGTH = 4;
+
+//! \brief The length of a path finding cluster, in collision grid elements.
+//! \see PathAbstractGraph
+const uint16 PATH_CLUSTER_LENGTH = 16;
+
+//! \brief The length of a tile chunk drawn at once, in tiles.
+//! \see TileChunk
+const uint16 TILE_CHUNK_LENGTH = 16;
+
+//! \brief The distance to a map transition zone under which the next map is prefetched, in collision grid elements.
+//! \see EventSupervisor
+const float MAP_PREFETCH_DISTANCE = 16.0f;
+
+//! \brief The maximum number of prefetched maps kept in memory.
+const uint32 MAX_PREFETCHED_MAPS = 2;
+
 
 /** \name Map State Enum
 *** \brief Represents the current state of operation during map mode.
@@ -329,12 +348,15 @@ public:
     //! \brief The grid coordinates for the parent of this node
     int16 parent_x, parent_y;
 
+    //! \brief The order in which the node was added to the open list, used to break f_score ties.
+    uint32 opening_order;
+
     // ---------- Methods
 
-    PathNode() : tile_x(-1), tile_y(-1), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0)
+    PathNode() : tile_x(-1), tile_y(-1), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0), opening_order(0)
     {}
 
-    PathNode(int16 x_, int16 y_) : tile_x(x_), tile_y(y_), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0)
+    PathNode(int16 x_, int16 y_) : tile_x(x_), tile_y(y_), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0), opening_order(0)
     {}
 
     //! \brief Overloaded comparison operator, only checks that the tile_x and tile_y members are equal
@@ -347,12 +369,85 @@ public:
         return ((this->tile_x != that.tile_x) || (this->tile_y != that.tile_y));
     }
 
-    //! \brief Overloaded comparison operator only used for path finding, compares the two f_scores
+    /** \brief Overloaded comparison operator only used for path finding, compares the two f_scores
+    *** The comparison is reversed so that the node with the lowest f_score is at the top of
+    *** the open list heap. Among equal f_scores, the most recently opened node comes first.
+    **/
     bool operator<(const PathNode &that) const {
-        return this->f_score > that.f_score;
+        if(this->f_score != that.f_score)
+            return this->f_score > that.f_score;
+        return this->opening_order < that.opening_order;
     }
 }; // class PathNode
 
+/** ****************************************************************************
+*** \brief The walls of the map collision grid, stored as a bitset
+***
+*** Each row of the grid is stored in consecutive 32-bit words, one bit per
+*** grid element, a set bit meaning the element is a wall. This lets a whole
+*** rectangle be tested with a few masked word operations per row.
+*** ***************************************************************************/
+class CollisionGrid
+{
+public:
+    CollisionGrid():
+        _num_grid_x_axis(0),
+        _num_grid_y_axis(0),
+        _words_per_row(0)
+    {}
+
+    /** \brief Sizes the grid, without any wall.
+    *** \param num_grid_x_axis, num_grid_y_axis The collision grid dimensions.
+    **/
+    void Initialize(uint16 num_grid_x_axis, uint16 num_grid_y_axis);
+
+    uint16 GetNumGridXAxis() const {
+        return _num_grid_x_axis;
+    }
+
+    uint16 GetNumGridYAxis() const {
+        return _num_grid_y_axis;
+    }
+
+    //! \brief Tells whether the grid element is a wall. The coordinates must be within the grid.
+    bool IsWall(uint32 x, uint32 y) const {
+        return (_words[y * _words_per_row + (x >> 5)] >> (x & 31)) & 1;
+    }
+
+    //! \brief Sets the grid element as a wall. The coordinates must be within the grid.
+    void SetWall(uint32 x, uint32 y) {
+        _words[y * _words_per_row + (x >> 5)] |= (1u << (x & 31));
+    }
+
+    /** \brief Tells whether any grid element of the rectangle is a wall.
+    *** \param x_start, y_start The rectangle top left grid element.
+    *** \param x_end, y_end The rectangle bottom right grid element, included.
+    *** The rectangle must be within the grid.
+    **/
+    bool IsWallInRectangle(uint32 x_start, uint32 y_start, uint32 x_end, uint32 y_end) const;
+
+    /** \brief Gives the wall bits, so that they can be read or written in bulk.
+    *** Their layout is the one of the _words member, and their count is set by Initialize().
+    **/
+    std::vector<uint32>& GetWords() {
+        return _words;
+    }
+
+    const std::vector<uint32>& GetWords() const {
+        return _words;
+    }
+
+private:
+    uint16 _num_grid_x_axis;
+    uint16 _num_grid_y_axis;
+
+    //! \brief The number of words used by each grid row.
+    uint32 _words_per_row;
+
+    //! \brief The wall bits: the element (x, y) is the bit x % 32 of _words[y * _words_per_row + x / 32].
+    std::vector<uint32> _words;
+}; // class CollisionGrid
+
 struct MapVector {
     MapVector() :
         x(0.0f),
@@ -70,6 +70,30 @@ bool MapZone::IsInsideZone(float pos_x, float pos_y) const
     return false;
 }
 
+float MapZone::GetDistance(float pos_x, float pos_y) const
+{
+    float min_distance = -1.0f;
+    for(std::vector<ZoneSection>::const_iterator it = _sections.begin(); it != _sections.end(); ++it) {
+        // The sections bounds are inclusive, and thus end at the next column and row.
+        float dx = 0.0f;
+        if(pos_x < it->left_col)
+            dx = it->left_col - pos_x;
+        else if(pos_x > it->right_col + 1)
+            dx = pos_x - (it->right_col + 1);
+
+        float dy = 0.0f;
+        if(pos_y < it->top_row)
+            dy = it->top_row - pos_y;
+        else if(pos_y > it->bottom_row + 1)
+            dy = pos_y - (it->bottom_row + 1);
+
+        float distance = sqrtf(dx * dx + dy * dy);
+        if(min_distance < 0.0f || distance < min_distance)
+            min_distance = distance;
+    }
+    return min_distance < 0.0f ? 0.0f : min_distance;
+}
+
 void MapZone::Draw()
 {
     // Verify each section of the zone and check if the position is within the section bounds.
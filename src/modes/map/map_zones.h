@@ -115,6 +115,13 @@ public:
     **/
     bool IsInsideZone(float pos_x, float pos_y) const;
 
+    /** \brief Returns the distance between the position coordinates and the closest zone section
+    *** \param pos_x The x position to check
+    *** \param pos_y The y position to check
+    *** \return The distance in map grid units, or 0.0f when the position is inside the zone.
+    **/
+    float GetDistance(float pos_x, float pos_y) const;
+
     //! \brief Draws the map zone on screen for debugging purpose
     virtual void Draw();
 
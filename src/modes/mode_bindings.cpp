@@ -451,14 +451,19 @@ void BindModeCode()
             .def("StartEvent", (void(EventSupervisor:: *)(const std::string &, uint32))&EventSupervisor::StartEvent)
             .def("StartEvent", (void(EventSupervisor:: *)(MapEvent *))&EventSupervisor::StartEvent)
             .def("StartEvent", (void(EventSupervisor:: *)(MapEvent *, uint32))&EventSupervisor::StartEvent)
+            .def("StartEvent", (void(EventSupervisor:: *)(vt_utils::StringId))&EventSupervisor::StartEvent)
+            .def("StartEvent", (void(EventSupervisor:: *)(vt_utils::StringId, uint32))&EventSupervisor::StartEvent)
             .def("TerminateEvents", (void(EventSupervisor:: *)(const std::string &, bool))&EventSupervisor::TerminateEvents)
             .def("TerminateEvents", (void(EventSupervisor:: *)(MapEvent *, bool))&EventSupervisor::TerminateEvents)
             .def("TerminateAllEvents", &EventSupervisor::TerminateAllEvents)
-            .def("IsEventActive", &EventSupervisor::IsEventActive)
+            .def("IsEventActive", (bool(EventSupervisor:: *)(const std::string &) const)&EventSupervisor::IsEventActive)
+            .def("IsEventActive", (bool(EventSupervisor:: *)(vt_utils::StringId) const)&EventSupervisor::IsEventActive)
             .def("HasActiveEvent", &EventSupervisor::HasActiveEvent)
             .def("HasActiveDelayedEvent", &EventSupervisor::HasActiveDelayedEvent)
-            .def("GetEvent", &EventSupervisor::GetEvent)
+            .def("GetEvent", (MapEvent *(EventSupervisor:: *)(const std::string &) const)&EventSupervisor::GetEvent)
+            .def("GetEvent", (MapEvent *(EventSupervisor:: *)(vt_utils::StringId) const)&EventSupervisor::GetEvent)
             .def("DoesEventExist", &EventSupervisor::DoesEventExist)
+            .def("SetMapTransitionZone", &EventSupervisor::SetMapTransitionZone)
         ];
 
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_map")
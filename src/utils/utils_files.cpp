@@ -37,6 +37,24 @@ bool DoesFileExist(const std::string &file_name)
 #endif
 }
 
+time_t GetFileModificationTime(const std::string &file_name)
+{
+    struct stat buf;
+    if(stat(file_name.c_str(), &buf) == 0)
+        return buf.st_mtime;
+    else
+        return 0;
+}
+
+uint64_t GetFileSize(const std::string &file_name)
+{
+    struct stat buf;
+    if(stat(file_name.c_str(), &buf) == 0)
+        return static_cast<uint64_t>(buf.st_size);
+    else
+        return 0;
+}
+
 bool MoveFile(const std::string &source_name, const std::string &destination_name)
 {
     if(DoesFileExist(destination_name))
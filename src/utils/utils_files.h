@@ -30,6 +30,18 @@ namespace vt_utils
 **/
 bool DoesFileExist(const std::string &file_name);
 
+/** \brief Gets the last modification time of a file
+*** \param file_name The name of the file to check (e.g. "dat/saved_game.lua")
+*** \return The file modification time, or 0 if the file was not found.
+**/
+time_t GetFileModificationTime(const std::string &file_name);
+
+/** \brief Gets the size of a file
+*** \param file_name The name of the file to check (e.g. "dat/saved_game.lua")
+*** \return The file size in bytes, or 0 if the file was not found.
+**/
+uint64_t GetFileSize(const std::string &file_name);
+
 /** \brief Moves a file from one location to another
 *** \param source_name The name of the file that is to be moved
 *** \param destination_name The location name to where the file should be moved to
@@ -89,4 +89,35 @@ bool IsStringNumeric(const std::string &text)
     return true;
 } // bool IsStringNumeric(const string& text)
 
+//! \brief The interned strings handles, and the strings indexed by handle.
+static std::map<std::string, StringId> _string_ids;
+static std::vector<std::string> _interned_strings;
+
+StringId InternString(const std::string &text)
+{
+    std::map<std::string, StringId>::const_iterator it = _string_ids.find(text);
+    if(it != _string_ids.end())
+        return it->second;
+
+    StringId id = static_cast<StringId>(_interned_strings.size());
+    _string_ids.insert(std::make_pair(text, id));
+    _interned_strings.push_back(text);
+    return id;
+}
+
+StringId GetStringId(const std::string &text)
+{
+    std::map<std::string, StringId>::const_iterator it = _string_ids.find(text);
+    if(it == _string_ids.end())
+        return INVALID_STRING_ID;
+    return it->second;
+}
+
+const std::string &GetInternedString(StringId id)
+{
+    if(id >= _interned_strings.size())
+        return _empty_string;
+    return _interned_strings[id];
+}
+
 } // namespace utils
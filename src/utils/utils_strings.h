@@ -84,6 +84,30 @@ inline std::string NumberToString<float>(const float t)
 bool IsStringNumeric(const std::string &text);
 //@}
 
+//! \name String Interning Functions
+//@{
+//! \brief The handle of an interned string
+typedef uint32 StringId;
+
+//! \brief The handle value corresponding to no string
+const StringId INVALID_STRING_ID = 0xFFFFFFFF;
+
+/** \brief Gives the handle of a string, creating it on first use
+*** \param text The string to intern
+*** \return The handle of the string, which is the same for every equal string
+***
+*** The handles are dense integers starting from 0, so they can be used as array indices
+*** and compared much faster than the strings. They remain valid for the whole game execution.
+**/
+StringId InternString(const std::string &text);
+
+//! \brief Returns the handle of an already interned string, or INVALID_STRING_ID.
+StringId GetStringId(const std::string &text);
+
+//! \brief Returns the string corresponding to a handle, or an empty string if the handle is invalid.
+const std::string &GetInternedString(StringId id);
+//@}
+
 } // namespace vt_utils
 
 #endif // __UTILS_STRINGS_HEADER__